@@ -4,6 +4,7 @@
   copyright 2023 noiasca noiasca@yahoo.com
   
   Version
+  2026-10-18        readPin() can be overridden for buttons on expanders
   2023-07-10 0.3.1  initial previousMillis = millis(), time mangement on 16bit
   2022-12-06        added callbacks for onPress and onRelease
   2022-04-09        added getCurrentState and wasReleased
@@ -30,6 +31,16 @@ class Button {                                   // a simple class for buttons b
     void (*cbOnPress)();                         // gets called if button was pressed "rising"
     void (*cbOnRelease)();                       // gets called if button was released "falling"
     
+/**
+    \brief read the electrical state of the button
+    
+    Override this for buttons which are not on a GPIO.
+    @return the pin state HIGH or LOW
+*/
+    virtual int readPin() {
+      return digitalRead(buttonPin);
+    }
+    
   public:
 /**
     \brief constructor for a button
@@ -57,7 +68,7 @@ class Button {                                   // a simple class for buttons b
         pinMode(buttonPin, INPUT_PULLUP);
       else
         pinMode(buttonPin, INPUT);
-      if (digitalRead(buttonPin) == active) lastButtonState = HIGH;  // init variable in case of a permanent/latching switch
+      if (readPin() == active) lastButtonState = HIGH;  // init variable in case of a permanent/latching switch
     }
 
 /**
@@ -72,7 +83,7 @@ class Button {                                   // a simple class for buttons b
 */    
     bool isPressed() {
       bool result = false;
-      if (digitalRead(buttonPin) == active) result = HIGH;
+      if (readPin() == active) result = HIGH;
       return result;
     }    
 
@@ -104,7 +115,7 @@ class Button {                                   // a simple class for buttons b
     bool wasPressed(uint32_t currentMillis = millis()) {
       bool result = false;
       uint8_t reading = LOW;                                         // the current reading from the input pin
-      if (digitalRead(buttonPin) == active) reading = HIGH;          // if we are using INPUT_PULLUP we are checking invers to LOW Pin
+      if (readPin() == active) reading = HIGH;          // if we are using INPUT_PULLUP we are checking invers to LOW Pin
       if (((currentMillis & 0xFFFF ) - lastDebounceTime) > debounceDelay) {      // If the switch changed, AFTER any pressing or noise
         if (reading != lastButtonState && lastButtonState == LOW) {  // if there was a change and last state was LOW
           result = true;
@@ -124,7 +135,7 @@ class Button {                                   // a simple class for buttons b
     bool wasReleased(uint32_t currentMillis = millis()) {
       bool result = false;
       uint8_t reading = HIGH;                                        // the current reading from the input pin
-      if (digitalRead(buttonPin) != active) reading = LOW;
+      if (readPin() != active) reading = LOW;
       if (((currentMillis & 0xFFFF ) - lastDebounceTime) > debounceDelay) {    // If the switch changed, AFTER any pressing or noise
         if (reading != lastButtonState && lastButtonState == HIGH) { // if there was a change and last state was HIGH
           result = true;
@@ -146,7 +157,7 @@ class Button {                                   // a simple class for buttons b
 */    
     void update(uint32_t currentMillis = millis()) {                 // call the run function in loop()
       uint8_t reading = LOW;                                         // "translated" state of button LOW = released, HIGH = pressed, despite the electrical state of the input pint
-      if (digitalRead(buttonPin) == active) reading = HIGH;          // if we are using INPUT_PULLUP we are checking invers to LOW Pin
+      if (readPin() == active) reading = HIGH;          // if we are using INPUT_PULLUP we are checking invers to LOW Pin
       if ((currentMillis & 0xFF) - lastDebounceTime > debounceDelay) {         // If the switch changed, AFTER any pressing or noise
         lastDebounceTime = currentMillis & 0xFF;
         if (reading == LOW && lastButtonState == HIGH) {
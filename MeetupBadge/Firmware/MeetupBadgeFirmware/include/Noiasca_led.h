@@ -11,6 +11,14 @@
   - add effect to other HW classes
   
   Version
+  2026-10-18        Blink: getPhase()/setPhase() carry a running blink over a restart
+  2026-10-18        colorHSV: fixed point HSV to RGB, HueCycle and Rainbow effects
+  2026-10-18        Sequencer: step tables in flash, Alternating, Trafficlight and Turnsignal are Sequencers
+  2026-10-18        Scanner: running light over N LEDs, Bounce5 is a Scanner
+  2026-10-18        Smooth, Heartbeat, Fluorescent: native resolution of the output (12 bit on PCA9685), gamma
+  2026-10-18        Smooth, Heartbeat: hand fades to the hardware if the output supports it
+  2026-10-18        Effect: reconfigure() with phase aligned switch or cross-fade
+  2026-10-18        FastRandom: per effect xorshift generator for Flicker and Fluorescent
   2023-08-04 0.3.1  reduced upate() to one signature @todo: remove finally in 0.4.0
   2023-07-10 0.3.1  initial previousMillis = millis()
   2023-02-18 0.3.0  added HT16K33
@@ -29,6 +37,325 @@
 */
 
 #pragma once
+/*  **************************************************
+    random numbers for effects
+    ************************************************** */ 
+
+class RandomBuffer;
+
+/**
+   \brief a small random generator for effects
+   
+   xorshift32 with a multiply-shift range reduction instead of a division.
+   Each effect owns one, so effects don't share (and disturb) one stream.
+   Every instance starts with a different seed. Use setSeed() to get a
+   reproducible sequence.
+*/
+class FastRandom {
+  protected:
+    uint32_t x;                                  // generator state, never 0
+    RandomBuffer *buffer = nullptr;              // optional pre-generated values
+
+    static uint32_t nextSeed() {
+      static uint32_t seed = 0x6D2B79F5UL;       // Weyl sequence, one step per instance
+      seed += 0x9E3779B9UL;
+      return seed ? seed : 0x9E3779B9UL;
+    }
+
+  public:
+    FastRandom() : x(nextSeed()) {}
+
+/**
+   \brief set the seed
+   
+   \param seed the new seed. 0 is not a valid xorshift state and will be replaced.
+*/
+    void setSeed(uint32_t seed) {
+      x = seed ? seed : 0x9E3779B9UL;
+    }
+    
+/**
+   \brief take values from a pre-generated buffer
+   
+   \param newBuffer the buffer to use, nullptr to generate on each call
+*/
+    void setBuffer(RandomBuffer *newBuffer) {
+      buffer = newBuffer;
+    }
+
+    inline uint32_t next();
+
+/**
+   \brief a random value in [0, howbig)
+*/
+    uint32_t random(uint32_t howbig) {
+      return ((uint64_t)next() * howbig) >> 32;
+    }
+
+/**
+   \brief a random value in [howsmall, howbig)
+*/
+    int32_t random(int32_t howsmall, int32_t howbig) {
+      if (howsmall >= howbig) return howsmall;
+      return howsmall + (int32_t)random((uint32_t)(howbig - howsmall));
+    }
+};
+
+/**
+   \brief a ring of pre-generated random values
+   
+   Draws are taken from the ring. Call fill() when there is time - 
+   in loop() or from a low priority task - to refill the consumed slots.
+   If the ring runs empty the consumer generates values itself.
+   One producer and one consumer. Use RandomPool to get a buffer with storage.
+*/
+class RandomBuffer {
+  protected:
+    uint32_t *slot;
+    const uint8_t mask;                          // size - 1, size is a power of 2
+    volatile uint8_t head = 0;                   // next slot to read
+    volatile uint8_t tail = 0;                   // next slot to write
+    FastRandom generator;
+
+  public:
+    RandomBuffer(uint32_t *slot, uint8_t size) : slot(slot), mask(size - 1) {}
+    
+    void setSeed(uint32_t seed) {
+      generator.setSeed(seed);
+    }
+
+/**
+   \brief refill consumed slots
+   
+   \return the number of values generated
+*/
+    uint8_t fill() {
+      uint8_t done = 0;
+      while (((tail + 1) & mask) != head) {
+        slot[tail] = generator.next();
+        tail = (tail + 1) & mask;
+        done++;
+      }
+      return done;
+    }
+
+    bool pop(uint32_t &value) {
+      if (head == tail) return false;
+      value = slot[head];
+      head = (head + 1) & mask;
+      return true;
+    }
+};
+
+/**
+   \brief a RandomBuffer with its own storage
+   
+   \param size number of slots, a power of 2 up to 128
+*/
+template<uint8_t size>
+class RandomPool : public RandomBuffer {
+    static_assert(size >= 2 && size <= 128 && (size & (size - 1)) == 0, "RandomPool size must be a power of 2 (2..128)");
+    uint32_t storage[size];
+  public:
+    RandomPool() : RandomBuffer(storage, size) {}
+};
+
+uint32_t FastRandom::next() {
+  uint32_t value;
+  if (buffer && buffer->pop(value)) return value;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+/*  **************************************************
+    colors for effects
+    ************************************************** */ 
+
+/**
+   \brief multiply two 8 bit values, 255 * x = x
+*/
+constexpr uint8_t scale8(uint8_t a, uint8_t b) {
+  return ((uint16_t)a * (b + 1)) >> 8;
+}
+
+/**
+   \brief HSV to RGB in fixed point
+   
+   No division and no branch: the hue gets split in 6 sectors with a multiply-shift,
+   a table selects which of the 4 values (v, p, q, t) goes to red, green and blue.
+   \param hue 0..65535 for one turn, so a hue rotation can just overflow
+   \param sat saturation 0..255
+   \param val value 0..255
+   \return the color as 0xRRGGBB
+*/
+inline uint32_t colorHSV(uint16_t hue, uint8_t sat = 255, uint8_t val = 255) {
+  // sector -> source of r, g, b as 2 bit index into {v, p, q, t}
+  static const uint8_t select[6] = {
+    0 << 4 | 3 << 2 | 1,                         // v t p
+    2 << 4 | 0 << 2 | 1,                         // q v p
+    1 << 4 | 0 << 2 | 3,                         // p v t
+    1 << 4 | 2 << 2 | 0,                         // p q v
+    3 << 4 | 1 << 2 | 0,                         // t p v
+    0 << 4 | 1 << 2 | 2                          // v p q
+  };
+  uint32_t h6 = (uint32_t)hue * 6;
+  uint8_t sector = h6 >> 16;
+  uint8_t f = h6 >> 8;                           // position in the sector
+  uint8_t value[4];
+  value[0] = val;
+  value[1] = scale8(val, 255 - sat);
+  value[2] = scale8(val, 255 - scale8(sat, f));
+  value[3] = scale8(val, 255 - scale8(sat, 255 - f));
+  uint8_t s = select[sector];
+  return (uint32_t)value[s >> 4] << 16 | (uint16_t)value[(s >> 2) & 3] << 8 | value[s & 3];
+}
+
+/*  **************************************************
+    capabilities of the hardware classes
+    ************************************************** */ 
+
+/**
+   \brief longest hardware fade in ms
+   
+   Fades are handed to the hardware in segments of this length.
+   A write to the output would wait for the running segment, so the effects
+   keep a new level and write it when the segment has ended. 
+   This is the worst case delay for off() or a new brightness to show, nothing blocks.
+*/
+#ifndef NOIASCA_FADE_SEGMENT
+#define NOIASCA_FADE_SEGMENT 250
+#endif
+
+template<bool value>
+struct BoolTag {};
+
+/**
+   \brief defaults for OutputTraits
+   
+   hardwareFade: the class offers bool fadeTo(uint16_t target, uint32_t duration)
+   which runs a linear fade without the CPU and returns false if it can't.
+   hardwareBlink: the class offers bool blink(uint16_t onInterval, uint16_t offInterval)
+   which registers the blink of the output (0, 0 to end it) and returns true while it blinks without the CPU.
+   extraBits: native PWM resolution is 8 + extraBits bit
+   hasColor: the class offers setOnColor(index, color) for each output
+   levelWrite(): write a level in native resolution
+*/
+template<class T>
+struct OutputTraitsBase {
+  static constexpr bool hardwareFade = false;
+  static constexpr bool hardwareBlink = false;
+  static constexpr uint8_t extraBits = 0;
+  static constexpr bool hasColor = false;
+  static void levelWrite(T &obj, uint16_t level) {
+    obj.pwmWrite(level);
+  }
+};
+
+/**
+   \brief what a hardware class can do beyond the unified interface
+   
+   Specialise this for a hardware class in its own file 
+   and inherit the defaults from OutputTraitsBase.
+*/
+template<class T>
+struct OutputTraits : OutputTraitsBase<T> {};
+
+/*
+   gamma 2.8 in 12 bit for 8 bit input, one extra entry for the interpolation
+   https://learn.adafruit.com/led-tricks-gamma-correction/the-quick-fix
+*/
+const uint16_t noiascaGamma12[257] PROGMEM = {
+     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    1,    1,    1,    1,    1,
+     2,    2,    2,    3,    3,    4,    4,    5,    5,    6,    7,    8,    8,    9,   10,   11,
+    12,   13,   15,   16,   17,   18,   20,   21,   23,   25,   26,   28,   30,   32,   34,   36,
+    38,   40,   43,   45,   48,   50,   53,   56,   59,   62,   65,   68,   71,   75,   78,   82,
+    85,   89,   93,   97,  101,  105,  110,  114,  119,  123,  128,  133,  138,  143,  149,  154,
+   159,  165,  171,  177,  183,  189,  195,  202,  208,  215,  222,  229,  236,  243,  250,  258,
+   266,  273,  281,  290,  298,  306,  315,  324,  332,  341,  351,  360,  369,  379,  389,  399,
+   409,  419,  430,  440,  451,  462,  473,  485,  496,  508,  520,  532,  544,  556,  569,  582,
+   594,  608,  621,  634,  648,  662,  676,  690,  704,  719,  734,  749,  764,  779,  795,  811,
+   827,  843,  859,  876,  893,  910,  927,  944,  962,  980,  998, 1016, 1034, 1053, 1072, 1091,
+  1110, 1130, 1150, 1170, 1190, 1210, 1231, 1252, 1273, 1294, 1316, 1338, 1360, 1382, 1404, 1427,
+  1450, 1473, 1497, 1520, 1544, 1568, 1593, 1617, 1642, 1667, 1693, 1718, 1744, 1770, 1797, 1823,
+  1850, 1877, 1905, 1932, 1960, 1988, 2017, 2045, 2074, 2103, 2133, 2162, 2192, 2223, 2253, 2284,
+  2315, 2346, 2378, 2410, 2442, 2474, 2507, 2540, 2573, 2606, 2640, 2674, 2708, 2743, 2778, 2813,
+  2849, 2884, 2920, 2957, 2993, 3030, 3067, 3105, 3143, 3181, 3219, 3258, 3297, 3336, 3376, 3416,
+  3456, 3496, 3537, 3578, 3619, 3661, 3703, 3745, 3788, 3831, 3874, 3918, 3962, 4006, 4050, 4095,
+  4095
+};
+
+/**
+   \brief brightness levels in the native resolution of an output
+   
+   Effects with a ramp (Smooth, Heartbeat, Fluorescent) work in levels 0..max.
+   That's 0..255 for most outputs and 0..4095 on a 12 bit PCA9685.
+*/
+template<class T>
+struct OutputLevel {
+  static constexpr uint8_t shift = OutputTraits<T>::extraBits;
+  static constexpr uint16_t max = (256U << shift) - 1;
+  static constexpr uint8_t up = (shift > 4) ? shift - 4 : 0;     // from the 12 bit gamma table
+  static constexpr uint8_t down = (shift > 4) ? 0 : 4 - shift;
+
+/**
+   \brief a 8 bit brightness as level, 255 is max
+*/
+  static uint16_t from8(uint8_t brightness) {
+    return ((uint16_t)brightness << shift) | (brightness >> (8 - shift));
+  }
+
+/**
+   \brief a level as 8 bit brightness
+*/
+  static uint8_t to8(uint16_t level) {
+    return level >> shift;
+  }
+
+/**
+   \brief gamma corrected level
+   
+   The table has 8 bit steps, levels between are interpolated.
+*/
+  static uint16_t gamma(uint16_t level) {
+    uint16_t index = level >> shift;
+    uint16_t low = pgm_read_word(&noiascaGamma12[index]);
+    uint16_t high = pgm_read_word(&noiascaGamma12[index + 1]);
+    uint16_t fraction = level & ((1U << shift) - 1);
+    uint32_t value = low + (((uint32_t)(high - low) * fraction) >> shift);   // 12 bit
+    // more than 12 bit: shift up and repeat the top bits like from8()
+    return ((value << up) | (value >> (12 - up))) >> down;
+  }
+
+/**
+   \brief steps of one level since the last step
+   
+   On a 8 bit output this is one step per interval, like the effects always did.
+   With more bits there are 2^extraBits steps per interval, but not more than that per call.
+   \param previousMillis the time of the last step, will be updated
+   \param fraction the part of a ms of previousMillis already used, will be updated
+   \param currentMillis the current time
+   \param interval time for one 8 bit step
+   \return number of levels to step
+*/
+  static uint16_t steps(uint32_t &previousMillis, uint8_t &fraction, uint32_t currentMillis, uint32_t interval) {
+    if (interval == 0) interval = 1;
+    uint32_t ticks = (currentMillis - previousMillis) << shift;   // 1/2^shift ms
+    if (ticks < interval + fraction) return 0;
+    uint32_t n = (ticks - fraction) / interval;
+    if (n >= (1UL << shift)) {                   // a full 8 bit step or more
+      previousMillis = currentMillis;
+      fraction = 0;
+      return 1U << shift;
+    }
+    uint32_t used = n * interval + fraction;
+    previousMillis += used >> shift;
+    fraction = used & ((1U << shift) - 1);
+    return n;
+  }
+};
+
 /*  **************************************************
     a base class 
     ************************************************** */ 
@@ -45,7 +372,7 @@ class LedBase {
     T &obj;                                      // a reference to an output object (pin, pixel, whatever...)
     uint8_t state = 1;                           // 0 OFF, 1 ON - default to on state, but might be overridden in some implementations
     using Callback = void (*)(uint8_t value);    // signature of a callback function
-    Callback cbStateChange;                      // a callback function if the state changes
+    Callback cbStateChange = nullptr;            // a callback function if the state changes
   
   public:
     LedBase(T &obj) : obj(obj) {}
@@ -137,15 +464,32 @@ class LedBase {
 // this class (and it members) hould be the pattern for new single classes
 template<class T>
 class Effect : public LedBase <T> {
-  protected:
+  public:
     // state 0 off, 1 ON, 2 a different state within effect - from LedBase class
     enum Mode {ONOFF, BLINK, FLICKER, FLUORESCENT, HEARTBEAT, PULSE, RHYTHM, SMOOTH};
+    using brightness_t = uint8_t;                // for Arduino is 8 bit enough. As some code uses hardcoded 255         
+    //typedef uint8_t brightness_t;              // for Arduino is 8 bit enough. As some code uses hardcoded 255         
+
+/**
+   \brief a complete set of effect parameters
+   
+   Get one with getConfig(), modify it and hand it over to reconfigure().
+*/
+    struct Config {
+      Mode mode;
+      uint32_t onColor;
+      uint32_t offColor;
+      uint16_t interval[8];
+      uint8_t lengthOfPattern;
+      brightness_t minBrightness;
+      brightness_t maxBrightness;
+    };
+
+  protected:
     Mode mode = ONOFF;                           // current mode of operation
     uint32_t previousMillis = millis();          // time management
     uint32_t previousMillisEffect = millis();    // timestamp for the effect (used in fluorescent)
    
-    using brightness_t = uint8_t;                // for Arduino is 8 bit enough. As some code uses hardcoded 255         
-    //typedef uint8_t brightness_t;              // for Arduino is 8 bit enough. As some code uses hardcoded 255         
     brightness_t maxBrightness = 255;            // maximum target brightness ("on")
     brightness_t minBrightness = 0;              // minimum target brightness ("off")
     brightness_t currentBrightness = 0;          // actual brightness of Pin
@@ -157,9 +501,216 @@ class Effect : public LedBase <T> {
     uint16_t interval[8] = {150,  60,  20,  270};          // ECE 2 uses 4 slots (but we need 8 in total
     //uint16_t onInterval = 500;       // interval[0] will be used instead of onInterval
     //uint16_t offInterval = 500;      // interval[1] will be used instead of offInterval
-    
+    FastRandom rng;                    // random values for flicker and fluorescent
+    
+    uint32_t onColor = 0x808080;       // colors as handed over to the hardware (same defaults)
+    uint32_t offColor = 0x000000;
+    brightness_t level = 0;            // the output level the effect wants to show
+    Config pending;                    // waits for the next phase boundary
+    bool hasPending = false;
+    uint16_t fadeDuration = 0;         // cross-fade in progress if > 0
+    uint32_t fadeStart = 0;
+    brightness_t fadeFromLevel = 0;    // output at the start of the cross-fade
+    uint32_t fadeFromColor = 0;
+    brightness_t fadeLastLevel = 0;    // last output written during the cross-fade
+    uint32_t fadeLastColor = 0;
+
+/*
+   all outputs of the effect go through writeDigital/writePwm.
+   During a cross-fade they only record the level, update() does one write per frame.
+*/
+    void writeDigital(uint8_t val) {
+      level = (val == LOW) ? 0 : 255;
+      if (fadeDuration == 0) LedBase<T>::obj.digWrite(val);
+    }
+
+    void writePwm(brightness_t value) {
+      level = value;
+      if (fadeDuration == 0) LedBase<T>::obj.pwmWrite(value);
+    }
+
+    static uint32_t blendColor(uint32_t from, uint32_t to, uint16_t amount) {
+      uint32_t result = 0;
+      for (uint8_t shift = 0; shift < 24; shift += 8) {
+        int32_t a = (from >> shift) & 0xFF;
+        int32_t b = (to >> shift) & 0xFF;
+        result |= (uint32_t)(uint8_t)(a + (((b - a) * (int32_t)amount) >> 8)) << shift;
+      }
+      return result;
+    }
+
+/*
+   take over a new configuration without restarting the effect.
+   The new mode continues from the current output level.
+*/
+    void applyConfig(const Config &config) {
+      mode = config.mode;
+      memcpy(interval, config.interval, sizeof(interval));
+      lengthOfPattern = config.lengthOfPattern;
+      minBrightness = config.minBrightness;
+      maxBrightness = config.maxBrightness;
+      onColor = config.onColor;
+      offColor = config.offColor;
+      if (fadeDuration == 0) {
+        LedBase<T>::obj.setOnColor(onColor);
+        LedBase<T>::obj.setOffColor(offColor);
+      }
+      hasPending = false;
+      if (LedBase<T>::state == 0) return;
+      switch (mode) {
+        case BLINK :       LedBase<T>::state = level ? 2 : 1; break;
+        case RHYTHM :      LedBase<T>::state = level ? 1 : 2; break;
+        case HEARTBEAT :   currentBrightness = level; LedBase<T>::state = level >= maxBrightness ? 2 : 1; break;
+        case SMOOTH :      currentBrightness = level; LedBase<T>::state = 1; break;
+        case FLUORESCENT : currentBrightness = level; LedBase<T>::state = 1; break;
+        case FLICKER :     LedBase<T>::state = 1; break;
+        case ONOFF :
+        case PULSE :       writeDigital(level ? HIGH : LOW); break;
+      }
+    }
+
+/*
+   called by the effects when a phase is complete (e.g. a blink toggled)
+*/
+    void phaseBoundary() {
+      if (hasPending) applyConfig(pending);
+    }
+
+/*
+   write the blended output once per frame
+*/
+    void crossFade(uint32_t currentMillis) {
+      uint32_t elapsed = currentMillis - fadeStart;
+      if (elapsed >= fadeDuration) {
+        fadeDuration = 0;
+        LedBase<T>::obj.setOnColor(onColor);
+        LedBase<T>::obj.setOffColor(offColor);
+        if (level == 0) LedBase<T>::obj.digWrite(LOW); else LedBase<T>::obj.pwmWrite(level);
+        return;
+      }
+      uint16_t amount = elapsed * 256 / fadeDuration;
+      brightness_t out = fadeFromLevel + ((((int32_t)level - fadeFromLevel) * (int32_t)amount) >> 8);
+      uint32_t color = blendColor(fadeFromColor, onColor, amount);
+      if (out == fadeLastLevel && color == fadeLastColor) return;
+      fadeLastLevel = out;
+      fadeLastColor = color;
+      LedBase<T>::obj.setOnColor(color);
+      LedBase<T>::obj.pwmWrite(out);
+    }
+
   public:
     Effect(T &obj) : LedBase<T>(obj) {}
+
+/**
+   \brief set the color for a LED in on state
+*/    
+    void setOnColor(uint32_t _onColor) {
+      onColor = _onColor;
+      if (fadeDuration == 0) LedBase<T>::obj.setOnColor(_onColor);
+    }
+    
+/**
+   \brief set the color for a LED in off state
+*/    
+    void setOffColor(uint32_t _offColor) {
+      offColor = _offColor;
+      if (fadeDuration == 0) LedBase<T>::obj.setOffColor(_offColor);
+    }
+
+/**
+   \brief get the current configuration
+   
+   \return mode, colors and timing currently in use
+*/
+    Config getConfig() {
+      Config config;
+      config.mode = mode;
+      config.onColor = onColor;
+      config.offColor = offColor;
+      memcpy(config.interval, interval, sizeof(interval));
+      config.lengthOfPattern = lengthOfPattern;
+      config.minBrightness = minBrightness;
+      config.maxBrightness = maxBrightness;
+      return config;
+    }
+
+/**
+   \brief get a configuration for a different mode
+   
+   Colors are taken from the current configuration, 
+   timing and brightness get the defaults of the new mode (like setModeX() does).
+   \param newMode the mode
+   \return a configuration to hand over to reconfigure()
+*/
+    Config getConfig(Mode newMode) {
+      Config config = getConfig();
+      config.mode = newMode;
+      config.minBrightness = 0;
+      config.maxBrightness = 255;
+      switch (newMode) {
+        case BLINK :       config.interval[0] = 500; config.interval[1] = 500; break;
+        case FLICKER :     config.interval[0] = 100; break;
+        case FLUORESCENT : config.interval[0] = rng.random(500, 5000); config.interval[1] = rng.random(50, 500); break;
+        case HEARTBEAT :   config.interval[0] = 5; break;
+        case PULSE :       config.interval[0] = 500; break;
+        case RHYTHM :      
+          config.interval[0] = 150; config.interval[1] = 60; config.interval[2] = 20; config.interval[3] = 270; 
+          config.lengthOfPattern = 4; 
+          break;
+        case SMOOTH :      config.interval[0] = 25; config.interval[1] = 15; break;
+        case ONOFF :       break;
+      }
+      return config;
+    }
+
+/**
+   \brief change mode, colors and timing in one step
+   
+   Unlike the setModeX() functions the effect is not restarted.
+   Without a fade the new configuration is taken over at the next phase boundary 
+   (the next blink edge, the end of a rhythm pattern, the dark point of a heartbeat).
+   With a fade it is taken over immediately and the output cross-fades 
+   from the old to the new output. During the cross-fade there is at most 
+   one write to the hardware per update().
+   \param config the new configuration, see getConfig()
+   \param fade the cross-fade duration in ms, 0 to switch at the next phase boundary
+   \param currentMillis you can handover a millis timestamp
+*/
+    void reconfigure(const Config &config, uint16_t fade = 0, uint32_t currentMillis = millis()) {
+      if (fade == 0) {
+        pending = config;
+        hasPending = true;
+        // effects without phases (or a switched off effect) take it over right now
+        if (LedBase<T>::state == 0 || mode == ONOFF || mode == PULSE || mode == SMOOTH) applyConfig(pending);
+        return;
+      }
+      fadeFromLevel = (fadeDuration) ? fadeLastLevel : level;
+      fadeFromColor = (fadeDuration) ? fadeLastColor : onColor;
+      fadeLastLevel = fadeFromLevel;
+      fadeLastColor = fadeFromColor;
+      fadeStart = currentMillis;
+      fadeDuration = fade;
+      applyConfig(config);
+    }
+
+/**
+   \brief seed the random generator
+   
+   The same seed gives the same flicker/fluorescent sequence.
+   \param seed the new seed
+*/
+    void setSeed(uint32_t seed) {
+      rng.setSeed(seed);
+    }
+    
+/**
+   \brief use a pre-generated buffer of random values
+   
+   \param buffer a RandomPool, one pool per effect, it has a single consumer
+*/
+    void setRandomBuffer(RandomBuffer *buffer) {
+      rng.setBuffer(buffer);
+    }
  
 /**
    \brief switch output off
@@ -170,7 +721,7 @@ class Effect : public LedBase <T> {
       uint8_t previousState = LedBase<T>::state;     
       LedBase<T>::state = 0;
       if (mode != SMOOTH) {
-        LedBase<T>::obj.digWrite(LOW);
+        writeDigital(LOW);
         currentBrightness = 0; 
       }
       if (LedBase<T>::cbStateChange && previousState != LedBase<T>::state) LedBase<T>::cbStateChange(LedBase<T>::state);
@@ -189,15 +740,15 @@ class Effect : public LedBase <T> {
       if (LedBase<T>::state == 0 || force) 
         LedBase<T>::state = 1; 
       if (mode == ONOFF || mode == PULSE) {        
-        LedBase<T>::obj.digWrite(HIGH);
+        writeDigital(HIGH);
         previousMillis = millis();     // needed for pulse
       }
       else if (mode == FLUORESCENT) {  
         currentBrightness = 0;
         previousMillis = millis();
-        LedBase<T>::obj.pwmWrite(2);             // "glimm" after start
-        interval[1] = random(50, 500);        // modify the first interval
-        interval[0] = random(500, 5000);
+        writePwm(2);             // "glimm" after start
+        interval[1] = rng.random(50, 500);        // modify the first interval
+        interval[0] = rng.random(500, 5000);
       }
       if (LedBase<T>::cbStateChange && previousState != LedBase<T>::state) LedBase<T>::cbStateChange(LedBase<T>::state);      
     }
@@ -229,7 +780,7 @@ class Effect : public LedBase <T> {
       uint8_t previousState = LedBase<T>::state; // remember current state
       LedBase<T>::state = 0;
       currentBrightness = 0; 
-      LedBase<T>::obj.pwmWrite(currentBrightness);
+      writePwm(currentBrightness);
       if (LedBase<T>::cbStateChange && previousState != LedBase<T>::state) LedBase<T>::cbStateChange(LedBase<T>::state);
     }  
 
@@ -250,7 +801,7 @@ class Effect : public LedBase <T> {
 */    
     void setCurrentBrightness(brightness_t brightness) {
       currentBrightness = brightness;
-      LedBase<T>::obj.pwmWrite(currentBrightness);
+      writePwm(currentBrightness);
     }  
     
 /**
@@ -315,6 +866,7 @@ class Effect : public LedBase <T> {
         case RHYTHM : rhythm(currentMillis); break;
         case SMOOTH : smooth(currentMillis); break;
       }
+      if (fadeDuration) crossFade(currentMillis);
     }
 
     // this functions takes either 2, 4, 6 or 8 parameters
@@ -433,8 +985,8 @@ class Effect : public LedBase <T> {
 */ 
     void setModeFluorescent() {
       mode = FLUORESCENT;
-      interval[0] = random(500, 5000);           // is also in on()
-      interval[1] = random(50, 500);          // modify the first interval
+      interval[0] = rng.random(500, 5000);           // is also in on()
+      interval[1] = rng.random(50, 500);          // modify the first interval
       if( LedBase<T>::state) LedBase<T>::state = 1; 
     } 
 
@@ -500,17 +1052,19 @@ class Effect : public LedBase <T> {
         if (LedBase<T>::state == 2) {
           if (currentMillis - previousMillis >= interval[0]) {
             LedBase<T>::state = 1;
-            LedBase<T>::obj.digWrite(LOW);
+            writeDigital(LOW);
             previousMillis = currentMillis;
             if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);
+            phaseBoundary();
           }
         }
         else {
           if (currentMillis - previousMillis >= interval[1]) {
             LedBase<T>::state = 2;
-            LedBase<T>::obj.digWrite(HIGH);
+            writeDigital(HIGH);
             previousMillis = currentMillis;
             if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);            
+            phaseBoundary();
           }
         }
       }
@@ -527,10 +1081,11 @@ class Effect : public LedBase <T> {
         if (currentMillis - previousMillis > interval[0])
         {
           //uint8_t value = (25 - random(22)) * 10 + 5;
-          int value = (random(maxBrightness) / 10) * 10 + 5;
-          LedBase<T>::obj.pwmWrite(value);
-          interval[0] = random(20, 150);
+          int value = (rng.random(maxBrightness) / 10) * 10 + 5;
+          writePwm(value);
+          interval[0] = rng.random(20, 150);
           previousMillis = currentMillis;
+          phaseBoundary();
         }
       }
     }
@@ -546,20 +1101,21 @@ class Effect : public LedBase <T> {
       {
         if (currentMillis - previousMillisEffect > interval[1]) {    // former variable was intervalEffect
           if (currentBrightness >= 200) {                  // alles ab diesem Wert ist "ein" daher müssen wir nun "aus" Schalten
-            currentBrightness = random(0, 5);              // Ein leichtes Glimmen der "Enden" ... könnte man auch ganz auf 0 setzen
-            interval[1] = random(400, 2000);               // unregeläßige Dunkelphasen (zwischen dem Aufblitzen)
+            currentBrightness = rng.random(0, 5);              // Ein leichtes Glimmen der "Enden" ... könnte man auch ganz auf 0 setzen
+            interval[1] = rng.random(400, 2000);               // unregeläßige Dunkelphasen (zwischen dem Aufblitzen)
           }
           else {
-            currentBrightness = random(200, 255);
-            interval[1] = random(20, 40);                  // flash shortly
+            currentBrightness = rng.random(200, 255);
+            interval[1] = rng.random(20, 40);                  // flash shortly
           }
-          LedBase<T>::obj.pwmWrite(currentBrightness);
+          writePwm(currentBrightness);
           previousMillisEffect = currentMillis;
+          phaseBoundary();
         }
         if (currentMillis - previousMillis > interval[0]) {
           currentBrightness = 200;     // after the tube is stable "on" it will take some time to reach 100%
           interval[0] = 100;           // we need 55 steps to get full 255 PWM = aprox 55 Seconds till the tube has full brightness
-          LedBase<T>::obj.pwmWrite(currentBrightness);
+          writePwm(currentBrightness);
           previousMillis = currentMillis;
           LedBase<T>::state = 2;
           if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);
@@ -569,10 +1125,11 @@ class Effect : public LedBase <T> {
         if (currentMillis - previousMillis >= interval[0]) {
           previousMillis = currentMillis;
           currentBrightness++;
-          LedBase<T>::obj.pwmWrite(currentBrightness);
+          writePwm(currentBrightness);
           if (currentBrightness >= 255) {
             LedBase<T>::state = 3;
             if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);
+            phaseBoundary();
           }
         }
       }
@@ -597,7 +1154,8 @@ class Effect : public LedBase <T> {
           if (currentBrightness > minBrightness) currentBrightness--;
           else LedBase<T>::state = 1;  // turn direction to upwards
         }
-        LedBase<T>::obj.pwmWrite(currentBrightness);
+        writePwm(currentBrightness);
+        if (LedBase<T>::state == 1 && currentBrightness <= minBrightness) phaseBoundary();
       }
     } 
 
@@ -617,7 +1175,7 @@ class Effect : public LedBase <T> {
           if (currentBrightness > minBrightness) currentBrightness = currentBrightness - 2;
           else currentBrightness = currentBrightness + 1;  // turn direction to upwards
         }
-        LedBase<T>::obj.pwmWrite(currentBrightness);
+        writePwm(currentBrightness);
       }
     }    
     
@@ -631,7 +1189,7 @@ class Effect : public LedBase <T> {
       if (LedBase<T>::state != 0) {
         if (LedBase<T>::state == 1) {
           if (currentMillis - previousMillis >= interval[0]) {
-            LedBase<T>::obj.digWrite(LOW);
+            writeDigital(LOW);
             LedBase<T>::state = 0;
             if(LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);
           }
@@ -650,15 +1208,17 @@ class Effect : public LedBase <T> {
       if (LedBase<T>::state > 0) {     // state 0 is reserved to "switch off" the light
         if (currentMillis - previousMillis > interval[LedBase<T>::state - 1]) {
           if (LedBase<T>::state % 2 != 0) {      // all odd states are ON, at the end of an interval we switch to the oposite pin state
-            LedBase<T>::obj.digWrite(LOW);
+            writeDigital(LOW);
           }
           else {
-            LedBase<T>::obj.digWrite(HIGH);
+            writeDigital(HIGH);
           }
           LedBase<T>::state++;
-          if (LedBase<T>::state > lengthOfPattern) 
-            LedBase<T>::state = 1;      // rollover
           previousMillis = currentMillis;
+          if (LedBase<T>::state > lengthOfPattern) {
+            LedBase<T>::state = 1;      // rollover
+            phaseBoundary();
+          }
         }
       }
     }    
@@ -672,17 +1232,17 @@ class Effect : public LedBase <T> {
     void smooth(uint32_t currentMillis = millis()) {
       if (LedBase<T>::state == 1 && currentBrightness < maxBrightness && currentMillis - previousMillis > interval[0]) {
         currentBrightness++;    
-        LedBase<T>::obj.pwmWrite(currentBrightness);
+        writePwm(currentBrightness);
         previousMillis = currentMillis;
       }
       else if (LedBase<T>::state == 1 && currentBrightness > maxBrightness && currentMillis - previousMillis > interval[1]) {
         currentBrightness--;
-        LedBase<T>::obj.pwmWrite(currentBrightness);
+        writePwm(currentBrightness);
         previousMillis = currentMillis;
       }
       else if (LedBase<T>::state == 0 && currentBrightness > 0 && currentMillis - previousMillis > interval[1]) {
         currentBrightness--;
-        LedBase<T>::obj.pwmWrite(currentBrightness);
+        writePwm(currentBrightness);
         previousMillis = currentMillis;
       }
     }    
@@ -695,38 +1255,145 @@ class Effect : public LedBase <T> {
     ************************************************** */  
 
 /**
-   \brief alternate blinking of to LEDs in a specific rhythm
+   \brief one step of a Sequencer
    
-   two LEDs blinking alternating
+   Tables of steps can be stored in PROGMEM. 
+   The interval is in ms, or SEQUENCE_SLOT + n to use the runtime interval n.
+*/
+struct SequenceStep {
+  uint8_t on;                                    // bit mask of the outputs which are on
+  uint8_t blink;                                 // bit mask of the outputs which blink in the blink interval
+  uint8_t color;                                 // 0 keep colors, else the color table entry color - 1 for the outputs of this step
+  uint16_t interval;                             // ms the step lasts or a runtime interval slot
+};
+
+// first interval which refers to a runtime interval slot of the Sequencer
+constexpr uint16_t SEQUENCE_SLOT = 0xFFFC;
+constexpr uint8_t SEQUENCE_SLOTS = 4;
+
+/**
+   \brief run a table of steps on N outputs
    
-   doesn't inherit from LedBase.
+   Each step defines which outputs are on, which outputs blink, a color and how long the step lasts.
+   The table is read from flash once per step, a step only writes the outputs which change. 
+   Between two steps update() has only to compare the time.
+   The callback receives the step index + 1, 0 if the Sequencer gets switched off.
+   
+   doesn't inherit from LedBase
+   \tparam T a group of outputs with digWrite(index, value) - setOnColor(index, color) if colors are used
+   \tparam N number of outputs (1..8)
 */
-template<class T>
-class Alternating { 
+template<class T, uint8_t N>
+class Sequencer {
+    static_assert(N >= 1 && N <= 8, "a Sequencer handles 1 to 8 outputs");
   protected:
-    static const uint8_t noOfPins = 2;
-    uint32_t previousMillis = millis();          // last blink timestamp
     T &obj;
-    uint16_t onInterval = 500;                   // milliseconds on time for the first LED = off time for the second LED
-    uint16_t offInterval = 500;                  // milliseconds off time for the first LED = on time for the secon LED
-    //bool active = HIGH;                        // is the pin active HIGH
-    uint8_t state = 1;                           // 0 idle, 1 blinkA, 2blinkB
+    uint32_t previousMillis = millis();          // last step timestamp
+    uint32_t previousMillisBlink = millis();     // last blink timestamp
+    const SequenceStep *program = nullptr;       // the table of steps
+    const uint32_t *colors = nullptr;            // color table in PROGMEM
+    uint16_t slot[SEQUENCE_SLOTS] {500, 500, 500, 500};    // runtime intervals
+    uint16_t blinkInterval = 500;                // milliseconds for blinking outputs
+    uint16_t interval = 0;                       // interval of the current step in ms
+    SequenceStep step {0, 0, 0, 0};              // copy of the current step
+    uint8_t length = 0;                          // number of steps in the program
+    uint8_t current = 0;                         // index of the current step
+    uint8_t shown = 0;                           // bit mask of the outputs which are on
+    uint8_t state = 1;                           // 0 off, 1 run
+    bool inFlash = true;                         // program is in PROGMEM
+    bool hold = false;                           // stay in the current step
     using Callback = void (*)(uint8_t value);    // signature of a callback function
-    Callback cbStateChange;                      // a callback function if the state changes
+    Callback cbStepChange = nullptr;             // a callback function if the step changes
 
-  public:
 /*
-   \brief alternate blinking of two LEDs in a specific rhythm
+   write the outputs which differ from mask
+   dirty forces a write of outputs even if they don't change
+*/
+    void show(uint8_t mask, uint8_t dirty = 0) {
+      uint8_t diff = (shown ^ mask) | dirty;
+      for (uint8_t i = 0; i < N; i++) {
+        if (diff & (1 << i)) obj.digWrite(i, (mask & (1 << i)) ? HIGH : LOW);
+      }
+      shown = mask;
+    }
+
+    void paint(uint8_t mask, BoolTag<false>) {
+      (void)mask;
+    }
+
+    void paint(uint8_t mask, BoolTag<true>) {
+      uint32_t color = pgm_read_dword(&colors[step.color - 1]);
+      for (uint8_t i = 0; i < N; i++) {
+        if (mask & (1 << i)) obj.setOnColor(i, color);
+      }
+    }
+
+/*
+   show a step, the step may not be in the program
+*/
+    void enter(const SequenceStep &newStep) {
+      step = newStep;
+      interval = step.interval >= SEQUENCE_SLOT ? slot[step.interval - SEQUENCE_SLOT] : step.interval;
+      uint8_t mask = step.on | step.blink;
+      uint8_t dirty = 0;
+      if (step.color && colors) {
+        paint(mask, BoolTag<OutputTraits<T>::hasColor>());
+        dirty = mask;                            // new color on outputs which are on already
+      }
+      show(mask, dirty);
+    }
+
+/*
+   read a step of the program and show it
+*/
+    void enter(uint8_t index) {
+      SequenceStep newStep;
+      if (inFlash)
+        memcpy_P(&newStep, &program[index], sizeof(newStep));
+      else
+        newStep = program[index];
+      current = index;
+      enter(newStep);
+      if (cbStepChange) cbStepChange(current + 1);
+    }
+
+/*
+   run the program, returns true if a new step was entered
+*/
+    bool tick(uint32_t currentMillis) {
+      bool result = false;
+      if (state == 0 || length == 0) return result;
+      if (!hold && currentMillis - previousMillis >= interval) {
+        previousMillis = currentMillis;
+        previousMillisBlink = currentMillis;
+        enter((uint8_t)(current + 1 < length ? current + 1 : 0));
+        result = true;
+      }
+      else if (step.blink && currentMillis - previousMillisBlink >= blinkInterval) {
+        previousMillisBlink = currentMillis;
+        show(shown ^ step.blink);
+      }
+      return result;
+    }
+
+  public:
+/**
+   \brief run a table of steps on N outputs
    
-   \param obj a object to connect LEDs
-   \param on   the on  time of pin 1 in ms (vice versa the off time of pin2). This parameter is optional.
-   \param off  the off time of pin 1 in ms (vice versa the on  time of pin2). This parameter is optional.
+   \param obj a object with N outputs
+*/
+    Sequencer(T &obj) : obj(obj) {}
+
+/**
+   \brief run a table of steps on N outputs
+   
+   \param obj a object with N outputs
+   \param program a table of steps in PROGMEM
+   \param length the number of steps in the table
 */
-    Alternating(T &obj, uint16_t on = 500, uint16_t off = 500) :
-      obj(obj),
-      onInterval {on},
-      offInterval {off}
-    {}
+    Sequencer(T &obj, const SequenceStep *program, uint8_t length) : obj(obj) {
+      setProgram(program, length);
+    }
 
 /**
    \brief start hardware
@@ -737,65 +1404,102 @@ class Alternating {
     void begin() {
       obj.begin();
     }
-    
-    void setOnColor(uint32_t _onColor) {
-      obj.setOnColor(_onColor);
+
+/**
+   \brief set the table of steps
+   
+   The program starts with the first step on the next update().
+   \param program a table of steps
+   \param length the number of steps in the table
+   \param inFlash true (default) if the table is in PROGMEM, false if it is in RAM
+*/
+    void setProgram(const SequenceStep *program, uint8_t length, bool inFlash = true) {
+      (*this).program = program;
+      (*this).length = length;
+      (*this).inFlash = inFlash;
+      current = length - 1;                      // next step is the first one
+      interval = 0;
     }
+
 /**
-   \brief set on/off times 
+   \brief set a color table
    
-   Set the on intervals of both LEDs during runtime.
-   \param onA the on time of pinA in ms (vice versa the off time of pinB).
-   \param onB the on time of pinB in ms (vice versa the off time of pinB).
+   A step with color > 0 sets the on color of its outputs to colors[color - 1].
+   \param colors a table of colors in PROGMEM
 */
-    void setOnInterval(uint16_t onA, uint16_t onB) {
-      onInterval = onA;
-      offInterval = onB;
+    void setColors(const uint32_t *colors) {
+      (*this).colors = colors;
     }
-    
+
 /**
-   \brief set on/off times 
+   \brief set a runtime interval
    
-   Set the interval during runtime.
-   \param onA the on time of pinA and pinB in ms.
-*/   
-    void setOnInterval(uint16_t onA) {
-      onInterval = onA;
-      offInterval = onA;
+   Steps with the interval SEQUENCE_SLOT + index use this interval.
+   \param index the slot 0..3
+   \param _interval the interval in ms
+*/
+    void setSlotInterval(uint8_t index, uint16_t _interval) {
+      if (index < SEQUENCE_SLOTS) slot[index] = _interval;
     }
-    
-/** 
-    \brief set the callback function onStateChange
 
-    a callback function receives state changes from the effect 
-    \param funcPtr the callback function
+/**
+   \brief set the blink interval
+   
+   \param _interval the on and off time of blinking outputs in ms
+*/
+    void setBlinkInterval(uint16_t _interval) {
+      blinkInterval = _interval;
+    }
+
+/**
+   \brief stay in the current step
+   
+   \param _hold true to stop the program in the current step, blinking outputs continue
+*/
+    void setHold(bool _hold) {
+      hold = _hold;
+    }
+
+/**
+   \brief index of the current step
+*/
+    uint8_t getStep() {
+      return current;
+    }
+
+/** 
+    \brief set the callback function onStepChange
+
+    a callback function receives the step index + 1 and 0 for off
+    \param funcPtr the callback function
 */ 
-    void setOnStateChange(Callback funcPtr) {
-      cbStateChange = funcPtr;
+    void setOnStepChange(Callback funcPtr) {
+      cbStepChange = funcPtr;
     }
-    
+
 /**
    \brief switch output on
    
-   Switch the output to on state.
+   Starts the program with the first step.
 */
     void on() {
-      uint8_t previousState = state;
-      state = 1;
-      if (cbStateChange && previousState != state) cbStateChange(state);
+      if (state == 0) {
+        state = 1;
+        current = length - 1;
+        interval = 0;
+      }
     }
- 
+
 /**
    \brief switch output off
    
-   Switch the output to off state.
+   Switch the outputs to off state.
 */
     void off() {
       uint8_t previousState = state;
       state = 0;
-      obj.digWrite(0, LOW);
-      obj.digWrite(1, LOW);
-      if (cbStateChange && previousState != state) cbStateChange(state);
+      show(0, (1 << N) - 1);
+      if (cbStepChange && previousState != state) cbStepChange(state);
     }
 
 /**
@@ -803,47 +1507,84 @@ class Alternating {
 */
     void toggle() {
       if (state == 0) on(); else off();
-      // callback is done by on() / off()
-    } 
+    }
 
-/*
-   \brief check if update is necessary
-   
-   This is the "run" function. Call this function in loop() to make the effect visible.
-   This function uses by default the actual millis() to determine, if an action is necessary.
-*/     
-//   void update() {
-//     update(millis()); 
-//   }
-    
 /**
    \brief check if update is necessary
    
    This is the "run" function. Call this function in loop() to make the effect visible.
    \param currentMillis you can handover a millis timestamp
-*/    
+*/
     void update(uint32_t currentMillis = millis()) {
-      if (state) {
-        //uint32_t currentMillis = millis();
-        if (state == 1 && currentMillis - previousMillis >= onInterval) {
-          previousMillis = currentMillis;        // save the last time you blinked the LED
-          obj.digWrite(0, LOW);
-          obj.digWrite(1, HIGH);
-          state = 2;
-          if (cbStateChange) cbStateChange(state);
-        }
-        else if (state == 2 && currentMillis - previousMillis >= offInterval) {
-          previousMillis = currentMillis;        // save the last time you blinked the LED
-          obj.digWrite(0, HIGH);
-          obj.digWrite(1, LOW);
-          state = 1;
-          if (cbStateChange) cbStateChange(state);
-        }
-      }
-      else {       // switch off both LEDs             MISSING tbd: check against previousState?
-        obj.digWrite(0, LOW);
-        obj.digWrite(1, LOW);
-      }
+      tick(currentMillis);
+    }
+};
+
+/*
+   the two steps of Alternating
+*/
+const SequenceStep sequenceAlternating[] PROGMEM = {
+  {0b01, 0, 0, SEQUENCE_SLOT + 0},
+  {0b10, 0, 0, SEQUENCE_SLOT + 1}
+};
+
+/**
+   \brief alternate blinking of to LEDs in a specific rhythm
+   
+   two LEDs blinking alternating
+   A Sequencer with two steps.
+   
+   doesn't inherit from LedBase.
+*/
+template<class T>
+class Alternating : public Sequencer<T, 2> { 
+    using Base = Sequencer<T, 2>;
+  public:
+/*
+   \brief alternate blinking of two LEDs in a specific rhythm
+   
+   \param obj a object to connect LEDs
+   \param on   the on  time of pin 1 in ms (vice versa the off time of pin2). This parameter is optional.
+   \param off  the off time of pin 1 in ms (vice versa the on  time of pin2). This parameter is optional.
+*/
+    Alternating(T &obj, uint16_t on = 500, uint16_t off = 500) : Base(obj, sequenceAlternating, 2) {
+      setOnInterval(on, off);
+    }
+
+    void setOnColor(uint32_t _onColor) {
+      Base::obj.setOnColor(_onColor);
+    }
+/**
+   \brief set on/off times 
+   
+   Set the on intervals of both LEDs during runtime.
+   \param onA the on time of pinA in ms (vice versa the off time of pinB).
+   \param onB the on time of pinB in ms (vice versa the off time of pinB).
+*/
+    void setOnInterval(uint16_t onA, uint16_t onB) {
+      Base::setSlotInterval(0, onA);
+      Base::setSlotInterval(1, onB);
+    }
+    
+/**
+   \brief set on/off times 
+   
+   Set the interval during runtime.
+   \param onA the on time of pinA and pinB in ms.
+*/   
+    void setOnInterval(uint16_t onA) {
+      setOnInterval(onA, onA);
+    }
+    
+/** 
+    \brief set the callback function onStateChange
+
+    a callback function receives state changes from the effect:
+    0 off, 1 first LED on, 2 second LED on
+    \param funcPtr the callback function
+*/ 
+    void setOnStateChange(typename Base::Callback funcPtr) {
+      Base::setOnStepChange(funcPtr);
     }
 };
 
@@ -852,6 +1593,7 @@ class Alternating {
    
    a class to blink a object
    uses a unified hw interface
+   If the output can blink by itself (OutputTraits), it does.
 */
 template<class T>
 class Blink : public LedBase <T> {
@@ -861,6 +1603,43 @@ class Blink : public LedBase <T> {
     uint16_t offInterval = 500;
     // state 0 off, 1 Blink-OFF, 2 Blink-ON
 
+    void update(uint32_t currentMillis, BoolTag<false>) {
+      if (LedBase<T>::state != 0) {
+        //uint32_t currentMillis = millis();
+        if (LedBase<T>::state == 2) {
+          if (currentMillis - previousMillis >= onInterval) {
+            LedBase<T>::state = 1;
+            LedBase<T>::obj.digWrite(LOW);
+            previousMillis = currentMillis;
+            if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);
+          }
+        }
+        else {
+          if (currentMillis - previousMillis >= offInterval) {
+            LedBase<T>::state = 2;
+            LedBase<T>::obj.digWrite(HIGH);
+            previousMillis = currentMillis;
+            if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);            
+          }
+        }
+      }
+    }
+
+/*
+   hardware blink: the output is told the intervals on each update, a change
+   of the intervals or the state is picked up there. No state change callbacks
+   while the output blinks by itself.
+*/
+    void update(uint32_t currentMillis, BoolTag<true>) {
+      bool active = LedBase<T>::state != 0;
+      if (LedBase<T>::obj.blink(active ? onInterval : 0, active ? offInterval : 0)) {
+        LedBase<T>::state = 2;                   // the output is on and blinks
+        previousMillis = currentMillis;          // software continues with a full interval
+        return;
+      }
+      update(currentMillis, BoolTag<false>());
+    }
+
   public:
     Blink(T &obj) : LedBase<T>(obj) {}
  
@@ -883,6 +1662,42 @@ class Blink : public LedBase <T> {
     void setOffInterval(uint16_t newInterval) {
       offInterval = newInterval;
     }
+
+/**
+   \brief where a running blink is in its cycle
+   
+   Get one with getPhase(), setPhase() continues the blink from there.
+*/
+    struct Phase {
+      uint8_t state;
+      uint32_t elapsed;                          // ms since the last toggle
+    };
+
+/**
+   \brief where the blink is right now
+   
+   \param currentMillis you can handover a millis timestamp
+*/
+    Phase getPhase(uint32_t currentMillis = millis()) const {
+      Phase phase;
+      phase.state = LedBase<T>::state;
+      phase.elapsed = currentMillis - previousMillis;
+      return phase;
+    }
+
+/**
+   \brief continue the blink from a phase taken with getPhase()
+   
+   The intervals are not part of the phase, set them up first.
+   The output is written right away, there is no state change callback.
+   \param phase the phase to continue from
+   \param currentMillis you can handover a millis timestamp
+*/
+    void setPhase(const Phase &phase, uint32_t currentMillis = millis()) {
+      LedBase<T>::state = phase.state <= 2 ? phase.state : 0;
+      previousMillis = currentMillis - phase.elapsed;
+      LedBase<T>::obj.digWrite(LedBase<T>::state == 2 ? HIGH : LOW);
+    }
     
 /**
    \brief switch output off
@@ -952,55 +1767,121 @@ class Blink : public LedBase <T> {
    \param currentMillis you can handover a millis timestamp
 */     
     void update(uint32_t currentMillis = millis()) {
-      if (LedBase<T>::state != 0) {
-        //uint32_t currentMillis = millis();
-        if (LedBase<T>::state == 2) {
-          if (currentMillis - previousMillis >= onInterval) {
-            LedBase<T>::state = 1;
-            LedBase<T>::obj.digWrite(LOW);
-            previousMillis = currentMillis;
-            if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);
-          }
-        }
-        else {
-          if (currentMillis - previousMillis >= offInterval) {
-            LedBase<T>::state = 2;
-            LedBase<T>::obj.digWrite(HIGH);
-            previousMillis = currentMillis;
-            if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);            
-          }
-        }
-      }
+      update(currentMillis, BoolTag<OutputTraits<T>::hardwareBlink>());
     }
 };
 
 /**
-   \brief Bounce 5 LEDs between left and right
+   \brief the path of a Scanner
+*/
+enum ScanPattern : uint8_t {
+  SCAN_BOUNCE,                                   // 0, 1, .. N-1, N-2, .. 1
+  SCAN_WRAP                                      // 0, 1, .. N-1, 0, 1 ..
+};
+
+/**
+   \brief running light over N LEDs
    
-   running lights like a KITT/Larson Scanner
+   A KITT/Larson scanner for any group of outputs.
+   The pattern is a constexpr function of the step, there is no table.
+   Each step only writes the LEDs which change their level, 
+   so the cost of a step depends on the tail and not on N.
    states are: 0 off; 1 run and on, 2 run but off
    
-   doesn't inherit from LedBase
+   \tparam T a group of outputs with digWrite(index, value) - and pwmWrite(index, value) for a tail
+   \tparam N number of LEDs
+   \tparam pattern SCAN_BOUNCE or SCAN_WRAP
+   \tparam tail number of dimmed LEDs behind the head
 */
-template<class T>
-class Bounce5 {  
-    unsigned long previousMillis;                // last blink timestamp
-    uint16_t onInterval = 200;                   // milliseconds on time for the LEDs
-    uint16_t offInterval = 20;                   // milliseconds off time for the LEDs
-    uint8_t current = 0;                         // current position in pattern
+template<class T, uint8_t N, ScanPattern pattern = SCAN_BOUNCE, uint8_t tail = 0>
+class Scanner {  
+    static_assert(N >= 2, "a Scanner needs at least 2 LEDs");
+    static_assert(tail < N, "the tail must be shorter than the Scanner");
+  protected:
+    uint32_t previousMillis = millis();          // last step timestamp
+    uint16_t onInterval = 200;                   // milliseconds from one step to the next / on time
+    uint16_t offInterval = 0;                    // milliseconds all LEDs are off between two steps, 0 = no gap
+    uint16_t current = period() - 1;             // step which is shown, in state 2 the step before the next one
+    uint8_t age = 0;                             // steps since start, the tail grows up to this
     T &obj;
     uint8_t state = 2;
     using Callback = void (*)(uint8_t value);    // signature of a callback function
-    Callback cbStateChange;                      // a callback function if the state changes
- 
+    Callback cbStateChange = nullptr;            // a callback function if the state changes
+
+/*
+   number of steps of the pattern
+*/
+    static constexpr uint16_t period() {
+      return (pattern == SCAN_WRAP) ? N : 2 * N - 2;
+    }
+
+/*
+   the LED of a step
+*/
+    static constexpr uint8_t position(uint16_t step) {
+      return (pattern == SCAN_WRAP || step < N) ? step : 2 * N - 2 - step;
+    }
+
+/*
+   brightness of the LED j steps behind the head
+*/
+    static constexpr uint8_t tailLevel(uint8_t j) {
+      return 255 - (uint16_t)255 * j / (tail + 1);
+    }
+
+/*
+   the step j steps before step
+*/
+    static uint16_t before(uint16_t step, uint8_t j) {
+      return (step + period() - j) % period();
+    }
+
+/*
+   level of a LED if step is the head and the tail has a length of len
+*/
+    static uint8_t levelAt(uint8_t led, uint16_t step, uint8_t len) {
+      for (uint8_t j = 0; j <= len; j++) {
+        if (position(before(step, j)) == led) return tailLevel(j);   // nearest to the head is brightest
+      }
+      return 0;
+    }
+
+    void write(uint8_t led, uint8_t level, BoolTag<false>) {
+      obj.digWrite(led, level ? HIGH : LOW);
+    }
+
+    void write(uint8_t led, uint8_t level, BoolTag<true>) {
+      obj.pwmWrite(led, level);
+    }
+
+/*
+   change from one picture to the next and only write LEDs with a new level.
+   A picture is a head step and the length of the tail, dark pictures have no LED on.
+*/
+    void change(uint16_t fromStep, uint8_t fromLen, bool fromDark, uint16_t toStep, uint8_t toLen, bool toDark) {
+      uint8_t candidate[2 * (tail + 1)];
+      uint8_t count = 0;
+      for (uint8_t j = 0; j <= tail; j++) {
+        if (!fromDark && j <= fromLen) candidate[count++] = position(before(fromStep, j));
+        if (!toDark && j <= toLen) candidate[count++] = position(before(toStep, j));
+      }
+      for (uint8_t i = 0; i < count; i++) {
+        bool done = false;
+        for (uint8_t k = 0; k < i && !done; k++) done = candidate[k] == candidate[i];
+        if (done) continue;
+        uint8_t oldLevel = fromDark ? 0 : levelAt(candidate[i], fromStep, fromLen);
+        uint8_t newLevel = toDark ? 0 : levelAt(candidate[i], toStep, toLen);
+        if (oldLevel != newLevel) write(candidate[i], newLevel, BoolTag<(tail > 0)>());
+      }
+    }
 
   public:
 /**
-   \brief Bounce 5 LEDs between left and right
+   \brief running light over N LEDs
    
-   \param obj a object with 5 LEDs
+   \param obj a object with N LEDs
 */
-    Bounce5(T &obj) : obj(obj) {}
+    Scanner(T &obj) : obj(obj) {}
     
 /**
    \brief start hardware
@@ -1012,7 +1893,7 @@ class Bounce5 {
       obj.begin();
     }
     
-// modify on/off times during runtime
+    // modify on/off times during runtime
     void setOffInterval(uint16_t _off) {         
       offInterval = _off;
     }
@@ -1029,11 +1910,9 @@ class Bounce5 {
 /** 
     \brief set the callback function onStateChange
 
-    a callback function receives state changes from the car traffic light
+    a callback function receives state changes
     \param funcPtr the callback function
-    @todo clearify usage of this vs onSequnceChange
 */ 
-  
     void setOnStateChange(Callback funcPtr) {
       cbStateChange = funcPtr;
     }
@@ -1041,81 +1920,247 @@ class Bounce5 {
 /**
    \brief switch output on
    
-    Switch the output to on state.
+    Start the scanner from the first LED.
 */
     void on() {
       uint8_t previousState = state;      
-      state = 1;
+      if (state == 0) {
+        state = 2;
+        current = period() - 1;
+        age = 0;
+      }
       if (cbStateChange && previousState != state) cbStateChange(state);
     }
 
 /**
    \brief switch output off
    
-   Switch the output to off state.
+   Switch the output to off state. Only the LEDs which are on get written.
 */
     void off() {
       uint8_t previousState = state;      
+      if (state == 1) change(current, age, false, current, age, true);
       state = 0;
-      for (size_t i = 0; i < 5; i++)
-      {
-        obj.digWrite(i, LOW);
-      }
       if (cbStateChange && previousState != state) cbStateChange(state);
     }
+
+/**
+   \brief switch between on or off state
+*/
+    void toggle() {
+      if (state == 0) on(); else off();
+    }
+
+/**
+   \brief check if update is necessary
+   
+   This is the "run" function. Call this function in loop() to make the effect visible.
+   \param currentMillis you can handover a millis timestamp
+*/     
+    void update(uint32_t currentMillis = millis()) {
+      if (state == 1 && currentMillis - previousMillis >= onInterval) {
+        previousMillis = currentMillis;
+        if (offInterval) {                       // time to switch off
+          change(current, age, false, current, age, true);
+          state = 2;
+          // no callback as states change from 1 to 2
+        }
+        else {                                   // next step 
+          uint16_t next = (current + 1) % period();
+          uint8_t nextAge = (age < tail) ? age + 1 : tail;
+          change(current, age, false, next, nextAge, false);
+          current = next;
+          age = nextAge;
+        }
+      }
+      else if (state == 2 && currentMillis - previousMillis >= offInterval) {
+        // time to switch on next LED
+        previousMillis = currentMillis;
+        uint16_t next = (current + 1) % period();
+        if (current != period() - 1 || age) age = (age < tail) ? age + 1 : tail;
+        change(next, age, true, next, age, false);
+        current = next;
+        state = 1;
+      }
+    }
+};
+
+/**
+   \brief Bounce 5 LEDs between left and right
+   
+   running lights like a KITT/Larson Scanner
+   states are: 0 off; 1 run and on, 2 run but off
+   A Scanner with 5 LEDs and a short gap between the steps.
+   
+   doesn't inherit from LedBase
+*/
+template<class T>
+class Bounce5 : public Scanner<T, 5> {  
+  public:
+/**
+   \brief Bounce 5 LEDs between left and right
+   
+   \param obj a object with 5 LEDs
+*/
+    Bounce5(T &obj) : Scanner<T, 5>(obj) {
+      Scanner<T, 5>::setOffInterval(20);
+    }
+};
+
+/**
+   \brief rotate the hue of one output
+   
+   The output needs setOnColor(color), e.g. a Neopixel.
+   
+   doesn't inherit from LedBase
+*/
+template<class T>
+class HueCycle {
+  protected:
+    T &obj;
+    uint32_t previousMillis = millis();          // last step timestamp
+    uint16_t interval = 20;                      // milliseconds between two colors
+    uint16_t hue = 0;                            // current hue 0..65535
+    uint16_t hueStep = 256;                      // hue change per interval, one turn in 256 steps
+    uint8_t sat = 255;
+    uint8_t val = 255;
+    uint8_t state = 1;                           // 0 off, 1 on
+
+  public:
+/**
+   \brief rotate the hue of one output
+   
+   \param obj a object with one colored output
+*/
+    HueCycle(T &obj) : obj(obj) {}
+
+/**
+   \brief start hardware
+   
+   Will do the necessary steps to initialize the hardware pins.
+   Call this function in your setup().
+*/
+    void begin() {
+      obj.begin();
+    }
+
+/**
+   \brief set the speed
+   
+   \param _interval milliseconds between two colors
+   \param _hueStep hue change per interval, 65536 is one turn
+*/
+    void setInterval(uint16_t _interval, uint16_t _hueStep = 256) {
+      interval = _interval;
+      hueStep = _hueStep;
+    }
+
+/**
+   \brief set saturation and value of the colors
+*/
+    void setSatVal(uint8_t _sat, uint8_t _val) {
+      sat = _sat;
+      val = _val;
+    }
+
+/**
+   \brief switch output on
+*/
+    void on() {
+      state = 1;
+    }
+
+/**
+   \brief switch output off
+*/
+    void off() {
+      state = 0;
+      obj.digWrite(LOW);
+    }
+
+/**
+   \brief switch between on or off state
+*/
+    void toggle() {
+      if (state == 0) on(); else off();
+    }
+
+/**
+   \brief check if update is necessary
+   
+   This is the "run" function. Call this function in loop() to make the effect visible.
+   \param currentMillis you can handover a millis timestamp
+*/
+    void update(uint32_t currentMillis = millis()) {
+      if (state && currentMillis - previousMillis >= interval) {
+        previousMillis = currentMillis;
+        hue += hueStep;
+        obj.setOnColor(colorHSV(hue, sat, val));
+        obj.digWrite(HIGH);
+      }
+    }
+};
+
+/**
+   \brief a rotating rainbow over N outputs
+   
+   The hues are spread over the outputs, the whole rainbow rotates.
+   The group needs setOnColor(index, color), e.g. a NeoPixelGroup.
+   
+   doesn't inherit from LedBase
+   \tparam T a group of colored outputs
+   \tparam N number of outputs
+*/
+template<class T, uint8_t N>
+class Rainbow : public HueCycle<T> {
+    using Base = HueCycle<T>;
+  protected:
+    uint16_t spread = 65536UL / N;               // hue distance of two outputs
+
+  public:
+/**
+   \brief a rotating rainbow over N outputs
+   
+   \param obj a object with N colored outputs
+*/
+    Rainbow(T &obj) : Base(obj) {}
+
+/**
+   \brief set the hue distance of two outputs
+   
+   \param _spread 65536 / N (default) shows one full rainbow
+*/
+    void setSpread(uint16_t _spread) {
+      spread = _spread;
+    }
+
 /**
-   \brief switch between on or off state
+   \brief switch output off
 */
+    void off() {
+      Base::state = 0;
+      for (uint8_t i = 0; i < N; i++) Base::obj.digWrite(i, LOW);
+    }
+
     void toggle() {
-      if (state == 0) on(); else off();
+      if (Base::state == 0) Base::on(); else off();
     }
 
-/*
-   \brief check if update is necessary
-   
-   This is the "run" function. Call this function in loop() to make the effect visible.
-   This function uses by default the actual millis() to determine, if an action is necessary.
-*/     
-//    void update() {
-//     update(millis()); 
-//    }
-    
 /**
    \brief check if update is necessary
    
    This is the "run" function. Call this function in loop() to make the effect visible.
    \param currentMillis you can handover a millis timestamp
-*/     
+*/
     void update(uint32_t currentMillis = millis()) {
-      if (state > 0) {
-        const uint8_t ledPattern[] = {0, 1, 2, 3, 4, 3, 2, 1};       // the order how to light the LEDs
-        const uint8_t totalPatterns = sizeof(ledPattern) / sizeof(ledPattern[0]);
-        uint8_t actualLed = ledPattern[current];
-
-        if (state == 1 && currentMillis - previousMillis >= onInterval) {
-          // time to switch off
-          previousMillis = currentMillis;
-          for (size_t i = 0; i < 5; i++)
-          {
-            obj.digWrite(i, LOW);
-          }
-          state = 2;
-          // no callback as states change from 1 to 2
-        }
-        else if (state == 2 && currentMillis - previousMillis >= offInterval) {
-          // time to switch on next LED
-          previousMillis = currentMillis;
-          obj.digWrite(actualLed, HIGH);
-          current++;
-          if (current >= totalPatterns) current = 0;
-          state = 1;
-          // no callback as states change from 1 to 2
-        }
-      }
-      else {       // switch off all LEDs  MISSING: tbd do only when previousState wasn't 0
-        for (size_t i = 0; i < 5; i++)
-        {
-          obj.digWrite(i, LOW);
+      if (Base::state && currentMillis - Base::previousMillis >= Base::interval) {
+        Base::previousMillis = currentMillis;
+        Base::hue += Base::hueStep;
+        uint16_t h = Base::hue;
+        for (uint8_t i = 0; i < N; i++) {
+          Base::obj.setOnColor(i, colorHSV(h, Base::sat, Base::val));
+          Base::obj.digWrite(i, HIGH);
+          h += spread;
         }
       }
     }
@@ -1132,6 +2177,7 @@ class Flicker : public LedBase<T> {
     uint32_t previousMillis = millis();// time management
     uint8_t interval = 100;
     uint16_t maxBrightness = 255;      // native PWM on Arduino is only 8 bit. But could be used for other processors also.
+    FastRandom rng;                    // random values for the flicker
 
   public:
 /**
@@ -1141,6 +2187,25 @@ class Flicker : public LedBase<T> {
 */
     Flicker (T &obj) : LedBase<T>(obj) {}
 
+/**
+   \brief seed the random generator
+   
+   The same seed gives the same flicker sequence.
+   \param seed the new seed
+*/
+    void setSeed(uint32_t seed) {
+      rng.setSeed(seed);
+    }
+    
+/**
+   \brief use a pre-generated buffer of random values
+   
+   \param buffer a RandomPool, one pool per effect, it has a single consumer
+*/
+    void setRandomBuffer(RandomBuffer *buffer) {
+      rng.setBuffer(buffer);
+    }
+
 /**
    \brief switch off
 */     
@@ -1188,9 +2253,9 @@ class Flicker : public LedBase<T> {
       if (LedBase<T>::state == 1) {                                     // flicker in low wind
         if (currentMillis - previousMillis > interval) {
           //uint8_t value = (25 - random(22)) * 10 + 5;
-          int value = (random(maxBrightness) / 10) * 10 + 5;
+          int value = (rng.random(maxBrightness) / 10) * 10 + 5;
           LedBase<T>::obj.pwmWrite(value);
-          interval = random(20, 150);
+          interval = rng.random(20, 150);
           previousMillis = currentMillis;
         }
       }
@@ -1211,9 +2276,12 @@ class Fluorescent : public LedBase<T> {
     //uint8_t state = 1;                  // 0 OFF, 1 START, 2 RUNNING, 3 FULL
     uint16_t interval  = 10;           // how fast should the led be dimmed (=milliseconds between steps)
     uint16_t intervalEffect = 10;      // an interval for the flicker effect
-    uint8_t actual = 0;                // actual PWM
+    using Level = OutputLevel<T>;
+    uint16_t actual = 0;               // actual level in native resolution
+    uint8_t stepFraction = 0;          // sub ms part of previousMillis for outputs with more than 8 bit
     uint16_t startTimeMin = 500;       // how long will it take from off to stable on; "lower" faster
     uint16_t startTimeMax = 5000;
+    FastRandom rng;                    // random values for the start flashes
 
   public:
 /**
@@ -1222,6 +2290,25 @@ class Fluorescent : public LedBase<T> {
    \param obj the pin to connect
 */
     Fluorescent(T &obj) : LedBase<T>(obj) {}
+
+/**
+   \brief seed the random generator
+   
+   The same seed gives the same start sequence.
+   \param seed the new seed
+*/
+    void setSeed(uint32_t seed) {
+      rng.setSeed(seed);
+    }
+    
+/**
+   \brief use a pre-generated buffer of random values
+   
+   \param buffer a RandomPool, one pool per effect, it has a single consumer
+*/
+    void setRandomBuffer(RandomBuffer *buffer) {
+      rng.setBuffer(buffer);
+    }
     
 /**
    \brief get the current brightness
@@ -1230,7 +2317,7 @@ class Fluorescent : public LedBase<T> {
    @return the current brigthness
 */    
     uint16_t getCurrentBrightness() {
-      return actual;
+      return Level::to8(actual);
     }
 
 /**
@@ -1240,9 +2327,9 @@ class Fluorescent : public LedBase<T> {
       uint8_t previousState = LedBase<T>::state;
       LedBase<T>::state = 1;                     // State::START;
       previousMillis = millis();
-      LedBase<T>::obj.pwmWrite(2);               // "glimm" after start
-      intervalEffect = random(50, 500);          // modify the first interval
-      interval = random(startTimeMin, startTimeMax);
+      OutputTraits<T>::levelWrite(LedBase<T>::obj, Level::from8(2));  // "glimm" after start
+      intervalEffect = rng.random(50, 500);          // modify the first interval
+      interval = rng.random(startTimeMin, startTimeMax);
       if (LedBase<T>::cbStateChange && previousState != LedBase<T>::state) LedBase<T>::cbStateChange(LedBase<T>::state);
     }
 
@@ -1253,7 +2340,7 @@ class Fluorescent : public LedBase<T> {
       uint8_t previousState = LedBase<T>::state;
       LedBase<T>::state = 0;                     // State::OFF;
       actual = 0;
-      LedBase<T>::obj.pwmWrite(0);
+      OutputTraits<T>::levelWrite(LedBase<T>::obj, 0);
       if (LedBase<T>::cbStateChange && previousState != LedBase<T>::state) LedBase<T>::cbStateChange(LedBase<T>::state);
     }
     
@@ -1283,21 +2370,21 @@ class Fluorescent : public LedBase<T> {
     void update(uint32_t currentMillis = millis()) {
       if (LedBase<T>::state == 1) {
         if (currentMillis - previousMillisEffect > intervalEffect) {
-          if (actual >= 200) {                   // alles ab diesem Wert ist "ein" daher müssen wir nun "aus" Schalten
-            actual = random(0, 5);               // Ein leichtes Glimmen der "Enden" ... könnte man auch ganz auf 0 setzen
-            intervalEffect = random(400, 2000);  // unregeläßige Dunkelphasen (zwischen dem Aufblitzen)
+          if (actual >= Level::from8(200)) {     // alles ab diesem Wert ist "ein" daher müssen wir nun "aus" Schalten
+            actual = Level::from8(rng.random(0, 5));       // Ein leichtes Glimmen der "Enden" ... könnte man auch ganz auf 0 setzen
+            intervalEffect = rng.random(400, 2000);  // unregeläßige Dunkelphasen (zwischen dem Aufblitzen)
           }
           else {
-            actual = random(200, 255);
-            intervalEffect = random(20, 40);     // flash shortly
+            actual = Level::from8(rng.random(200, 255));
+            intervalEffect = rng.random(20, 40);     // flash shortly
           }
-          LedBase<T>::obj.pwmWrite(actual);
+          OutputTraits<T>::levelWrite(LedBase<T>::obj, actual);
           previousMillisEffect = currentMillis;
         }
         if (currentMillis - previousMillis > interval) {
-          actual = 200;      // after the tube is stable "on" it will take some time to reach 100%
+          actual = Level::from8(200);  // after the tube is stable "on" it will take some time to reach 100%
           interval = 100;    // we need 55 steps to get full 255 PWM = aprox 55 Seconds till the tube has full brightness
-          LedBase<T>::obj.pwmWrite(actual);
+          OutputTraits<T>::levelWrite(LedBase<T>::obj, actual);
           previousMillis = currentMillis;
           LedBase<T>::state = 2;
           if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);
@@ -1305,11 +2392,11 @@ class Fluorescent : public LedBase<T> {
       }
       if (LedBase<T>::state == 2) {
         uint32_t currentMillis = millis();
-        if (currentMillis - previousMillis >= interval) {
-          previousMillis = currentMillis;
-          actual++;
-          LedBase<T>::obj.pwmWrite(actual);
-          if (actual >= 255)
+        uint16_t steps = Level::steps(previousMillis, stepFraction, currentMillis, interval);
+        if (steps) {
+          actual = (Level::max - actual > steps) ? actual + steps : Level::max;
+          OutputTraits<T>::levelWrite(LedBase<T>::obj, actual);
+          if (actual >= Level::max)
           {
             LedBase<T>::state = 3;
             if (LedBase<T>::cbStateChange) LedBase<T>::cbStateChange(LedBase<T>::state);
@@ -1323,16 +2410,108 @@ class Fluorescent : public LedBase<T> {
    \brief heart beat - dims up and down permanentely
    
    The output will dimm up and down. You can define threashold for min and max dim level. 
+   If the output can fade in hardware (OutputTraits), the ramps run there.
+   The steps are done in the native resolution of the output (OutputLevel).
 */
 template<class T>
 class Heartbeat : public LedBase<T> {
   protected :
+    using Level = OutputLevel<T>;
     //uint8_t state = 1; 
     uint8_t interval = 25;
     uint32_t previousMillis = millis();// time management
-    uint8_t pwm = 0;                   // the current brightness
-    uint8_t start = 0;                 // minimum brightness
-    uint8_t end =  255;                // maximum brigthness
+    uint16_t pwm = 0;                  // the current level
+    uint16_t start = 0;                // minimum level
+    uint16_t end = Level::max;         // maximum level
+    uint32_t fadeDuration = 0;         // running hardware fade, 0 if none
+    bool synced = false;               // the output shows pwm (hardware fade only)
+    bool pending = false;              // write off at the end of the running hardware fade
+    bool gamma = false;                // write gamma corrected levels
+    uint8_t stepFraction = 0;          // sub ms part of previousMillis for outputs with more than 8 bit
+
+    void write(uint16_t level) {
+      OutputTraits<T>::levelWrite(LedBase<T>::obj, gamma ? Level::gamma(level) : level);
+    }
+
+/*
+   software fade: two levels per step, one 8 bit step per interval, odd values go upwards
+*/
+    void update(uint32_t currentMillis, BoolTag<false>) {
+      if (LedBase<T>::state != 1) return;
+      uint16_t steps = Level::steps(previousMillis, stepFraction, currentMillis, interval + 1UL);
+      if (steps == 0) return;
+      while (steps--) {
+        if (pwm % 2) {                           // odd - going upwards
+          if (pwm < end - 1 ) pwm = pwm + 2;
+          else pwm = pwm - 1;                    // turn direction to downwards
+        }
+        else {                                   // even - goint downwards
+          if (pwm > start) pwm = pwm - 2;
+          else pwm = pwm + 1;                    // turn direction to upwards
+        }
+      }
+      write(pwm);
+    }
+
+/*
+   hardware fade: one call per ramp (or segment), same speed and same 
+   odd/even direction as the software steps
+*/
+    void update(uint32_t currentMillis, BoolTag<true>) {
+      if (fadeDuration) {
+        if (currentMillis - previousMillis < fadeDuration) return;
+        fadeDuration = 0;
+        if (pending) {
+          pending = false;
+          if (LedBase<T>::state != 1) OutputTraits<T>::levelWrite(LedBase<T>::obj, 0);
+        }
+        if (LedBase<T>::state != 1) return;
+      }
+      else if (LedBase<T>::state != 1 || currentMillis - previousMillis <= interval) return;
+      if (gamma) {                               // the hardware fades linear
+        update(currentMillis, BoolTag<false>());
+        return;
+      }
+      if (!synced) {
+        write(pwm);                              // fades start from the current hardware level
+        synced = true;
+      }
+      uint16_t maxSteps = NOIASCA_FADE_SEGMENT / (interval + 1UL);
+      if (maxSteps == 0) maxSteps = 1;
+      int16_t target;
+      uint16_t next;
+      if (pwm % 2) {                             // odd - going upwards
+        target = pwm + 2 * maxSteps;
+        if (target >= end) {
+          target = end;
+          next = end & ~1;                       // turn direction to downwards
+        }
+        else next = target;
+      }
+      else {                                     // even - going downwards
+        target = pwm - 2 * maxSteps;
+        if (target <= start) {
+          target = start;
+          next = start | 1;                      // turn direction to upwards
+        }
+        else next = target;
+      }
+      uint16_t distance = (target > pwm) ? target - pwm : pwm - target;
+      uint32_t duration = (distance + 1) / 2 * (interval + 1UL);
+      previousMillis = currentMillis;
+      if (distance == 0) {
+        pwm = next;                              // already at the turning point
+      }
+      else if (LedBase<T>::obj.fadeTo(target, duration)) {
+        pwm = next;
+        fadeDuration = duration;
+      }
+      else {
+        synced = false;
+        previousMillis = currentMillis - interval - 1;
+        update(currentMillis, BoolTag<false>());  // this output can't fade now
+      }
+    }
 
   public :
 /**
@@ -1351,9 +2530,18 @@ class Heartbeat : public LedBase<T> {
    \brief get the current brightness
    
    The current brightness/level of this output
-   @return the current brigthness
+   @return the current brigthness [0..255]
 */    
     uint16_t getCurrentBrightness() {
+      return Level::to8(pwm);
+    }    
+
+/**
+   \brief get the current level
+   
+   @return the current level in native resolution [0..OutputLevel::max]
+*/    
+    uint16_t getCurrentLevel() {
       return pwm;
     }    
 
@@ -1364,7 +2552,8 @@ class Heartbeat : public LedBase<T> {
    @param brightness the new current brigthness
 */    
     void setCurrentBrightness(uint8_t brightness) {
-      pwm = brightness;
+      pwm = Level::from8(brightness);
+      synced = false;
     }  
 
     
@@ -1375,8 +2564,8 @@ class Heartbeat : public LedBase<T> {
    \param maxBrightness the maximum brigthness (upper end of range) [0..255]
 */
     void setMaxBrightness( uint8_t maxBrightness) {
-      if (maxBrightness > start) {
-        end = maxBrightness;
+      if (Level::from8(maxBrightness) > start) {
+        end = Level::from8(maxBrightness);
       }
     }
     
@@ -1387,10 +2576,20 @@ class Heartbeat : public LedBase<T> {
    \param minBrightness the minium brigthness (lower end of range) [0..255]
 */    
     void setMinBrightness( uint8_t minBrightness) {
-      if (minBrightness < end) {
-        start = minBrightness;
+      if (Level::from8(minBrightness) < end) {
+        start = Level::from8(minBrightness);
       }
     }
+
+/**
+   \brief use gamma corrected levels
+   
+   The heart beat looks more even to the eye. Hardware fades are not used with gamma.
+   \param active true to activate gamma correction
+*/
+    void setGamma(bool active) {
+      gamma = active;
+    }
     
     // here we need to take care, that these on/off are used.
 /**
@@ -1399,6 +2598,7 @@ class Heartbeat : public LedBase<T> {
     void on() override {
       uint8_t previousState = LedBase<T>::state;
       pwm = start;
+      synced = false;
       LedBase<T>::state = 1;
       if (LedBase<T>::cbStateChange && previousState != LedBase<T>::state) LedBase<T>::cbStateChange(LedBase<T>::state);
     }
@@ -1408,7 +2608,13 @@ class Heartbeat : public LedBase<T> {
 */     
     void off() override {
       uint8_t previousState = LedBase<T>::state;
-      LedBase<T>::obj.pwmWrite(0);
+      if (fadeDuration && millis() - previousMillis < fadeDuration) {
+        pending = true;      // a write would wait for the running segment, update() writes at its end
+      }
+      else {
+        OutputTraits<T>::levelWrite(LedBase<T>::obj, 0);
+        fadeDuration = 0;
+      }
       pwm = start;           // if configured as "allways dimmed on" we have to set the start value
       LedBase<T>::state = 0;
       if (LedBase<T>::cbStateChange && previousState != LedBase<T>::state) LedBase<T>::cbStateChange(LedBase<T>::state);
@@ -1438,18 +2644,7 @@ class Heartbeat : public LedBase<T> {
    \param currentMillis you can handover a millis timestamp
 */ 
     void update(uint32_t currentMillis = millis()) {
-      if (currentMillis - previousMillis > interval && LedBase<T>::state == 1) {
-        previousMillis = currentMillis;
-        if (pwm % 2) {                           // odd - going upwards
-          if (pwm < end - 1 ) pwm = pwm + 2;
-          else pwm = pwm - 1;                    // turn direction to downwards
-        }
-        else {                                   // even - goint downwards
-          if (pwm > start) pwm = pwm - 2;
-          else pwm = pwm + 1;                    // turn direction to upwards
-        }
-        LedBase<T>::obj.pwmWrite(pwm);
-      }
+      update(currentMillis, BoolTag<OutputTraits<T>::hardwareFade>());
     }
 };
 
@@ -1782,16 +2977,110 @@ class Rhythm : public LedBase<T> {
    \brief dim up / down a LED dimms smoothly
    
    @note use a PWM pin for a nice effect  
+   @note if the output can fade in hardware (OutputTraits), the fade runs there
+   @note the steps are done in the native resolution of the output (OutputLevel)
 */
 template<class T>
 class Smooth : public LedBase<T> {
   protected:
+    using Level = OutputLevel<T>;
     //uint8_t state = 1;               // state = 0 off or decrease, 1 on or still increasing
     uint32_t previousMillis = millis();// last timestamp
-    uint16_t currentBrightness = 0;    // actual brightness of Pin
-    uint16_t maxBrightness = 255;      // native PWM on Arduino is only 8 bit. But could be used for other processors also.
-    uint8_t onInterval = 25;           // delay for each step upwards
-    uint8_t offInterval = 15;          // delay for each step downwards
+    uint16_t currentBrightness = 0;    // actual level of Pin
+    uint16_t maxBrightness = Level::max;         // native PWM on Arduino is only 8 bit, 12 bit on a PCA9685
+    uint8_t onInterval = 25;           // delay for each 8 bit step upwards
+    uint8_t offInterval = 15;          // delay for each 8 bit step downwards
+    uint32_t fadeDuration = 0;         // running hardware fade, 0 if none
+    uint16_t fadeFrom = 0;             // level at the start of the hardware fade
+    bool pending = false;              // write currentBrightness at the end of the running hardware fade
+    bool gamma = false;                // write gamma corrected levels
+    uint8_t stepFraction = 0;          // sub ms part of previousMillis for outputs with more than 8 bit
+
+    void write(uint16_t level) {
+      OutputTraits<T>::levelWrite(LedBase<T>::obj, gamma ? Level::gamma(level) : level);
+    }
+
+/*
+   write currentBrightness now, or at the end of a running hardware fade 
+   as a write would wait for it
+*/
+    void writeLevel() {
+      if (fadeDuration && millis() - previousMillis < fadeDuration) {
+        pending = true;
+        return;
+      }
+      fadeDuration = 0;
+      pending = false;
+      write(currentBrightness);
+    }
+
+/*
+   software fade: one 8 bit step per interval
+*/
+    void update(uint32_t currentMillis, BoolTag<false>) {
+      uint16_t steps;
+      if (LedBase<T>::state == 1 && currentBrightness < maxBrightness && (steps = Level::steps(previousMillis, stepFraction, currentMillis, onInterval + 1UL))) {
+        currentBrightness = (maxBrightness - currentBrightness > steps) ? currentBrightness + steps : maxBrightness;
+        write(currentBrightness);
+      }
+      else if (LedBase<T>::state == 1 && currentBrightness > maxBrightness && (steps = Level::steps(previousMillis, stepFraction, currentMillis, offInterval + 1UL))) {
+        currentBrightness = (currentBrightness - maxBrightness > steps) ? currentBrightness - steps : maxBrightness;
+        write(currentBrightness);
+      }
+      else if (LedBase<T>::state == 0 && currentBrightness > 0 && (steps = Level::steps(previousMillis, stepFraction, currentMillis, offInterval + 1UL))) {
+        currentBrightness = (currentBrightness > steps) ? currentBrightness - steps : 0;
+        write(currentBrightness);
+      }
+    }
+
+/*
+   hardware fade: one call per segment, same speed as the software steps
+*/
+    void update(uint32_t currentMillis, BoolTag<true>) {
+      if (fadeDuration) {
+        if (currentMillis - previousMillis < fadeDuration) return;
+        fadeDuration = 0;                        // segment done, currentBrightness is its target
+        if (pending) {
+          pending = false;
+          write(currentBrightness);
+        }
+      }
+      uint16_t target;
+      uint8_t interval;
+      if (LedBase<T>::state == 1 && currentBrightness < maxBrightness) {
+        target = maxBrightness;
+        interval = onInterval;
+      }
+      else if (LedBase<T>::state == 1 && currentBrightness > maxBrightness) {
+        target = maxBrightness;
+        interval = offInterval;
+      }
+      else if (LedBase<T>::state == 0 && currentBrightness > 0) {
+        target = 0;
+        interval = offInterval;
+      }
+      else return;
+      if (gamma) {                               // the hardware fades linear
+        update(currentMillis, BoolTag<false>());
+        return;
+      }
+      uint32_t steps = (target > currentBrightness) ? target - currentBrightness : currentBrightness - target;
+      uint32_t maxSteps = NOIASCA_FADE_SEGMENT / (interval + 1UL);
+      if (maxSteps == 0) maxSteps = 1;
+      if (steps > maxSteps) {
+        steps = maxSteps;
+        target = (target > currentBrightness) ? currentBrightness + steps : currentBrightness - steps;
+      }
+      if (LedBase<T>::obj.fadeTo(target, steps * (interval + 1UL))) {
+        fadeFrom = currentBrightness;
+        fadeDuration = steps * (interval + 1UL);
+        currentBrightness = target;
+        previousMillis = currentMillis;
+      }
+      else {
+        update(currentMillis, BoolTag<false>());  // this output can't fade now
+      }
+    }
 
   public:
 /**
@@ -1811,38 +3100,74 @@ class Smooth : public LedBase<T> {
       uint8_t previousState = LedBase<T>::state;           // remember current state
       LedBase<T>::state = 0;
       currentBrightness = 0; 
-      LedBase<T>::obj.pwmWrite(currentBrightness);
+      writeLevel();
       if (LedBase<T>::cbStateChange && previousState != LedBase<T>::state) LedBase<T>::cbStateChange(LedBase<T>::state);
     }  
     
+/**
+   \brief get the current level
+   
+   The current level of this output in native resolution
+   @return the current level 0..OutputLevel::max
+*/    
+    uint16_t getCurrentLevel() {
+      if (fadeDuration && !pending) {            // somewhere within the running hardware fade
+        uint32_t passed = millis() - previousMillis;
+        if (passed < fadeDuration) return fadeFrom + ((int32_t)currentBrightness - fadeFrom) * (int32_t)passed / (int32_t)fadeDuration;
+      }
+      return currentBrightness;
+    }
+    
 /**
    \brief get the current brightness
    
    The current brightness/level of this output
-   @return the current brigthness
+   @return the current brigthness [0..255]
 */    
     uint16_t getCurrentBrightness() {
-      return currentBrightness;
+      return Level::to8(getCurrentLevel());
     }
     
 /**
    \brief set the current brightness
    
    The current brightness/level of this output
+   \param brightness the new brightness [0..255]
 */    
     void getCurrentBrightness(uint16_t brightness) {
-      currentBrightness = brightness;
-      LedBase<T>::obj.pwmWrite(currentBrightness);
+      if (brightness > 255) brightness = 255;
+      currentBrightness = Level::from8(brightness);
+      writeLevel();
     }
 
 /**
    \brief set the maximum brightness
    
    The output will dimm up to this maximum level.
-   \param newValue the maximum brigthness (upper end of range) [on UNO 0..255]
+   \param newValue the maximum brigthness (upper end of range) [0..255]
 */
     void setMaxBrightness(uint16_t newValue) {
-      maxBrightness = newValue;
+      if (newValue > 255) newValue = 255;
+      maxBrightness = Level::from8(newValue);
+    }
+
+/**
+   \brief set the maximum level in native resolution
+   
+   \param newValue the maximum level [0..OutputLevel::max]
+*/
+    void setMaxLevel(uint16_t newValue) {
+      maxBrightness = (newValue > Level::max) ? Level::max : newValue;
+    }
+
+/**
+   \brief use gamma corrected levels
+   
+   The ramp looks more even to the eye. Hardware fades are not used with gamma.
+   \param active true to activate gamma correction
+*/
+    void setGamma(bool active) {
+      gamma = active;
     }
 
     void setOffInterval(uint8_t newValue) {
@@ -1870,24 +3195,24 @@ class Smooth : public LedBase<T> {
    \param currentMillis you can handover a millis timestamp
 */     
     void update(uint32_t currentMillis = millis()) {
-      if (LedBase<T>::state == 1 && currentBrightness < maxBrightness && currentMillis - previousMillis > onInterval) {
-        currentBrightness++;    
-        LedBase<T>::obj.pwmWrite(currentBrightness);
-        previousMillis = currentMillis;
-      }
-      else if (LedBase<T>::state == 1 && currentBrightness > maxBrightness && currentMillis - previousMillis > offInterval) {
-        currentBrightness--;
-        LedBase<T>::obj.pwmWrite(currentBrightness);
-        previousMillis = currentMillis;
-      }
-      else if (LedBase<T>::state == 0 && currentBrightness > 0 && currentMillis - previousMillis > offInterval) {
-        currentBrightness--;
-        LedBase<T>::obj.pwmWrite(currentBrightness);
-        previousMillis = currentMillis;
-      }
+      update(currentMillis, BoolTag<OutputTraits<T>::hardwareFade>());
     }
 };
 
+/*
+   the faces of a traffic light as steps, index is Trafficlight::State
+   red is output 0, yellow output 1, green output 2
+*/
+const SequenceStep sequenceTrafficlightFace[] PROGMEM = {
+  {0b000, 0,     0, 0},                          // OFF
+  {0b001, 0,     0, 0},                          // RED
+  {0b011, 0,     0, 0},                          // REDYELLOW
+  {0b100, 0,     0, 0},                          // GREEN
+  {0b010, 0,     0, 0},                          // YELLOW
+  {0b000, 0b010, 0, 0},                          // YELLOWBLINK
+  {0b000, 0b100, 0, 0}                           // GREENBLINK
+};
+
 /**
    \brief traffic light
    
@@ -1895,72 +3220,60 @@ class Smooth : public LedBase<T> {
    
    mode  // 0 manual // 1 automatic   // 2 redgreenonly / 3 automaticAT
    
-   interval as array
-   sequence (order, interval)  
+   A Sequencer with the sequence in RAM, so it can be modified during runtime.
    doesn't inherit from LedBase   
 */
 // notepad++ don't close this class
 template<class T>
-class Trafficlight {
+class Trafficlight : public Sequencer<T, 3> {
+    using Base = Sequencer<T, 3>;
   protected:
-    T &obj;                                      // needs an object with 3 (or 2) LEDs
-    uint32_t previousMillis = millis();          // last state timestamp
-    uint32_t previousMillisBlink = millis();     // last blink timestamp
-    uint16_t onInterval = 500;                   // milliseconds on time for the first LED = off time for the second LED
-    uint8_t currentBlink = 0;                    // current position in pattern (on or off)
-    uint8_t currentSequence = 0;
-    uint8_t state = 5;
+    uint8_t face = State::YELLOWBLINK;           // the state which is shown
     uint8_t mode = Mode::AUTOMATIC;
-    using Callback = void (*)(uint8_t value);
-    Callback cbStateChange, cbSequenceChange;
-    struct Sequence {
-      uint8_t state;
-      uint16_t interval;
-    } sequence[8];
+    typename Base::Callback cbStateChange = nullptr, cbSequenceChange = nullptr;
+    SequenceStep sequence[8];                    // the program in RAM
+    uint8_t sequenceState[8];                    // the state of each step in the program
     uint8_t noOfSequence = 4;
 
+    static SequenceStep faceStep(uint8_t newState, uint16_t interval) {
+      SequenceStep result;
+      memcpy_P(&result, &sequenceTrafficlightFace[newState], sizeof(result));
+      result.interval = interval;
+      return result;
+    }
+
   public:
 /**
    \brief constructor for a traffic light
    
    \param obj a object with 3 lamps 
 */
-    Trafficlight(T &obj) : obj(obj) {
-      sequence[0].state = State::RED;
-      sequence[0].interval = 5000;
-      sequence[1].state = State::REDYELLOW;
-      sequence[1].interval = 3000;
-      sequence[2].state = State::GREEN;
-      sequence[2].interval = 2500;
-      sequence[3].state = State::YELLOW;
-      sequence[3].interval = 3000;
-      //sequence[3].state = State::GREENBLINK;
-      //sequence[3].interval = 2500;
+    Trafficlight(T &obj) : Base(obj) {
+      setSequenceIndex(0, State::RED, 5000);
+      setSequenceIndex(1, State::REDYELLOW, 3000);
+      setSequenceIndex(2, State::GREEN, 2500);
+      setSequenceIndex(3, State::YELLOW, 3000);
+      //setSequenceIndex(3, State::GREENBLINK, 2500);
+      Base::setProgram(sequence, noOfSequence, false);
+      // blink yellow for the time of the first sequence, then continue with the second one
+      Base::current = 0;
+      Base::interval = sequence[0].interval;
+      Base::step = faceStep(State::YELLOWBLINK, Base::interval);
     }
     
     // the faces of the traffic light
     //          0   1     2          3       4       5             6
     enum State{OFF, RED, REDYELLOW, GREEN, YELLOW, YELLOWBLINK, GREENBLINK};
     enum Mode{MANUAL, AUTOMATIC, /*REDGREEN, AUTOMATIC_AT */}; 
-    
-/**
-   \brief start hardware
-   
-   Will do the necessary steps to initialize the hardware pins.
-   Call this function in your setup().
-*/
-    void begin() {
-      obj.begin();
-    }
 
 /**
    \brief set on times 
    
-   Set the on interval.
+   Set the blink interval.
    \param _on the on interval 
 */    
     void setInterval(uint16_t _on) { // modify Blink interval on/off times during runtime
-      onInterval = _on;
+      Base::setBlinkInterval(_on);
     }
 
 /** 
@@ -1976,9 +3289,9 @@ class Trafficlight {
 */
     int setSequenceIndex(uint8_t index, uint8_t newState, uint16_t newInterval) {
       constexpr size_t maxSequence = sizeof(sequence)/sizeof(sequence[0]);
-      if (index < maxSequence) {
-        sequence[index].state = newState;
-        sequence[index].interval = newInterval;
+      if (index < maxSequence && newState <= State::GREENBLINK) {
+        sequence[index] = faceStep(newState, newInterval);
+        sequenceState[index] = newState;
         return 0;  // success
       }
       return 1;    // error
@@ -1994,16 +3307,16 @@ class Trafficlight {
       constexpr size_t maxSequence = sizeof(sequence) / sizeof(sequence[0]);
       if (newMax <= maxSequence && newMax > 0) {
         noOfSequence = newMax;
+        Base::length = newMax;
+        if (Base::current >= newMax) Base::current = newMax - 1;
         return 0;  // success
       }
       return 1;    // error
     }
     
     void off() {
-      state = 0;
-      obj.digWrite(0, LOW);
-      obj.digWrite(1, LOW);
-      obj.digWrite(2, LOW);
+      face = State::OFF;
+      Base::enter(faceStep(State::OFF, 0));
     }
 
 /** 
@@ -2014,6 +3327,7 @@ class Trafficlight {
 */     
     void setMode(Mode newMode) {
        mode = newMode;    
+       Base::setHold(mode == Mode::MANUAL);
     }
 
 /** 
@@ -2024,7 +3338,7 @@ class Trafficlight {
     @todo clearify usage of this vs onSequnceChange
 */ 
   
-    void setOnStateChange(Callback funcPtr) {
+    void setOnStateChange(typename Base::Callback funcPtr) {
       (*this).cbStateChange = funcPtr;
     }
 
@@ -2035,7 +3349,7 @@ class Trafficlight {
     For example to keep another traffic light in sync, like a pedestrain trafficlight or the crossing line.
     \param funcPtr the callback function
 */   
-    void setOnSequenceChange(Callback funcPtr) {
+    void setOnSequenceChange(typename Base::Callback funcPtr) {
       (*this).cbSequenceChange = funcPtr;
     }
 
@@ -2046,7 +3360,7 @@ class Trafficlight {
     \param _on the color code in HEX
 */ 
     void setOnColor(uint16_t actual, uint32_t _on) {
-      obj.setOnColor(actual, _on);
+      Base::obj.setOnColor(actual, _on);
     }
 
 /** 
@@ -2055,45 +3369,20 @@ class Trafficlight {
     \param _off the color code in HEX
 */    
     void setOffColor(uint32_t _off) {
-      obj.setOffColor(_off);
+      Base::obj.setOffColor(_off);
     }    
     
 /** 
     \brief set the state of the traffic light
 
+    The automatic mode will continue with the next sequence in time.
     \param newState the new state 
 */     
     void setState(uint8_t newState) {
-      //Serial.print(F("newState=")); Serial.println(newState);
-      switch(newState) {
-        case State::OFF :
-          obj.digWrite(0, LOW);
-          obj.digWrite(1, LOW);
-          obj.digWrite(2, LOW);
-        break;
-        case State::RED :
-          obj.digWrite(0, HIGH);
-          obj.digWrite(1, LOW);
-          obj.digWrite(2, LOW);
-        break; 
-        case State::YELLOW :
-          obj.digWrite(0, LOW);
-          obj.digWrite(1, HIGH);
-          obj.digWrite(2, LOW);
-        break;
-        case State::REDYELLOW :
-          obj.digWrite(0, HIGH);
-          obj.digWrite(1, HIGH);
-          obj.digWrite(2, LOW);
-        break;       
-        case State::GREEN :
-          obj.digWrite(0, LOW);
-          obj.digWrite(1, LOW);
-          obj.digWrite(2, HIGH);
-        break;  
-      }
-      if(cbStateChange && state != newState) cbStateChange(newState);
-      state = newState;
+      if (newState > State::GREENBLINK) return;
+      Base::enter(faceStep(newState, Base::interval));
+      if (cbStateChange && face != newState) cbStateChange(newState);
+      face = newState;
     }   
     
     void green() {
@@ -2116,16 +3405,6 @@ class Trafficlight {
       setState(State::YELLOWBLINK);
     }
 
-/*
-   \brief check if update is necessary
-   
-   This is the "run" function. Call this function in loop() to make the effect visible.
-   This function uses by default the actual millis() to determine, if an action is necessary.
-*/     
-//    void update() {
-//      update(millis());
-//    }
-    
 /**
    \brief check if update is necessary
    
@@ -2133,60 +3412,36 @@ class Trafficlight {
    \param currentMillis you can handover a millis timestamp
 */     
     void update(uint32_t currentMillis = millis()) {
-      if (mode != Mode::MANUAL) {
-        if (currentMillis - previousMillis >= sequence[currentSequence].interval) {
-          previousMillis = currentMillis;
-          currentSequence++;
-          if (currentSequence >= noOfSequence) currentSequence = 0;
-          if(cbSequenceChange) cbSequenceChange(currentSequence);
-          setState(sequence[currentSequence].state);
-        }
-      }
-      if (state == State::GREENBLINK) {
-        if (currentMillis - previousMillisBlink >= onInterval) {
-          previousMillisBlink = currentMillis;
-          if (currentBlink) {
-            obj.digWrite(2, LOW);
-            currentBlink  = 0;
-          }
-          else {
-            obj.digWrite(2, HIGH);
-            currentBlink  = 1;
-          }
-        }
-      }
-      if (state == State::YELLOWBLINK) {
-        if (currentMillis - previousMillisBlink >= onInterval) {
-          previousMillisBlink = currentMillis;
-          if (currentBlink) {
-            obj.digWrite(1, LOW);
-            currentBlink  = 0;
-          }
-          else {
-            obj.digWrite(1, HIGH);
-            currentBlink  = 1;
-          }
-        }
+      if (Base::tick(currentMillis)) {
+        if (cbSequenceChange) cbSequenceChange(Base::current);
+        uint8_t newState = sequenceState[Base::current];
+        if (cbStateChange && face != newState) cbStateChange(newState);
+        face = newState;
       }
     }
 };
 
+/*
+   the steps of Turnsignal for left, right and hazard
+*/
+const SequenceStep sequenceTurnsignal[3][2] PROGMEM = {
+  {{0b001, 0, 0, SEQUENCE_SLOT + 0}, {0, 0, 0, SEQUENCE_SLOT + 1}},
+  {{0b010, 0, 0, SEQUENCE_SLOT + 0}, {0, 0, 0, SEQUENCE_SLOT + 1}},
+  {{0b111, 0, 0, SEQUENCE_SLOT + 0}, {0, 0, 0, SEQUENCE_SLOT + 1}}
+};
+
 /**
     \brief turnsignals for a car
     
     this class needs 3 LEDs (left, right and a hazard warning light in the dashboard).
+    A Sequencer with one program for each state.
 */
 template <class T>
-class Turnsignal {
+class Turnsignal : public Sequencer<T, 3> {
+    using Base = Sequencer<T, 3>;
   protected:
-    uint32_t previousMillis = millis();// last blink timestamp
-    uint16_t onInterval = 500;         // milliseconds on time for the first LED = off time for the second LED
-    uint16_t offInterval = 500;        // milliseconds off time for the first LED = on time for the secon LED
-    uint8_t current = 0;               // current position in pattern (on or off)
-    uint8_t state = 1;                 // 0 OFF, 1 LEFT, 2 RIGHT, 3 HAZARD
-    T &obj;
-    using Callback = void (*)(uint8_t value);
-    Callback cbStateChange;
+    uint8_t turn = 1;                  // 0 OFF, 1 LEFT, 2 RIGHT, 3 HAZARD
+    typename Base::Callback cbStateChange = nullptr;
   public:
 /**
    \brief car Turn signal
@@ -2196,17 +3451,7 @@ class Turnsignal {
    
    \param obj a object with 2 or 3 LEDs for turning signals
 */  
-    Turnsignal(T &obj) : obj(obj) {}
-    
-/**
-   \brief start hardware
-   
-   Will do the necessary steps to initialize the hardware pins.
-   Call this function in your setup().
-*/
-    void begin() {
-      obj.begin();
-    }
+    Turnsignal(T &obj) : Base(obj, sequenceTurnsignal[0], 2) {}
     
 /**
    \brief set on/off times 
@@ -2216,8 +3461,8 @@ class Turnsignal {
    \param _off the off interval
 */   
     void setInterval(uint16_t _on, uint16_t _off) { // modify on/off times during runtime
-      onInterval = _on;
-      offInterval = _off;
+      Base::setSlotInterval(0, _on);
+      Base::setSlotInterval(1, _off);
     }
 
 /**
@@ -2228,27 +3473,28 @@ class Turnsignal {
    \param _on the on color
 */    
     void setOnColor(uint16_t actual, uint32_t _on) {
-      obj.setOnColor(actual, _on);
+      Base::obj.setOnColor(actual, _on);
     }
     
     void setOffColor(uint32_t _off) {
-      obj.setOffColor(_off);
+      Base::obj.setOffColor(_off);
     }
     
     void off() {
-      uint8_t previousState = state;
-      state = 0;
-      obj.digWrite(0, LOW);
-      obj.digWrite(1, LOW);
-      obj.digWrite(2, LOW);
-      if (cbStateChange && previousState != state) cbStateChange(state);
+      uint8_t previousState = turn;
+      turn = 0;
+      Base::off();
+      if (cbStateChange && previousState != turn) cbStateChange(turn);
     }
     
     void setState(uint8_t newState) {
-      if (newState != state) off();
-      state = newState;
-      previousMillis = millis() - (onInterval + offInterval);
-      current = 0;
+      if (newState == 0 || newState > 3) {
+        off();
+        return;
+      }
+      turn = newState;
+      Base::setProgram(sequenceTurnsignal[newState - 1], 2);
+      Base::on();
       // the user should know, that he has called setState ... so no callback
     }
 
@@ -2258,9 +3504,9 @@ class Turnsignal {
    Turn on the left signal.
 */    
     void left() {
-      uint8_t previousState = state;
+      uint8_t previousState = turn;
       setState(1);
-      if (cbStateChange && previousState != state) cbStateChange(state);
+      if (cbStateChange && previousState != turn) cbStateChange(turn);
     }
 
 /**
@@ -2269,9 +3515,9 @@ class Turnsignal {
    Turn on the right signal.
 */     
     void right() {
-      uint8_t previousState = state;
+      uint8_t previousState = turn;
       setState(2);
-      if (cbStateChange && previousState != state) cbStateChange(state);
+      if (cbStateChange && previousState != turn) cbStateChange(turn);
     }
 
 /**
@@ -2280,9 +3526,9 @@ class Turnsignal {
    will activate left and right turning signal and the hazarad light in the dashboard (if defined).
 */ 
     void hazard() {
-      uint8_t previousState = state;
+      uint8_t previousState = turn;
       setState(3);
-      if (cbStateChange && previousState != state) cbStateChange(state);
+      if (cbStateChange && previousState != turn) cbStateChange(turn);
     }
 
 /** 
@@ -2291,54 +3537,9 @@ class Turnsignal {
     a callback function receives state changes from the effect 
     \param funcPtr the callback function
 */ 
-    void setOnStateChange(Callback funcPtr) {
+    void setOnStateChange(typename Base::Callback funcPtr) {
       cbStateChange = funcPtr;
     }    
-
-/*
-   \brief check if update is necessary
-   
-   This is the "run" function. Call this function in loop() to make the effect visible.
-   This function uses by default the actual millis() to determine, if an action is necessary.
-*/     
-//    void update() {
-//      update(millis());
-//    }
-    
-/**
-   \brief check if update is necessary
-   
-   This is the "run" function. Call this function in loop() to make the effect visible.
-   \param currentMillis you can handover a millis timestamp
-*/     
-    void update(uint32_t currentMillis = millis()) {
-      if (state) {
-        if (current == 0 && currentMillis - previousMillis >= offInterval) {
-          previousMillis = currentMillis;        // save the last time you blinked the LED
-          current = 1;
-          switch(state) {
-            case 1 : 
-              obj.digWrite(0, HIGH); 
-              break;
-            case 2 : 
-              obj.digWrite(1, HIGH); 
-              break;
-            case 3 : 
-              obj.digWrite(0, HIGH);
-              obj.digWrite(1, HIGH);
-              obj.digWrite(2, HIGH);
-              break;
-          }
-        }
-        else if (current == 1 && currentMillis - previousMillis >= onInterval) {
-          previousMillis = currentMillis;        // save the last time you blinked the LED
-          current = 0;
-          obj.digWrite(0, LOW);
-          obj.digWrite(1, LOW);
-          obj.digWrite(2, LOW);
-        }
-      }
-    }
 };
  
  /*
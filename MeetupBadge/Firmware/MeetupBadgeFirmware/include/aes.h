@@ -0,0 +1,94 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// aes.h
+//
+// AES-128 in counter mode
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <mbedtls/aes.h>
+#endif
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define AES_KEY_BYTES    16
+#define AES_BLOCK        16
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// AES-128-CTR. The counter block is nonce (8 bytes) | block number (8 bytes),
+// both big endian, so any block of a stream can be produced on its own.
+// On the ESP32 it runs on the AES peripheral through mbedtls, everywhere
+// else on a small byte oriented implementation.
+// ----------------------------------------------------------------------------
+class AesCtr {
+  public:
+    AesCtr();
+    ~AesCtr();
+
+    void begin(const uint8_t* key);            // AES_KEY_BYTES
+
+    // XOR the stream starting at block into data, encrypts and decrypts
+    void crypt(uint64_t nonce, uint64_t block, uint8_t* data, size_t len);
+
+  private:
+#ifdef ARDUINO_ARCH_ESP32
+    mbedtls_aes_context ctx;
+#else
+    uint8_t roundKeys[176];
+
+    void encryptBlock(uint8_t* block);
+#endif
+};
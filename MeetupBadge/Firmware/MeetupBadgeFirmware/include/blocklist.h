@@ -0,0 +1,61 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// blocklist.h
+//
+// Blocked tags, a Bloom filter built from blocklist.txt
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// True if the uid is on the blocklist. A Bloom filter: a listed uid is
+// always found, an unlisted one is found at the false positive rate picked
+// with custom_blocklist_fp_rate in platformio.ini. The filter is const data
+// in flash, a check costs two hashes and BLOCK_HASHES bit reads.
+// ----------------------------------------------------------------------------
+bool blocklistContains(const uint8_t* uid, uint8_t uidLength);
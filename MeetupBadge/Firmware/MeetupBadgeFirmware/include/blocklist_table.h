@@ -0,0 +1,16 @@
+// ============================================================================
+// GENERATED by tools/gen_blocklist.py from blocklist.txt, do not edit
+// ============================================================================
+
+#pragma once
+
+// 0 uids, 4 bytes, target false positive rate 0.001, measured 0.000000
+#define BLOCK_KEYS    0
+#define BLOCK_BITS    32UL
+#define BLOCK_HASHES  1
+#define BLOCK_SEED1   0x0B10C4EDUL
+#define BLOCK_SEED2   0x5EED0B10UL
+
+static constexpr uint32_t blockFilter[BLOCK_BITS / 32] = {
+    0x00000000UL,
+};
@@ -0,0 +1,143 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// console.h
+//
+// Binary request/response console over the serial port
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+
+// Serial settings
+#define CONSOLE_DEFAULT_BAUD     115200
+#define CONSOLE_RX_BUFFER        1024     // UART rx ring, holds several pipelined frames
+#define CONSOLE_BAUD_CONFIRM_MS  2000     // revert a baud change if the host goes quiet
+
+// Frame limits
+#define CONSOLE_MAX_PAYLOAD      240      // largest request/response body
+#define CONSOLE_MAX_FRAME        (CONSOLE_MAX_PAYLOAD + 5)   // seq, cmd, status, crc16
+#define CONSOLE_MAX_ENCODED      (CONSOLE_MAX_FRAME + CONSOLE_MAX_FRAME / 254 + 2)
+#define CONSOLE_MAX_HANDLERS     32
+
+// Console task, loop() runs on core 1 so keep the console on core 0
+#define CONSOLE_TASK_STACK       4096
+#define CONSOLE_TASK_PRIO        1
+#define CONSOLE_TASK_CORE        0
+
+// Command ids, a response echoes the id with CONSOLE_RESPONSE set
+#define CONSOLE_CMD_PING         0x01
+#define CONSOLE_CMD_INFO         0x02
+#define CONSOLE_CMD_SET_BAUD     0x03
+#define CONSOLE_RESPONSE         0x80
+
+// Response status codes
+#define CONSOLE_OK               0x00
+#define CONSOLE_ERR_UNKNOWN      0x01
+#define CONSOLE_ERR_ARGS         0x02
+#define CONSOLE_ERR_BUSY         0x03
+#define CONSOLE_ERR_FAILED       0x04
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Wire format (before COBS encoding, frames are separated by 0x00):
+//
+//   request  : seq | cmd            | payload ... | crc16 lo | crc16 hi
+//   response : seq | cmd | 0x80 | status | payload ... | crc16 lo | crc16 hi
+//
+// crc16 is CRC-16/CCITT-FALSE over everything in front of it. The host may
+// send several requests without waiting, responses come back in request
+// order and carry the request's seq.
+// ----------------------------------------------------------------------------
+
+// A command handler. req/reqLen is the request payload, the handler writes
+// at most *respLen bytes to resp and sets *respLen to what it used.
+// Returns one of the CONSOLE_OK / CONSOLE_ERR_* status codes.
+typedef uint8_t (*ConsoleHandler)(const uint8_t* req, size_t reqLen, uint8_t* resp, size_t* respLen);
+
+class Console {
+  public:
+    Console(HardwareSerial &port) : port(port) {}
+
+    // start the console task, call after Serial.begin()
+    void begin();
+
+    // attach a handler for a command id, false if the id is taken or reserved
+    bool registerHandler(uint8_t cmd, ConsoleHandler handler);
+
+    // drain the rx buffer and answer complete frames, the console task calls this
+    void poll();
+
+    // framing helpers, shared with the host client
+    static size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out);
+    static size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out);
+    static uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+  private:
+    HardwareSerial &port;
+    ConsoleHandler handlers[CONSOLE_MAX_HANDLERS] = { nullptr };
+
+    uint8_t rxBuf[CONSOLE_MAX_ENCODED];           // encoded bytes of the frame being received
+    size_t rxLen           = 0;
+    bool rxOverflow        = false;               // drop bytes until the next delimiter
+
+    uint32_t baud          = CONSOLE_DEFAULT_BAUD;
+    uint32_t previousBaud  = CONSOLE_DEFAULT_BAUD;
+    uint32_t pendingBaud   = 0;                   // switch after the SET_BAUD response went out
+    uint32_t baudChangedAt = 0;
+    bool baudUnconfirmed   = false;
+
+    static void task(void* arg);
+    void handleFrame(const uint8_t* frame, size_t len);
+    uint8_t dispatch(uint8_t cmd, const uint8_t* req, size_t reqLen, uint8_t* resp, size_t* respLen);
+    void sendResponse(uint8_t seq, uint8_t cmd, uint8_t status, const uint8_t* payload, size_t len);
+    void applyBaud(uint32_t newBaud);
+};
+
+extern Console console;
@@ -0,0 +1,118 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// contactlist.h
+//
+// Scrolling list of the collected contacts on the OLED
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+
+#include "contacts.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define LIST_ROWS        7        // text rows below the title, one SSD1306 page each
+#define LIST_ROW_HEIGHT  8        // text size 1 is 8 pixels, a row is exactly one page
+#define LIST_ROW_CHARS   21       // 128 / 6 pixel wide characters
+#define LIST_PREFETCH    2        // rows decoded ahead on each side of the view
+#define LIST_CACHE       12       // decoded rows kept, >= LIST_ROWS + 2 * LIST_PREFETCH
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Newest first view of the contact store. Only the visible rows and a few
+// rows of prefetch are ever decoded, each one by a single indexed read from
+// the store, and the decoded text is kept in a small LRU cache.
+//
+// A scroll moves the rows already on screen one page in the SSD1306 buffer
+// and only draws the row that came into view plus the title, so a step costs
+// the same with 10 or 10,000 contacts. Decoding the next rows happens after
+// the frame went out.
+//
+// Compaction renumbers the records. The cache is keyed by record index, so
+// it's dropped when the log generation changes and an open list is drawn
+// again from the new log.
+// ----------------------------------------------------------------------------
+class ContactList {
+  public:
+    ContactList(Adafruit_SSD1306& display, ContactStore& store);
+
+    // draw the list from the newest contact, or from a position kept
+    // across a restart
+    void open(uint32_t position = 0);
+
+    // forget the view, the screen is left to whoever draws next
+    void close() { opened = false; }
+    bool isOpen() const { return opened; }
+    uint32_t position() const { return top; }
+
+    // move the view, step < 0 towards newer and step > 0 towards older contacts
+    void scroll(int8_t step);
+
+  private:
+    struct Row {
+        uint32_t index;               // record index, UINT32_MAX = unused
+        uint32_t used;                // LRU stamp
+        char text[LIST_ROW_CHARS + 1];
+    };
+
+    Adafruit_SSD1306& display;
+    ContactStore& store;
+    Row cache[LIST_CACHE];
+    uint32_t tick  = 0;
+    uint32_t top   = 0;               // list position of the first visible row
+    uint32_t total = 0;               // store count when the list was opened
+    uint32_t generation = 0;          // log generation the cache was filled from
+    bool opened    = false;
+
+    bool refresh();
+    const char* row(uint32_t position);
+    void drawRow(uint8_t line, uint32_t position);
+    void drawTitle();
+    void prefetch();
+};
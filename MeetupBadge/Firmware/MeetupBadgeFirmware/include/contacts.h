@@ -0,0 +1,388 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// contacts.h
+//
+// Contact store, the UIDs collected from other badges
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+#include "flash.h"
+#include "aes.h"
+#include "uidset.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define CONTACT_UID_MAX      7        // ISO14443A double size UID
+#define CONTACT_FLAG_HIDDEN  0x01     // cleared bit = hidden
+#define CONTACT_FLAGS        0xFF     // default flags, not stored
+#define CONTACT_MASTER_BYTES 32       // secret the record key is derived from
+#define CONTACT_MAGIC        "BSCL"
+#define CONTACT_VERSION      4
+
+// Header cipher
+#define CONTACT_PLAIN        0
+#define CONTACT_AES_CTR      1
+
+// Layout: page 0 is the log header and the uid prefix dictionary, the rest
+// of sector 0 is unused. The sectors after it are split in two halves, the
+// log lives in one and compaction copies it into the other. The first page
+// of a half is its ContactHalfHeader, every other page (256 bytes) is one
+// frame of compact records.
+#define CONTACT_PAGE         256
+#define CONTACT_SECTOR_PAGES (FLASH_SECTOR_SIZE / CONTACT_PAGE)
+#define CONTACT_HALF_MAGIC   "BSCH"
+#define CONTACT_PAGE_HEADER  24
+#define CONTACT_PAGE_DATA    (CONTACT_PAGE - CONTACT_PAGE_HEADER)
+#define CONTACT_PAGE_RECORDS 48       // one commit bit each
+#define CONTACT_DICT_OFFSET  16       // after ContactHeader in page 0
+#define CONTACT_DICT_ENTRIES 16
+#define CONTACT_DICT_PREFIX  3        // manufacturer byte + 2, shared by a batch of tags
+#define CONTACT_RECORD_MAX   14       // tag, 5 byte varint, flags, 7 byte uid
+
+// Index snapshots, two slots at the end of the partition written in turn
+#define CONTACT_SNAP_MAGIC   "BSCI"
+#define CONTACT_SNAP_SLOTS   2
+#define CONTACT_SNAP_BYTES   (2 * FLASH_SECTOR_SIZE)  // header + UIDSET_MAX fingerprints
+#define CONTACT_SNAP_EVERY   64       // records between snapshots
+
+// Compaction
+#define CONTACT_COMPACT_BACKOFF 256   // records before a run that dropped nothing is retried
+
+// Record tag byte: bit 7 is always clear, bit 6 picks the form, a flags
+// byte follows if bit 5 is set, bits 3-0 are the uid length or dictionary entry
+#define CONTACT_FORM_RAW     0x00     // uid stored whole, length in bits 3-0
+#define CONTACT_FORM_DICT    0x40     // 7 byte uid, dictionary prefix + last 4 bytes
+#define CONTACT_TAG_FLAGS    0x20
+#define CONTACT_TAG_LOW      0x0F
+#define CONTACT_TAG_UNUSED   0x90     // must be clear
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// One contact as the store hands it out
+// ----------------------------------------------------------------------------
+struct ContactRecord {
+    uint8_t uid[CONTACT_UID_MAX];
+    uint8_t uidLength;
+    uint32_t seconds;                 // time of the tap, seconds since boot
+    uint8_t flags;                    // CONTACT_FLAG_*, all set by default
+};
+
+// ----------------------------------------------------------------------------
+// Start of page 0, never encrypted. epoch is random per formatted log, it
+// salts the key derivation and is the CTR nonce. keyCheck is written by the
+// first begin() with a key, block 0 of the stream isn't used for data.
+// ----------------------------------------------------------------------------
+struct ContactHeader {
+    char magic[4];                    // CONTACT_MAGIC
+    uint8_t version;
+    uint8_t cipher;                   // CONTACT_PLAIN / CONTACT_AES_CTR
+    uint8_t keyCheck[2];              // key stream block 0, catches a wrong master
+    uint64_t epoch;
+};
+static_assert(sizeof(ContactHeader) == CONTACT_DICT_OFFSET, "dictionary follows the header");
+
+// ----------------------------------------------------------------------------
+// Frame header at the start of every data page, never encrypted. A record
+// is committed by clearing its bit in commit after the record bytes went
+// out, so a record torn by a reset is never counted.
+// ----------------------------------------------------------------------------
+struct ContactPageHeader {
+    uint32_t sequence;                // frame number, picks the key stream
+    uint32_t first;                   // index of the first record
+    uint32_t base;                    // seconds of the first record
+    uint8_t commit[CONTACT_PAGE_RECORDS / 8];
+    uint8_t reserved[5];
+    uint8_t check;                    // CRC-8 of sequence, first, base
+};
+static_assert(sizeof(ContactPageHeader) == CONTACT_PAGE_HEADER, "page header size");
+
+// ----------------------------------------------------------------------------
+// First page of a half, never encrypted. Compaction writes it after erasing
+// the half and clears active once the copy caught up with the log, the
+// active half with the newest generation holds the log.
+// ----------------------------------------------------------------------------
+struct ContactHalfHeader {
+    char magic[4];                    // CONTACT_HALF_MAGIC
+    uint32_t generation;              // bumped by every compaction, mixed into the nonce
+    uint32_t erases;                  // times the whole half was erased
+    uint8_t reserved[3];
+    uint8_t check;                    // CRC-8 of the fields above
+    uint32_t dropped;                 // records compaction removed so far, written with active
+    uint8_t active;                   // cleared when the half takes over the log
+    uint8_t unused[3];
+};
+
+// ----------------------------------------------------------------------------
+// What begin() found, anything but CONTACT_OK leaves the store closed
+// ----------------------------------------------------------------------------
+enum ContactStatus : uint8_t {
+    CONTACT_OK,
+    CONTACT_NO_FLASH,                 // begin() not run, or the region is too small
+    CONTACT_FLASH_FAILED,             // a new log could not be written
+    CONTACT_NO_KEY,                   // the log is encrypted and there is no master
+    CONTACT_WRONG_KEY,                // the master does not open the log
+};
+
+// ----------------------------------------------------------------------------
+// Wear levelling statistics. Both halves take turns, so their erase counts
+// stay within one of each other.
+// ----------------------------------------------------------------------------
+struct ContactWear {
+    uint32_t erases[2];               // full erase passes of each half
+    uint32_t generation;              // generation of the log, every compaction that
+                                      // got past its erase took a new one
+    uint32_t dropped;                 // duplicate and hidden records removed
+};
+
+// ----------------------------------------------------------------------------
+// Start of a snapshot slot, the fingerprints of the seen uid set follow.
+// The header is written last, a snapshot torn by a reset has none.
+// ----------------------------------------------------------------------------
+struct ContactSnapshot {
+    char magic[4];                    // CONTACT_SNAP_MAGIC
+    uint32_t sequence;                // the newer of the two slots wins
+    uint64_t epoch;                   // log the snapshot belongs to
+    uint32_t records;                 // log records folded into the set
+    uint16_t entries;                 // fingerprints that follow
+    uint16_t generation;              // low bits of the log generation
+    uint32_t payloadCrc;              // CRC-32 of the fingerprints as stored
+    uint32_t check;                   // CRC-32 of the fields above
+};
+static_assert(sizeof(ContactSnapshot) + UIDSET_MAX * sizeof(uint32_t) <= CONTACT_SNAP_BYTES, "snapshot slot size");
+
+// ----------------------------------------------------------------------------
+// Append only log of compact records in the "contacts" partition.
+//
+// A record is a tag byte, the zigzag varint of the seconds since the
+// previous record of the frame, an optional flags byte and the uid. 7 byte
+// uids whose first 3 bytes are in the dictionary store only the last 4,
+// the dictionary learns the first 16 prefixes it sees. A typical tap is 7
+// bytes against 16 for a fixed record, about 33 per page.
+//
+// Every page is a frame that decodes on its own, its header carries the
+// index of its first record. read() finds the page with a binary search
+// over the headers, or straight away when it's the page of the last read
+// or the tail, and decodes at most one frame. begin() finds the tail with a
+// binary search for the first erased page.
+//
+// With a master secret the records and the dictionary are AES-128-CTR
+// encrypted. The key is derived once in begin(): HMAC-SHA256(master,
+// "BSC1" | epoch). Block n of a frame's stream is sequence * 16 + n, the
+// tail's stream is made a page at a time when the page is opened, appends
+// then only XOR.
+//
+// The set of uids ever seen is kept in RAM. snapshot() writes it to flash
+// with the record count it covers, begin() loads the newest good snapshot
+// and only replays the records after it, so boot reads the tail instead of
+// the whole log. Snapshots are encrypted like the log, with the inverted
+// epoch as nonce.
+//
+// compact() copies the first visible record of every uid into the other
+// half, dropping repeats and hidden records, and makes that half the log
+// once the copy caught up. It works in slices of a time budget from loop(),
+// a slice overruns by at most one sector erase, and appends carry on into
+// the old half meanwhile. Each generation has its own nonce, epoch ^
+// generation << 32, so a reused page never reuses key stream.
+// ----------------------------------------------------------------------------
+class ContactStore {
+  public:
+    // attach the flash region and find the end of the log. master turns on
+    // encryption for a new log and is required to read an encrypted one.
+    bool begin(FlashDevice& flash, const uint8_t* master = nullptr);
+
+    // why begin() failed. A log with a lost or replaced master can't be
+    // read by anyone, locked() says erase() is the only way to store
+    // contacts again.
+    ContactStatus status() const { return openStatus; }
+    const char* statusText() const;
+    bool locked() const { return openStatus == CONTACT_NO_KEY || openStatus == CONTACT_WRONG_KEY; }
+
+    // throw the whole log away and begin() a new one, needs a begin() on
+    // the same flash first
+    bool erase(const uint8_t* master = nullptr);
+
+    uint32_t count() const { return tail.records; }
+    uint32_t pagesUsed() const { return tail.next - tail.start; }
+    uint32_t pageCount() const { return tail.end - tail.start; }
+    bool encrypted() const { return header.cipher == CONTACT_AES_CTR; }
+
+    // read record index, false if out of range or the frame is damaged
+    bool read(uint32_t index, ContactRecord& rec);
+
+    // add a tap, false if the store is full or uid repeats the last record
+    bool append(const uint8_t* uid, uint8_t uidLength, uint32_t seconds, uint8_t flags = CONTACT_FLAGS);
+
+    // true if the uid was ever stored
+    bool seen(const uint8_t* uid, uint8_t uidLength) const { return seenSet.contains(UidSet::fingerprint(uid, uidLength)); }
+    uint32_t unique() const { return seenSet.size(); }
+
+    // write the seen set to flash, due every CONTACT_SNAP_EVERY records.
+    // Erases CONTACT_SNAP_BYTES, call it when the badge is idle.
+    bool snapshotDue() const { return ready && tail.records - snapRecords >= CONTACT_SNAP_EVERY; }
+    bool snapshot();
+
+    // records begin() read to rebuild the seen set
+    uint32_t replayed() const { return replayCount; }
+
+    // run compaction for about budgetUs if it's due or under way, true
+    // while there's more to do
+    bool compact(uint32_t budgetUs);
+    // the same for at most steps sector erases or record copies, the
+    // slices don't depend on the speed of the flash
+    bool compactSteps(uint32_t steps);
+    bool compacting() const { return compactState != COMPACT_IDLE; }
+    const ContactWear& wear() const { return wearStats; }
+
+    static uint8_t crc8(const uint8_t* data, size_t len);
+    static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+  private:
+    enum CompactState : uint8_t {
+        COMPACT_IDLE,
+        COMPACT_ERASE,                // erasing the other half, a sector per step
+        COMPACT_COPY,                 // copying a record per step
+    };
+
+    // a half being appended to, the log or the compaction copy
+    struct Tail {
+        uint32_t generation;
+        uint32_t start;               // first data page of the half
+        uint32_t end;                 // page after the half
+        uint32_t next;                // first erased page
+        uint32_t sequence;            // last frame number handed out
+        uint32_t records;
+        uint32_t page;                // frame appends go to, 0 = none
+        uint32_t seq;
+        uint32_t first;
+        uint32_t prev;                // seconds of the newest record
+        uint8_t count;
+        uint8_t used;                 // data bytes
+        bool full;                    // out of room or torn, open the next page
+        uint8_t pad[CONTACT_PAGE];    // key stream of the frame
+    };
+
+    FlashDevice* flash = nullptr;
+    bool ready         = false;       // begin() succeeded, the log may be read and written
+    ContactStatus openStatus = CONTACT_NO_FLASH;
+    ContactHeader header;
+    AesCtr aes;
+    uint8_t dict[CONTACT_DICT_ENTRIES][CONTACT_DICT_PREFIX];
+    uint8_t dictUsed   = 0;
+    uint16_t dictBad   = 0;           // torn entries, never matched
+    uint32_t halfSectors = 0;
+    uint8_t half       = 0;           // half holding the log
+    Tail tail;
+
+    // last decoded frame and where in it read() got to
+    uint32_t framePage = 0;
+    uint32_t frameFirst;
+    uint32_t framePrev;
+    uint8_t frameCount;
+    uint8_t frameNext;
+    uint8_t frameOffset;
+    uint8_t frame[CONTACT_PAGE];
+
+    ContactRecord last;               // newest record, repeats are checked against it
+    bool haveLast      = false;
+
+    // seen uids and the snapshot they were last saved in
+    UidSet seenSet;
+    uint32_t snapBase    = 0;         // offset of the first slot
+    uint32_t snapRecords = 0;
+    uint32_t snapSeq     = 0;         // newest sequence on flash
+    uint8_t snapSlot     = 0;         // slot of the snapshot loaded or written last
+    uint32_t replayCount = 0;
+
+    // compaction
+    CompactState compactState = COMPACT_IDLE;
+    uint32_t compactSector  = 0;      // sectors of the other half left to erase
+    uint32_t compactCursor  = 0;      // next record of the log to copy
+    uint32_t compactDropped = 0;
+    uint32_t compactBackoff = 0;      // no run before the log has this many records
+    uint32_t generations    = 0;      // newest generation on flash
+    Tail copy;
+    UidSet copied;
+    ContactWear wearStats;
+
+    bool format(const uint8_t* master);
+    uint32_t halfPage(uint8_t h) const { return (1 + h * halfSectors) * CONTACT_SECTOR_PAGES; }
+    bool readHalf(uint8_t h, ContactHalfHeader& hh);
+    int8_t activeHalf();
+    bool writeHalf(uint8_t h, uint32_t generation, uint32_t erases);
+    bool activateHalf(uint8_t h, uint32_t dropped);
+    void startTail(Tail& t, uint8_t h, uint32_t generation);
+    void findTail();
+    void loadIndex();
+    bool loadSnapshot(uint8_t slot, const ContactSnapshot& snap);
+    bool readSnapshot(uint8_t slot, ContactSnapshot& snap);
+    void snapshotCrypt(uint32_t sequence, uint32_t offset, uint8_t* data, size_t len);
+    void loadDictionary();
+    int8_t learnPrefix(const uint8_t* uid);
+    bool readHeader(uint32_t page, ContactPageHeader& ph);
+    bool loadFrame(uint32_t page);
+    uint32_t locate(uint32_t index);
+    uint64_t nonce(uint32_t generation) const { return header.epoch ^ ((uint64_t) generation << 32); }
+    bool openPage(Tail& t, uint32_t seconds);
+    bool writeRecord(Tail& t, const ContactRecord& rec);
+    bool compactDue() const;
+    bool compactStart();
+    bool compactStep();
+    void compactEnd();
+    size_t encode(const ContactRecord& rec, uint32_t previous, int8_t entry, uint8_t* out) const;
+    size_t decode(const uint8_t* in, size_t len, uint32_t previous, ContactRecord& rec) const;
+    static uint8_t committed(const ContactPageHeader& ph);
+    static bool isErased(const uint8_t* data, size_t len);
+};
+
+extern ContactStore contacts;
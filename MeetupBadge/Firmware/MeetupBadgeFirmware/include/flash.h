@@ -0,0 +1,126 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// flash.h
+//
+// Raw flash access for the badge data stores
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_partition.h>
+#endif
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define FLASH_SECTOR_SIZE  4096     // erase unit of the ESP32 SPI flash
+#define FLASH_ERASED       0xFF     // value of an erased byte
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// A region of NOR flash. Erased bytes read 0xFF, a write can only clear bits
+// and erase works on whole sectors. Offsets are relative to the region.
+// The stores only talk to this interface so the same code runs on the badge
+// (EspPartitionFlash) and in the host tools (FileFlash).
+// ----------------------------------------------------------------------------
+class FlashDevice {
+  public:
+    virtual bool read(uint32_t offset, void* buf, size_t len) = 0;
+    virtual bool write(uint32_t offset, const void* buf, size_t len) = 0;
+    virtual bool erase(uint32_t offset, size_t len) = 0;     // sector aligned
+    virtual uint32_t size() const = 0;
+    uint32_t sectorSize() const { return FLASH_SECTOR_SIZE; }
+};
+
+#ifdef ARDUINO_ARCH_ESP32
+// ----------------------------------------------------------------------------
+// A data partition from partitions.csv, found by its label
+// ----------------------------------------------------------------------------
+class EspPartitionFlash : public FlashDevice {
+  public:
+    // find the partition, false if partitions.csv has no such label
+    bool begin(const char* label);
+
+    bool read(uint32_t offset, void* buf, size_t len) override;
+    bool write(uint32_t offset, const void* buf, size_t len) override;
+    bool erase(uint32_t offset, size_t len) override;
+    uint32_t size() const override { return partition ? partition->size : 0; }
+
+  private:
+    const esp_partition_t* partition = nullptr;
+};
+#endif
+
+#ifndef ARDUINO
+// ----------------------------------------------------------------------------
+// Host side flash image in a file, with NOR semantics so host tools and
+// tests see the same behaviour as the badge
+// ----------------------------------------------------------------------------
+class FileFlash : public FlashDevice {
+  public:
+    ~FileFlash();
+
+    // open or create an image of len bytes, a new image is erased
+    bool begin(const char* path, uint32_t len);
+
+    bool read(uint32_t offset, void* buf, size_t len) override;
+    bool write(uint32_t offset, const void* buf, size_t len) override;
+    bool erase(uint32_t offset, size_t len) override;
+    uint32_t size() const override { return length; }
+
+  private:
+    FILE* file = nullptr;
+    uint32_t length = 0;
+};
+#endif
@@ -0,0 +1,94 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// hmac.h
+//
+// SHA-256 and HMAC-SHA256
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define SHA256_BYTES   32
+#define SHA256_BLOCK   64
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Plain C++ SHA-256, the fallback for the host build and the baseline for
+// the accelerator benchmark on the badge
+// ----------------------------------------------------------------------------
+class Sha256 {
+  public:
+    void begin();
+    void update(const void* data, size_t len);
+    void finish(uint8_t* digest);              // SHA256_BYTES
+
+  private:
+    uint32_t state[8];
+    uint64_t length;                           // bytes hashed so far
+    uint8_t block[SHA256_BLOCK];
+    uint8_t used;                              // bytes waiting in block
+
+    void compress(const uint8_t* data);
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// HMAC-SHA256. On the ESP32 this goes through mbedtls, which drives the
+// SHA accelerator, everywhere else through Sha256
+void hmacSha256(const uint8_t* key, size_t keyLen, const uint8_t* data, size_t len, uint8_t* mac);
+
+// HMAC-SHA256 always in software
+void hmacSha256Soft(const uint8_t* key, size_t keyLen, const uint8_t* data, size_t len, uint8_t* mac);
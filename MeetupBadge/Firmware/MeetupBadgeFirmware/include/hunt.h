@@ -0,0 +1,135 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// hunt.h
+//
+// Scavenger hunt checkpoints, HMAC signed tags verified offline
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+#include "uidkey.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define HUNT_KEY_BYTES     32       // shared secret of the event
+#define HUNT_MAC_BYTES     16       // truncated HMAC-SHA256, 32 hex digits in the url
+#define HUNT_CHECKPOINTS   64       // ids 0x00..0x3F, progress is a bit mask in NVS
+#define HUNT_CACHE         8        // uid -> verdict entries, re-taps skip the HMAC
+#define HUNT_URL_MARKER    "/hunt/"
+#define HUNT_DOMAIN        "BSH1"   // prefix of the signed message, versions the format
+
+// Console commands, see tools/badge_console.py
+#define HUNT_CMD_SET_KEY   0x10     // req: 32 byte key, stored in NVS
+#define HUNT_CMD_BENCH     0x11     // resp: uint32 hardware, uint32 software verifications/s
+
+// NVS
+#define HUNT_PREFS         "hunt"
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Tag payload: an NDEF URI record, so a phone still opens a page
+//
+//   https://<host>/hunt/<cc>/<mac>
+//
+//   cc  : checkpoint id, 2 hex digits
+//   mac : HMAC-SHA256(key, "BSH1" | cc | uidLength | uid), first 16 bytes
+//         as 32 hex digits
+//
+// The uid is part of the signed message, so copying the url to another tag
+// doesn't make another valid checkpoint. tools/hunt_tag.py makes the urls.
+// ----------------------------------------------------------------------------
+enum HuntVerdict : uint8_t {
+    HUNT_NONE,                        // not a hunt url
+    HUNT_VALID,
+    HUNT_FORGED,                      // hunt url with a wrong mac
+    HUNT_NO_KEY,                      // hunt url but no key provisioned
+};
+
+class Hunt {
+  public:
+    // load key and progress from NVS, register the console commands
+    void begin();
+
+    // check the url read from a tag, checkpoint is set for VALID/FORGED
+    HuntVerdict verify(const uint8_t* uid, uint8_t uidLength, const String& url, uint8_t* checkpoint);
+    HuntVerdict verifyMac(const uint8_t* uid, uint8_t uidLength, uint8_t checkpoint, const uint8_t* mac);
+
+    // record a valid checkpoint, true the first time
+    bool markFound(uint8_t checkpoint);
+    uint8_t foundCount() const;
+
+    // new key from the console task, picked up by the next verify()
+    bool setKey(const uint8_t* newKey, size_t len);
+
+    // verifications per second on the SHA accelerator and in software
+    void benchmark(uint16_t rounds, uint32_t* hardware, uint32_t* software);
+
+    static bool parseUrl(const char* url, uint8_t* checkpoint, uint8_t* mac);
+
+  private:
+    struct CacheEntry {
+        UidKey key;
+        uint8_t checkpoint;
+        uint8_t mac[HUNT_MAC_BYTES];
+        HuntVerdict verdict;
+    };
+
+    uint8_t key[HUNT_KEY_BYTES];
+    bool haveKey               = false;
+    uint8_t pendingKey[HUNT_KEY_BYTES];
+    volatile bool keyPending   = false;
+    CacheEntry cache[HUNT_CACHE];
+    uint8_t cached             = 0;
+    uint8_t nextEntry          = 0;       // round robin, re-taps are of recent tags
+    uint64_t found             = 0;
+
+    static size_t message(const uint8_t* uid, uint8_t uidLength, uint8_t checkpoint, uint8_t* out);
+    static bool sameMac(const uint8_t* a, const uint8_t* b);
+};
+
+extern Hunt hunt;
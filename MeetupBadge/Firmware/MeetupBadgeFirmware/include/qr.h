@@ -0,0 +1,126 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// qr.h
+//
+// QR code encoder (version 1 to 6, byte mode) for the OLED
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+
+// Limits, everything is in static buffers sized for the largest version
+#define QR_MAX_VERSION     6
+#define QR_MAX_SIZE        (17 + 4 * QR_MAX_VERSION)                // modules per side
+#define QR_MAX_MODULES     ((QR_MAX_SIZE * QR_MAX_SIZE + 7) / 8)    // bytes for one module bitmap
+#define QR_MAX_CODEWORDS   172                                      // data + ecc of version 6
+
+// Error correction levels, the value is the level's format info bits
+#define QR_ECC_L           1        // ~7% recovery, the most data
+#define QR_ECC_M           0        // ~15% recovery
+
+// Quiet zone, the spec asks for 4 modules but the OLED has no room for it
+#define QR_MAX_QUIET       4
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Encoder for byte mode QR codes up to version 6 (41 x 41, 134 bytes at L).
+// The smallest version that holds the data is used, the mask with the lowest
+// penalty is picked. No heap: all buffers are members and the Reed-Solomon
+// generators and GF(256) tables are precomputed in flash.
+//
+// render() writes straight into a SSD1306 page buffer (one byte is 8 rows of
+// one column). Light modules are lit pixels. Codes up to version 3 are drawn
+// at 2x on a 64 pixel high display, bigger ones at 1x.
+// ----------------------------------------------------------------------------
+class QrCode {
+  public:
+    // encode len bytes, false if they don't fit into version 6 at this level
+    bool encode(const uint8_t* data, size_t len, uint8_t ecc = QR_ECC_M);
+    bool encode(const char* text, uint8_t ecc = QR_ECC_M) {
+        return encode((const uint8_t*) text, strlen(text), ecc);
+    }
+
+    uint8_t getVersion() const { return version; }
+    uint8_t getSize() const { return size; }
+
+    // true for a dark module
+    bool getModule(uint8_t x, uint8_t y) const {
+        uint16_t i = y * size + x;
+        return modules[i >> 3] & (1 << (i & 7));
+    }
+
+    // draw right aligned into a page buffer, returns the width used in pixels
+    uint8_t render(uint8_t* buffer, uint8_t width, uint8_t height) const;
+
+  private:
+    uint8_t version = 0;                          // 0 = nothing encoded
+    uint8_t size    = 0;
+    uint8_t modules[QR_MAX_MODULES];              // dark modules
+    uint8_t reserved[QR_MAX_MODULES];             // function patterns, not masked
+    uint8_t data[QR_MAX_CODEWORDS];               // data + ecc codewords by block
+    uint8_t codewords[QR_MAX_CODEWORDS];          // interleaved for placement
+
+    void setModule(uint8_t x, uint8_t y, bool dark);
+    void setFunction(uint8_t x, uint8_t y, bool dark);
+    bool isFunction(uint8_t x, uint8_t y) const {
+        uint16_t i = y * size + x;
+        return reserved[i >> 3] & (1 << (i & 7));
+    }
+
+    void drawFunctionPatterns();
+    void drawFinder(int8_t cx, int8_t cy);
+    void drawAlignment(uint8_t cx, uint8_t cy);
+    void drawFormat(uint8_t ecc, uint8_t mask);
+    void drawCodewords(uint16_t count);
+    void applyMask(uint8_t mask);
+    uint16_t penalty() const;
+};
+
+extern QrCode qrCode;
@@ -0,0 +1,82 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// tags.h
+//
+// Event tags that trigger their own screen, see tags.csv
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+#include "uidkey.h"
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// What an event tag does, the action column of tags.csv is the name without
+// TAG_. tools/gen_tags.py reads this enum, a new action only needs a case in
+// displayTagAction().
+// ----------------------------------------------------------------------------
+enum TagAction : uint8_t {
+    TAG_NONE,                         // not an event tag
+    TAG_SPONSOR,                      // sponsor booth, arg = booth number
+    TAG_ROOM,                         // talk room door, arg = room number
+    TAG_ORGANISER,                    // organiser badge
+};
+
+// One slot of the generated table, the uid packed as in uidKey()
+struct TagEntry {
+    uint32_t keyHi;
+    uint32_t keyLo;
+    TagAction action;
+    uint8_t arg;
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// look up a tag read by the PN532, TAG_NONE if it's not an event tag
+TagAction tagLookup(const uint8_t* uid, uint8_t uidLength, uint8_t* arg);
@@ -0,0 +1,33 @@
+// ============================================================================
+// GENERATED by tools/gen_tags.py from tags.csv, do not edit
+// ============================================================================
+
+#pragma once
+
+#include "tags.h"
+
+#define TAG_TABLE_SEED     0xDAEB8EBDUL
+#define TAG_TABLE_SIZE     5
+#define TAG_TABLE_BUCKETS  3
+#define TAG_TABLE_KEYS     5
+
+static constexpr uint16_t tagDisplace[TAG_TABLE_BUCKETS] = {
+        0,     2,     0,
+};
+
+static constexpr TagEntry tagTable[TAG_TABLE_SIZE] = {
+    { 0x0704C0FFUL, 0xEE000001UL, TAG_ROOM, 1 },  // 04C0FFEE000001 main track
+    { 0x0704C0FFUL, 0xEE000002UL, TAG_ROOM, 2 },  // 04C0FFEE000002 workshop room
+    { 0x0704A1B2UL, 0xC3D4E5F7UL, TAG_SPONSOR, 2 },  // 04A1B2C3D4E5F7 booth 2
+    { 0x04DEADBEUL, 0xEF000000UL, TAG_ORGANISER, 0 },  // DEADBEEF organiser badge
+    { 0x0704A1B2UL, 0xC3D4E5F6UL, TAG_SPONSOR, 1 },  // 04A1B2C3D4E5F6 booth 1
+};
+
+// every key lands on its own slot, expanded in src/tags.cpp once tagFind() exists
+#define TAG_TABLE_CHECKS \
+    static_assert(tagFind(0x0704C0FFUL, 0xEE000001UL) == 0, "tag table"); \
+    static_assert(tagFind(0x0704C0FFUL, 0xEE000002UL) == 1, "tag table"); \
+    static_assert(tagFind(0x0704A1B2UL, 0xC3D4E5F7UL) == 2, "tag table"); \
+    static_assert(tagFind(0x04DEADBEUL, 0xEF000000UL) == 3, "tag table"); \
+    static_assert(tagFind(0x0704A1B2UL, 0xC3D4E5F6UL) == 4, "tag table"); \
+    static_assert(TAG_TABLE_SIZE > 0, "tag table");
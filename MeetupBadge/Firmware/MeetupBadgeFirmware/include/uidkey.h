@@ -0,0 +1,91 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// uidkey.h
+//
+// Packing and hashing of tag UIDs for the flash tables
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// A 4 or 7 byte UID in two words. The length sits in the top byte so a 4
+// byte uid never equals a 7 byte one starting with the same bytes. The
+// generators in tools/ pack and hash the same way (tools/uidkey.py).
+// ----------------------------------------------------------------------------
+struct UidKey {
+    uint32_t hi;                      // length, uid[0..2]
+    uint32_t lo;                      // uid[3..6], zero padded
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+inline UidKey uidKey(const uint8_t* uid, uint8_t uidLength) {
+    uint8_t b[7] = { 0 };
+    memcpy(b, uid, uidLength > 7 ? 7 : uidLength);
+    UidKey key;
+    key.hi = ((uint32_t) uidLength << 24) | ((uint32_t) b[0] << 16) | ((uint32_t) b[1] << 8) | b[2];
+    key.lo = ((uint32_t) b[3] << 24) | ((uint32_t) b[4] << 16) | ((uint32_t) b[5] << 8) | b[6];
+    return key;
+}
+
+// ----------------------------------------------------------------------------
+// Seeded hash of a packed uid, murmur3's finalizer twice so no two uids
+// collide for every seed. constexpr so generated tables can be checked by
+// the compiler.
+// ----------------------------------------------------------------------------
+constexpr uint32_t uidFmix3(uint32_t h) { return h ^ (h >> 16); }
+constexpr uint32_t uidFmix2(uint32_t h) { return uidFmix3((h ^ (h >> 13)) * 0xC2B2AE35UL); }
+constexpr uint32_t uidFmix(uint32_t h) { return uidFmix2((h ^ (h >> 16)) * 0x85EBCA6BUL); }
+constexpr uint32_t uidHash(uint32_t hi, uint32_t lo, uint32_t seed) { return uidFmix(uidFmix(lo ^ seed) ^ hi); }
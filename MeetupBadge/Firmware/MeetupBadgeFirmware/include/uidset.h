@@ -0,0 +1,96 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// uidset.h
+//
+// Set of the UIDs in the contact log
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define UIDSET_SLOTS       2048       // power of two
+#define UIDSET_MAX         1536       // 75% load, probes stay short
+#define UIDSET_SEED        0x5EE11D5UL
+#define UIDSET_EMPTY       0
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Open addressing hash set of 32 bit uid fingerprints, linear probing. A
+// fingerprint is uidHash() of the packed uid, two uids share one about once
+// in 4 billion. Once UIDSET_MAX uids are in, new ones are no longer added
+// and contains() can miss them, full() says so.
+// ----------------------------------------------------------------------------
+class UidSet {
+  public:
+    UidSet() { clear(); }
+
+    void clear();
+
+    // add a fingerprint, true if it wasn't in the set
+    bool insert(uint32_t fingerprint);
+    bool contains(uint32_t fingerprint) const;
+
+    uint16_t size() const { return used; }
+    bool full() const { return used >= UIDSET_MAX; }
+
+    // raw slots for serialising, UIDSET_EMPTY if unused
+    uint32_t slot(uint16_t i) const { return slots[i]; }
+
+    // never UIDSET_EMPTY
+    static uint32_t fingerprint(const uint8_t* uid, uint8_t uidLength);
+
+  private:
+    uint32_t slots[UIDSET_SLOTS];
+    uint16_t used;
+};
@@ -18,10 +18,14 @@
   copyright 2023 noiasca noiasca@yahoo.com
   
   Version
+  2026-10-18        empty color setters for the multi effect
+  2026-10-18        key scan with INT line, ButtonHT16K33
+  2026-10-18        Blink on a HT16K33 uses the blink engine of the IC if all blinking LEDs share one rate
   2023-02-18        added HT16K33
 */
 
 #pragma once
+#include <Noiasca_button.h>
 
 /**  
     \brief HT16K33 Expander Hardware class
@@ -39,9 +43,64 @@ class HT16K33expander {
   protected:
     static const uint8_t HT16K33_OSCILATOR_ON  {0x21};     // System Setup Register 0x20 + 0x01
     static const uint8_t HT16K33_CMD_BRIGHTNESS  {0xE0};   // Dimming set (Datasheet says EF, but this is just with the set bits D12-D8 for full brightness
+    static const uint8_t HT16K33_CMD_DISPLAY  {0x81};      // Display setup: display on, blink rate in D2-D1
+    static const uint8_t HT16K33_CMD_ROWINT  {0xA1};       // ROW/INT set: ROW15 is INT, active LOW
+    static const uint8_t HT16K33_KEY_RAM  {0x40};          // key data address pointer, 6 bytes
     TwoWire *i2cPort;				           // generic connection to user's chosen I2C hardware
     const uint8_t i2cAddr;             // I2C address of expander
     uint16_t pinStatus[8] {0};         // stores io state of expander pins to make them available in parallel instances
+    uint16_t blinkPins[8] {0};         // pins of active blink effects
+    uint8_t blinkUsers[4] {0};         // active blink effects per rate, index 0 are rates the IC can't do
+    uint8_t blinkRate = 0;             // rate in the display setup register, 0 = blinking is done by software
+    uint16_t keyStatus[3] {0};         // last read key RAM, 13 keys per key scan line KS0..KS2
+    volatile bool keyEvent = false;    // set by keyInterrupt(), the key RAM needs a read
+
+/*
+   write the display RAM from pinStatus in one transaction
+*/
+    int writeAll() {
+      i2cPort->beginTransmission(i2cAddr);
+      i2cPort->write(0);
+      for (uint8_t j = 0; j < 8; j++) {
+        i2cPort->write(pinStatus[j] & 0xFF);
+        i2cPort->write(pinStatus[j] >> 8);
+      }
+      return i2cPort->endTransmission();
+    }
+
+    int writeDisplaySetup() {
+      i2cPort->beginTransmission(i2cAddr);
+      i2cPort->write(HT16K33_CMD_DISPLAY | (blinkRate << 1));
+      return i2cPort->endTransmission();
+    }
+
+/*
+   hardware blink is possible if all blink effects share one supported rate
+   and no other LED is on - the IC blinks the whole display.
+*/
+    void updateBlink() {
+      uint8_t wanted = 0;
+      if (blinkUsers[0] == 0) {
+        for (uint8_t rate = 1; rate < 4; rate++) {
+          if (blinkUsers[rate] == 0) continue;
+          if (wanted) {                          // a second rate
+            wanted = 0;
+            break;
+          }
+          wanted = rate;
+        }
+      }
+      for (uint8_t j = 0; wanted && j < 8; j++) {
+        if (pinStatus[j] & ~blinkPins[j]) wanted = 0;
+      }
+      if (wanted == blinkRate) return;
+      if (wanted) {                              // all blink LEDs on, the IC does the rest
+        for (uint8_t j = 0; j < 8; j++) pinStatus[j] |= blinkPins[j];
+        writeAll();
+      }
+      blinkRate = wanted;
+      writeDisplaySetup();
+    }
    
   public:
 /**
@@ -61,6 +120,7 @@ class HT16K33expander {
     int result = Wire.endTransmission();
     clear();
     setBrightness(15);                           // max brightness
+    writeDisplaySetup();                         // display on, blink rate
     return result;
   }
   
@@ -113,6 +173,126 @@ class HT16K33expander {
       i2cPort->write(pinStatus[cathode] & 0xFF);
       i2cPort->write(pinStatus[cathode] >> 8);
       i2cPort->endTransmission();
+      if (!bitRead(blinkPins[cathode], anode)) {
+        if (blinkRate && val != LOW) updateBlink();                                       // a steady LED would blink
+        else if (!blinkRate && val == LOW && (blinkUsers[1] | blinkUsers[2] | blinkUsers[3])) updateBlink();  // maybe the last steady LED
+      }
+    }
+
+/**
+   \brief start the key scan
+   
+   ROW15 becomes the INT output (active LOW). Connect INT to a GPIO with pullup
+   and call keyInterrupt() from its interrupt service routine on the FALLING edge.
+   Anode 15 can't be used for LEDs any more.
+   @return the result of endTransmission
+*/
+    int beginKeys() {
+      i2cPort->beginTransmission(i2cAddr);
+      i2cPort->write(HT16K33_CMD_ROWINT);
+      int result = i2cPort->endTransmission();
+      keyEvent = true;                           // read the initial state
+      return result;
+    }
+
+/**
+   \brief the key RAM has changed
+   
+   Call this from the interrupt service routine of the INT line. It only sets a flag.
+*/
+    void keyInterrupt() {
+      keyEvent = true;
+    }
+
+/**
+   \brief read the key RAM if the INT line has fired
+   
+   Reads all 39 keys in one burst of 6 bytes. Reading the key RAM also clears INT.
+   Call this in loop() before the updates of the buttons.
+   Without an INT line use updateKeys(true) to read anyway.
+   @param force read even if there was no interrupt
+   @return true if a key has changed
+*/
+    bool updateKeys(bool force = false) {
+      if (!keyEvent && !force) return false;
+      keyEvent = false;
+      i2cPort->beginTransmission(i2cAddr);
+      i2cPort->write(HT16K33_KEY_RAM);
+      if (i2cPort->endTransmission(false) != 0) return false;
+      if (i2cPort->requestFrom(i2cAddr, (uint8_t)6) != 6) return false;
+      bool changed = false;
+      for (uint8_t j = 0; j < 3; j++) {
+        uint16_t value = i2cPort->read();
+        value |= (uint16_t)i2cPort->read() << 8;
+        value &= 0x1FFF;                         // K1..K13
+        if (value != keyStatus[j]) changed = true;
+        keyStatus[j] = value;
+      }
+      return changed;
+    }
+
+/**
+   \brief state of a key from the last read
+   
+   The key is 0..38: KS0 K1..K13 are keys 0..12, KS1 13..25, KS2 26..38
+   @param key the key to read
+   @return HIGH if the key is pressed
+*/
+    int keyRead(uint8_t key) {
+      if (key > 38) return LOW;
+      return bitRead(keyStatus[key / 13], key % 13) ? HIGH : LOW;
+    }
+
+/**
+   \brief the blink register value for an on/off interval
+   
+   @param onInterval on time in ms
+   @param offInterval off time in ms
+   @return 1 (2Hz), 2 (1Hz), 3 (0.5Hz) or 0 if the IC can't blink this rate
+*/
+    static uint8_t blinkRateOf(uint16_t onInterval, uint16_t offInterval) {
+      if (onInterval != offInterval) return 0;
+      if (onInterval == 250) return 1;
+      if (onInterval == 500) return 2;
+      if (onInterval == 1000) return 3;
+      return 0;
+    }
+
+/**
+   \brief register an active blink effect
+   
+   If all active blink effects share a rate the IC can do and no other LED is on,
+   the blink register is programmed and the effects can stop writing.
+   @param pin the pin of the blink effect
+   @param rate the rate from blinkRateOf()
+*/
+    void attachBlink(uint8_t pin, uint8_t rate) {
+      if (pin > 127 || rate > 3) return;
+      bitSet(blinkPins[pin / 16], pin % 16);
+      blinkUsers[rate]++;
+      updateBlink();
+    }
+
+/**
+   \brief unregister a blink effect
+   
+   @param pin the pin of the blink effect
+   @param rate the rate used in attachBlink()
+*/
+    void detachBlink(uint8_t pin, uint8_t rate) {
+      if (pin > 127 || rate > 3) return;
+      bitClear(blinkPins[pin / 16], pin % 16);
+      if (blinkUsers[rate]) blinkUsers[rate]--;
+      updateBlink();
+    }
+
+/**
+   \brief is the IC blinking 
+   
+   @return true if the blink effects are done by the blink register
+*/
+    bool isHardwareBlink() {
+      return blinkRate != 0;
     }
     
 ///**
@@ -145,6 +325,8 @@ class HT16K33expander {
 class HT16K33 {
     HT16K33expander &ic;
     const uint8_t startPixel;          // one output on the expander IC
+    bool attached = false;             // registered as active blink on the ic
+    uint8_t attachedRate = 0;          // the rate used for the registration
 
   public:
     HT16K33(HT16K33expander &ic, uint16_t startPixel) : ic(ic), startPixel(startPixel) {}
@@ -178,6 +360,41 @@ class HT16K33 {
       else
         digWrite(HIGH);
     }
+
+/**
+   \brief register the blink of this output with the IC
+   
+   Only a change of the intervals reaches the IC, so it can be called on each update.
+   @param onInterval on time in ms, 0 and 0 to end the blink
+   @param offInterval off time in ms
+   @return true if the IC blinks the output
+*/
+    bool blink(uint16_t onInterval, uint16_t offInterval) {
+      bool active = onInterval || offInterval;
+      uint8_t rate = HT16K33expander::blinkRateOf(onInterval, offInterval);
+      if (active != attached || rate != attachedRate) {
+        if (attached) ic.detachBlink(startPixel, attachedRate);
+        attached = active;
+        attachedRate = rate;
+        if (attached) ic.attachBlink(startPixel, rate);
+      }
+      return attached && ic.isHardwareBlink();
+    }
+
+    // empty implementation - a HT16K33 output has no color
+    void setOnColor(uint32_t _onColor) {
+      (void)_onColor;
+    }
+
+    // empty implementation - a HT16K33 output has no color
+    void setOffColor(uint32_t _offColor) {
+      (void)_offColor;
+    }
+};
+
+template<>
+struct OutputTraits<HT16K33> : OutputTraitsBase<HT16K33> {
+  static constexpr bool hardwareBlink = true;
 };
 
 /*
@@ -223,6 +440,38 @@ class HT16K33Group {
     } 
 };
 
+/**
+   \brief a key in the key scan matrix of a HT16K33
+   
+   Works like Button. The key state comes from the last HT16K33expander::updateKeys(),
+   so reading a button doesn't cause any I2C traffic.
+   The IC debounces the keys, the software debounce of Button is done additionally.
+*/
+class ButtonHT16K33 : public Button {
+    HT16K33expander &ic;
+
+  protected:
+    int readPin() override {
+      return ic.keyRead(buttonPin);
+    }
+
+  public:
+/**
+   @param ic a reference to your ic object
+   @param key the key 0..38 (KS0 K1..K13, KS1 K1..K13, KS2 K1..K13)
+**/
+    ButtonHT16K33(HT16K33expander &ic, uint8_t key) : Button(key, HIGH), ic(ic) {}
+
+/**
+    \brief initialise the button state
+    
+    Call this function in your setup() after HT16K33expander::beginKeys(). 
+*/
+    void begin() {
+      if (readPin() == active) lastButtonState = HIGH;
+    }
+};
+
 /* **************************************************************
   wrapper make to make the interface more 
   userfriendly
@@ -7,6 +7,9 @@
   copyright 2022 noiasca noiasca@yahoo.com
   
   Version
+  2026-10-18      empty color setters for the multi effect
+  2026-10-18      12 bit levels for Smooth, Heartbeat and Fluorescent
+  2026-10-18      ALL_LED writes, phase stagger of the ON time
   2022-12-19      added multi effect
   2022-12-17      initial version (based on 2022-02-15 neopixel)
 */
@@ -21,10 +24,84 @@
 class PCA9685 {
     Adafruit_PWMServoDriver &pwm;
     const uint16_t startPixel;          // one output on PCA9685
+    static const uint8_t ALL_LED {61};  // setPWM(61, ...) writes ALL_LED_ON_L..ALL_LED_OFF_H (0xFA)
+    static uint16_t phaseStep;          // ON offset per channel in ticks, 0 = all channels start at 0
 
   public:
     PCA9685(Adafruit_PWMServoDriver &pwm, uint16_t startPixel) : pwm(pwm), startPixel(startPixel) {}
 
+/**
+   \brief spread the ON time of the channels over the PWM cycle
+   
+   Channel n switches on at n * step ticks of the 4096 ticks cycle 
+   instead of all channels at 0. This reduces peak current and ripple.
+   Applies to all PCA9685 outputs, also on several ICs.
+   @param step ticks between two channels, 256 spreads 16 channels evenly, 0 switches off
+*/
+    static void setPhaseStagger(uint16_t step = 256) {
+      phaseStep = step;
+    }
+
+/**
+   \brief switch all 16 channels of an IC with one register write
+   
+   @param pwm the IC
+   @param val LOW for all off, HIGH for all on
+*/
+    static void allWrite(Adafruit_PWMServoDriver &pwm, uint8_t val) {
+      if (val == LOW) 
+        pwm.setPWM(ALL_LED, 0, 4096);
+      else
+        pwm.setPWM(ALL_LED, 4096, 0);
+    }
+
+/**
+   \brief set the same duty on all 16 channels of an IC with one register write
+   
+   Without phase stagger only. With phase stagger each channel needs its own offset.
+   @param pwm the IC
+   @param value the duty 0..255
+   @return false if a phase stagger is active and nothing was written
+*/
+    static bool allPwmWrite(Adafruit_PWMServoDriver &pwm, uint8_t value) {
+      if (phaseStep) return false;
+      pwm.setPWM(ALL_LED, 0, value * 16);
+      return true;
+    }
+
+/**
+   \brief write a duty to a channel
+   
+   The ON time starts at the phase of the channel.
+   @param pwm the IC
+   @param channel the channel 0..15
+   @param value the duty 0..255
+*/
+    static void channelPwmWrite(Adafruit_PWMServoDriver &pwm, uint16_t channel, uint8_t value) {
+      channelLevelWrite(pwm, channel, value * 16);
+    }
+
+/**
+   \brief write a 12 bit duty to a channel
+   
+   @param pwm the IC
+   @param channel the channel 0..15
+   @param level the duty 0..4095
+*/
+    static void channelLevelWrite(Adafruit_PWMServoDriver &pwm, uint16_t channel, uint16_t level) {
+      if (level > 4095) level = 4095;
+      if (phaseStep == 0) {
+        pwm.setPWM(channel, 0, level);
+      }
+      else if (level == 0) {
+        pwm.setPWM(channel, 0, 4096);            // full off, ON == OFF would be undefined
+      }
+      else {
+        uint16_t on = (channel * phaseStep) & 0x0FFF;
+        pwm.setPWM(channel, on, (on + level) & 0x0FFF);
+      }
+    }
+
     void begin(){} // no need, the pwm needs one begin only.
     
 
@@ -50,10 +127,39 @@ class PCA9685 {
     @todo rework according https://learn.adafruit.com/led-tricks-gamma-correction/the-quick-fix
 */
     void pwmWrite(uint16_t value) {
-      pwm.setPWM(startPixel, 0, value * 16);
+      channelPwmWrite(pwm, startPixel, value);
+    }
+
+/**
+   \brief write in native 12 bit resolution
+   
+   @param level the duty 0..4095
+*/
+    void levelWrite(uint16_t level) {
+      channelLevelWrite(pwm, startPixel, level);
+    }
+
+    // empty implementation - a PCA9685 output has no color
+    void setOnColor(uint32_t _onColor) {
+      (void)_onColor;
+    }
+
+    // empty implementation - a PCA9685 output has no color
+    void setOffColor(uint32_t _offColor) {
+      (void)_offColor;
     }
 };
 
+uint16_t PCA9685::phaseStep = 0;  // initialize outside of class
+
+template<>
+struct OutputTraits<PCA9685> : OutputTraitsBase<PCA9685> {
+  static constexpr uint8_t extraBits = 4;        // 12 bit PWM
+  static void levelWrite(PCA9685 &obj, uint16_t level) {
+    obj.levelWrite(level);
+  }
+};
+
 /*
    class to encapsulate several LEDs on a PCA9685 into one object
    and to offer a unified interface
@@ -62,15 +168,38 @@ template<size_t noOfPixel>
 class PCA9685Group {
     Adafruit_PWMServoDriver &pwm;
     uint16_t pixel[noOfPixel];         // pixel index on pwm
+    bool allChannels = false;          // the group uses all 16 channels of the IC, group writes can use ALL_LED
+    
+    bool isAllChannels() {
+      if (noOfPixel != 16) return false;
+      uint16_t used = 0;
+      for (size_t i = 0; i < noOfPixel; i++)
+        if (pixel[i] < 16) used |= 1U << pixel[i];
+      return used == 0xFFFF;
+    }
 
   public:
     PCA9685Group(Adafruit_PWMServoDriver &pwm, uint16_t pixelA, uint16_t pixelB, uint16_t pixelC) : pwm(pwm), pixel{pixelA, pixelB, pixelC} {}
 
+/**
+   @param pwm a reference to your PCA9685 object
+   @param pixels the channels of the group. A group of all 16 channels switches with one ALL_LED write.
+**/
+    PCA9685Group(Adafruit_PWMServoDriver &pwm, const uint16_t (&pixels)[noOfPixel]) : pwm(pwm) {
+      for (size_t i = 0; i < noOfPixel; i++)
+        pixel[i] = pixels[i];
+      allChannels = isAllChannels();
+    }
+
     void begin() {}   // no need, the pwm needs one begin only.
     
     void digWrite(uint8_t newState) {
+      if (allChannels) {
+        PCA9685::allWrite(pwm, newState);
+        return;
+      }
       for (size_t i = 0; i < noOfPixel; i++)
-        digWrite(pixel[i], newState);
+        digWrite(i, newState);
     }
     
     void digWrite(size_t actual, uint8_t newState) {
@@ -87,12 +216,13 @@ class PCA9685Group {
     @todo rework according https://learn.adafruit.com/led-tricks-gamma-correction/the-quick-fix
 */
     void pwmWrite(uint8_t value) {
+      if (allChannels && PCA9685::allPwmWrite(pwm, value)) return;
       for (size_t i = 0; i < noOfPixel; i++)
-        pwmWrite(pixel[i], value);        
+        pwmWrite(i, value);        
     }
 
     void pwmWrite(size_t actual, uint8_t value) {
-      pwm.setPWM(pixel[actual], 0, value * 16);
+      PCA9685::channelPwmWrite(pwm, pixel[actual], value);
     } 
 };
 
@@ -9,11 +9,13 @@
   copyright 2022 noiasca noiasca@yahoo.com
   
   Version
+  2026-10-18       inputs with INT line, ButtonPCF8574
   2022-12-19       added multi effect
   2022-04-16       initial version
 */
 
 #pragma once
+#include <Noiasca_button.h>
 
 /**  
     \brief PCF8574 Expander Hardware class
@@ -29,6 +31,17 @@ class PCF8574expander
     TwoWire *i2cPort;				           // generic connection to user's chosen I2C hardware
     const uint8_t i2cAddr;             // I2C address of expander
     uint8_t pinStatus = 0;             // stores io state of expander pins to make them available in parallel instances
+    uint8_t inputMask = 0;             // pins used as input, they are always written HIGH (quasi-bidirectional)
+    uint8_t inputStatus = 0;           // last read state of the input pins
+    volatile bool inputEvent = false;  // set by inputInterrupt() or a new input pin, the port needs a read
+    using Callback = void (*)(uint8_t pin, uint8_t value);  // signature of the callback for input changes
+    Callback cbInputChange = nullptr;  // gets called for each input pin which has changed
+
+    void writePort() {
+      i2cPort->beginTransmission(i2cAddr);
+      i2cPort->write(pinStatus | inputMask);
+      i2cPort->endTransmission();
+    }
 
   public:
 /**
@@ -55,9 +68,88 @@ class PCF8574expander
         bitClear(pinStatus, pin);
       else 
         bitSet(pinStatus, pin);
-      i2cPort->beginTransmission(i2cAddr);
-      i2cPort->write(pinStatus);
-      i2cPort->endTransmission();
+      writePort();
+    }
+
+/**
+   \brief use a pin as input
+   
+   An input pin is written HIGH (weak pullup) and not touched by digitalWrite().
+   The INT line (open drain, needs a pullup) goes LOW if an input changes.
+   Call inputInterrupt() from its interrupt service routine on the FALLING edge.
+   A write to the port resets INT, but the edge has already set the flag,
+   so output writes don't cause a read.
+   @param pin the pin 0..7
+   @param mode INPUT or OUTPUT
+*/
+    void pinMode(uint8_t pin, uint8_t mode)
+    {
+      if (pin > 7) return;
+      if (mode == OUTPUT)
+        bitClear(inputMask, pin);
+      else {
+        bitSet(inputMask, pin);
+        inputEvent = true;                       // the state of the new input is not known yet
+      }
+      writePort();
+    }
+
+/**
+   \brief an input has changed
+   
+   Call this from the interrupt service routine of the INT line. It only sets a flag.
+*/
+    void inputInterrupt()
+    {
+      inputEvent = true;
+    }
+
+/**
+   \brief set the callback for input changes
+   
+   @param cbInputChange the callback gets the pin and the new value
+*/
+    void setOnInputChange(Callback cbInputChange)
+    {
+      this->cbInputChange = cbInputChange;
+    }
+
+/**
+   \brief read the inputs if the INT line has fired
+   
+   One read of one byte for all pins. 
+   Changed inputs are reported to the callback.
+   Call this in loop() before the updates of the buttons.
+   Without an INT line use updateInputs(true) to read anyway.
+   @param force read even if there was no interrupt
+   @return a bitmask of the changed inputs
+*/
+    uint8_t updateInputs(bool force = false)
+    {
+      if (!inputEvent && !force) return 0;
+      inputEvent = false;
+      if (i2cPort->requestFrom(i2cAddr, (uint8_t)1) != 1) return 0;
+      uint8_t reading = i2cPort->read() & inputMask;
+      uint8_t changed = reading ^ inputStatus;
+      inputStatus = reading;
+      if (cbInputChange) {
+        for (uint8_t i = 0; i < 8; i++) {
+          if (bitRead(changed, i)) cbInputChange(i, bitRead(reading, i));
+        }
+      }
+      return changed;
+    }
+
+/**
+   \brief state of an input from the last read
+   
+   @param pin the pin 0..7
+   @return HIGH or LOW
+*/
+    int digitalRead(uint8_t pin)
+    {
+      if (pin > 7) return LOW;
+      return bitRead(inputStatus, pin) ? HIGH : LOW;
     }
     
 /**
@@ -84,6 +176,45 @@ class PCF8574expander
 };
 
 
+/**
+   \brief a button on a PCF8574 input
+   
+   Works like Button. The state comes from the last PCF8574expander::updateInputs(),
+   so reading a button doesn't cause any I2C traffic.
+   The pin is pulled up by the PCF8574, the button should connect to GND.
+*/
+class ButtonPCF8574 : public Button
+{
+    PCF8574expander &pcf8574;
+
+  protected:
+    int readPin() override
+    {
+      return pcf8574.digitalRead(buttonPin);
+    }
+
+  public:
+/**
+   @param pcf8574 a reference to your expander object
+   @param pin the pin 0..7 on the expander
+   @param active LOW (default) if the button connects to GND
+**/
+    ButtonPCF8574(PCF8574expander &pcf8574, uint8_t pin, bool active = LOW) : Button(pin, active), pcf8574(pcf8574) {}
+
+/**
+    \brief set the pin to input
+    
+    Call this function in your setup().
+*/
+    void begin()
+    {
+      pcf8574.pinMode(buttonPin, INPUT);
+      pcf8574.updateInputs(true);
+      if (readPin() == active) lastButtonState = HIGH;
+    }
+};
+
+
 /*  **************************************************
     Interface classes between Hardware and Effects
     to unify the access to outputs    
@@ -9,11 +9,15 @@
   copyright 2022 noiasca noiasca@yahoo.com
   
   Version
+  2026-10-18       DiscretePin: hardware fade on ESP32 LEDC
   2022-12-19       added multi effect
   2022-12-19       extract discrete pins in separate file
 */
 
 #pragma once
+#ifdef ARDUINO_ARCH_ESP32
+#include <driver/ledc.h>
+#endif
 
 /*  **************************************************
     Hardware classes 
@@ -30,12 +34,16 @@ class DiscretePin {
     const bool active;                 // is the pin active HIGH
   public:
 #ifdef ARDUINO_ARCH_ESP32
+    static constexpr bool hasHardwareFade = true;   // the LEDC can fade on its own
     static byte nextChannel;           // keep track of total number of pins
+    static bool fadeInstalled;         // the LEDC fade service is running
     const byte ledChannel;             // will be set to channel
  
     DiscretePin(uint8_t pin, bool active = HIGH) : 
       pin(pin), active(active), ledChannel(nextChannel++) {}
 #else
+    static constexpr bool hasHardwareFade = false;
+    
     DiscretePin(uint8_t pin, bool active = HIGH) : 
       pin(pin), active(active) {}
 #endif  
@@ -87,6 +95,37 @@ class DiscretePin {
 #endif
     }
     
+/**
+   \brief fade linear to a new duty
+   
+   The LEDC runs the fade, the function returns immediately.
+   Writes to this pin wait until the fade has ended. 
+   \param target the duty at the end of the fade
+   \param duration the duration of the fade in ms
+   \return false if the fade can't be done in hardware
+*/
+    bool fadeTo(uint16_t target, uint32_t duration)
+    {
+#ifdef ARDUINO_ARCH_ESP32
+      if (ledChannel >= 16) return false;
+      if (!fadeInstalled)
+      {
+        esp_err_t err = ledc_fade_func_install(0);
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;   // INVALID_STATE: already installed
+        fadeInstalled = true;
+      }
+      // same mapping as ledcSetup(): channel 0-7 high speed, 8-15 low speed
+      ledc_mode_t mode = (ledc_mode_t)(ledChannel / 8);
+      ledc_channel_t channel = (ledc_channel_t)(ledChannel % 8);
+      if (ledc_set_fade_with_time(mode, channel, target, duration) != ESP_OK) return false;
+      return ledc_fade_start(mode, channel, LEDC_FADE_NO_WAIT) == ESP_OK;
+#else
+      (void)target;
+      (void)duration;
+      return false;
+#endif
+    }
+    
     // empty implementation - discrete pin has no color
     void setOnColor(uint32_t _onColor)
     {
@@ -102,8 +141,14 @@ class DiscretePin {
 
 #ifdef ARDUINO_ARCH_ESP32
 byte DiscretePin::nextChannel = 0;  // initialize outside of class
+bool DiscretePin::fadeInstalled = false;
 #endif
 
+template<>
+struct OutputTraits<DiscretePin> : OutputTraitsBase<DiscretePin> {
+  static constexpr bool hardwareFade = DiscretePin::hasHardwareFade;
+};
+
 /*
    class to encapsulate a group of discrete Arduino pins into a object
    and to offer a unified interface
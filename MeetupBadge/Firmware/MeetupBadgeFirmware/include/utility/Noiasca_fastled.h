@@ -9,6 +9,7 @@
   copyright 2022 noiasca noiasca@yahoo.com
   
   Version
+  2026-10-18       OutputTraits: pixel groups have colors
   2022-12-19       added multi effect
   2022-04-15       initial version
 */
@@ -149,6 +150,12 @@ class Fastled_IFGroup {
     }   
 };
 
+// each pixel of the group has its own on color
+template<size_t noOfPixel>
+struct OutputTraits<Fastled_IFGroup<noOfPixel>> : OutputTraitsBase<Fastled_IFGroup<noOfPixel>> {
+  static constexpr bool hasColor = true;
+};
+
 /* **************************************************************
   wrapper make to make the interface more 
   userfriendly
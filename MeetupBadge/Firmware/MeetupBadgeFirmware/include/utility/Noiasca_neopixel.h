@@ -7,6 +7,12 @@
   copyright 2022 noiasca noiasca@yahoo.com
   
   Version
+  2026-10-18       NeoPalettePixel dims with the palette entry
+  2026-10-18       HueCyclePixel, RainbowPixel
+  2026-10-18       NeoPaletteStrip: palette indexed frame with 4 or 8 bit per pixel
+  2026-10-18       OutputTraits: pixel groups have colors for the Sequencer
+  2026-10-18       ScannerPixel, NeoPixelGroup of consecutive pixels
+  2026-10-18       NeoStripManager: several chains, show only changed chains
   2022-12-19       added multi effect
   2022-02-15       OnOffPixel
   2022-02-12 0.0.2 split Neopixel from main library
@@ -16,39 +22,325 @@
 
 #pragma once
 #include <Adafruit_NeoPixel.h> 
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#ifndef NEOSTRIP_MAX_CHAINS
+#define NEOSTRIP_MAX_CHAINS 4          // physical chains (data lines) per manager
+#endif
+
+/*
+   a buffer which must be copied into the strip before show(), 
+   e.g. a palette indexed frame
+*/
+class NeoFrameSource {
+  public:
+    virtual void expand(uint16_t first, uint16_t last) = 0;   // write pixels first..last into the strip
+};
+
+/*
+   class to administrate one or more strips (physical chains).
+   Pixels attached to a manager don't call show() on each write, 
+   they only mark their chain dirty. The manager pushes the dirty chains 
+   once per frame. Chains without changes are not sent at all.
+*/
+class NeoStripManager {
+  protected:
+    struct Chain {
+      Adafruit_NeoPixel *strip;
+      uint16_t dirtyFirst;             // dirty segment on this chain
+      uint16_t dirtyLast;
+      NeoFrameSource *source;          // expands into the strip on commit, if set
+#ifdef ARDUINO_ARCH_ESP32
+      TaskHandle_t task;               // sender task in concurrent mode
+#endif
+    } chain[NEOSTRIP_MAX_CHAINS];
+    uint8_t noOfChains = 0;
+    uint16_t frameInterval = 20;       // minimum time between two frames in ms
+    uint32_t previousMillis = millis();
+#ifdef ARDUINO_ARCH_ESP32
+    TaskHandle_t caller = nullptr;     // the task waiting in show()
+    bool concurrent = false;
+
+    static void sendTask(void *arg) {
+      NeoStripManager *manager = static_cast<NeoStripManager *>(arg);
+      uint8_t i = 0;
+      while (manager->chain[i].task != xTaskGetCurrentTaskHandle()) i++;
+      for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        manager->chain[i].strip->show();
+        xTaskNotifyGive(manager->caller);
+      }
+    }
+#endif
+
+    void clean(uint8_t i) {
+      chain[i].dirtyFirst = 0xFFFF;
+      chain[i].dirtyLast = 0;
+    }
+
+    // bring the strip buffer up to date before it gets sent
+    void commit(uint8_t i) {
+      if (chain[i].source) chain[i].source->expand(chain[i].dirtyFirst, chain[i].dirtyLast);
+      clean(i);
+    }
+
+  public:
+    NeoStripManager() {}
+    
+/**
+   @param chainA the strip object of chain 0
+   @note the chains must exist before pixels are attached to them. 
+   Use the constructors if the pixels are global objects.
+**/
+    NeoStripManager(Adafruit_NeoPixel &chainA) {
+      add(chainA);
+    }
+
+/**
+   @param chainA the strip object of chain 0
+   @param chainB the strip object of chain 1
+**/
+    NeoStripManager(Adafruit_NeoPixel &chainA, Adafruit_NeoPixel &chainB) {
+      add(chainA);
+      add(chainB);
+    }
+
+/**
+   @param chainA the strip object of chain 0
+   @param chainB the strip object of chain 1
+   @param chainC the strip object of chain 2
+**/
+    NeoStripManager(Adafruit_NeoPixel &chainA, Adafruit_NeoPixel &chainB, Adafruit_NeoPixel &chainC) {
+      add(chainA);
+      add(chainB);
+      add(chainC);
+    }
+
+/**
+   \brief add a chain
+   
+   \param strip the strip object of the chain
+   \return the chain number to be used for the pixels, -1 if there is no space left
+*/
+    int8_t add(Adafruit_NeoPixel &strip) {
+      if (noOfChains >= NEOSTRIP_MAX_CHAINS) return -1;
+      chain[noOfChains].strip = &strip;
+      chain[noOfChains].source = nullptr;
+#ifdef ARDUINO_ARCH_ESP32
+      chain[noOfChains].task = nullptr;
+#endif
+      clean(noOfChains);
+      return noOfChains++;
+    }
+
+/**
+   \brief send chains in parallel
+   
+   ESP32 only: each chain gets its own sender task, 
+   show() starts all dirty chains at once and waits for the slowest one.
+   Each chain needs its own RMT channel.
+   Call once in setup() after all chains are added.
+*/
+    void beginConcurrent() {
+#ifdef ARDUINO_ARCH_ESP32
+      for (uint8_t i = 0; i < noOfChains; i++) {
+        if (!chain[i].task) 
+          xTaskCreatePinnedToCore(sendTask, "neochain", 2048, this, 2, &chain[i].task, 0);
+      }
+      concurrent = true;
+#endif
+    }
+
+/**
+   \brief attach a frame buffer to a chain
+   
+   The dirty pixels of the buffer get expanded into the strip before the chain is sent.
+   \param i the chain
+   \param source the frame buffer
+*/
+    void attach(uint8_t i, NeoFrameSource &source) {
+      chain[i].source = &source;
+    }
+
+    Adafruit_NeoPixel &getStrip(uint8_t i) {
+      return *chain[i].strip;
+    }
+
+/**
+   \brief mark a pixel as changed
+*/
+    void markDirty(uint8_t i, uint16_t pixel) {
+      if (pixel < chain[i].dirtyFirst) chain[i].dirtyFirst = pixel;
+      if (pixel > chain[i].dirtyLast) chain[i].dirtyLast = pixel;
+    }
+
+    bool isDirty(uint8_t i) {
+      return chain[i].dirtyFirst != 0xFFFF;
+    }
+
+/**
+   \brief set the frame interval
+   
+   \param newInterval minimum time between two frames in ms
+*/
+    void setFrameInterval(uint16_t newInterval) {
+      frameInterval = newInterval;
+    }
+
+/**
+   \brief push all dirty chains now
+*/
+    void show() {
+#ifdef ARDUINO_ARCH_ESP32
+      if (concurrent) {
+        uint8_t started = 0;
+        caller = xTaskGetCurrentTaskHandle();
+        for (uint8_t i = 0; i < noOfChains; i++) {
+          if (isDirty(i)) {
+            commit(i);
+            xTaskNotifyGive(chain[i].task);
+            started++;
+          }
+        }
+        // the pixel buffers must not change while they are sent
+        while (started--) ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+        return;
+      }
+#endif
+      for (uint8_t i = 0; i < noOfChains; i++) {
+        if (isDirty(i)) {
+          commit(i);
+          chain[i].strip->show();
+        }
+      }
+    }
+
+/**
+   \brief check if update is necessary
+   
+   This is the "run" function. Call this function in loop() after the effects.
+   Sends the dirty chains at most once per frame interval.
+   \param currentMillis you can handover a millis timestamp
+*/
+    void update(uint32_t currentMillis = millis()) {
+      if (currentMillis - previousMillis >= frameInterval) {
+        previousMillis = currentMillis;
+        show();
+      }
+    }
+
+/**
+   \brief time to send a chain
+   
+   Model for WS2812: 8 bits per byte at 1.25 us plus a 300 us latch.
+   \param pixels number of pixels on the chain
+   \param bytesPerPixel 3 for RGB, 4 for RGBW
+   \return the transmission time in us
+*/
+    static uint32_t transmitMicros(uint16_t pixels, uint8_t bytesPerPixel = 3) {
+      return (uint32_t)pixels * bytesPerPixel * 10 + 300;   // 8 * 1.25 us = 10 us per byte
+    }
+
+/**
+   \brief estimated time for the next show()
+   
+   \param parallel true for concurrent sending (the slowest chain counts), false for one after the other
+   \return the estimated time in us for the currently dirty chains
+*/
+    uint32_t estimateShowMicros(bool parallel) {
+      uint32_t total = 0;
+      for (uint8_t i = 0; i < noOfChains; i++) {
+        if (!isDirty(i)) continue;
+        uint32_t t = transmitMicros(chain[i].strip->numPixels());
+        if (parallel) { 
+          if (t > total) total = t;
+        }
+        else 
+          total += t;
+      }
+      return total;
+    }
+};
 
 /*
    class to encapsulate a pixel on a Neostrip into object
    and to offer a unified interface
+   
+   The class keeps a shadow of what it has written. Reads come from the shadow
+   and writes of an unchanged color are skipped (no setPixelColor, no show).
+   Therefore the pixel must not be written by other code.
 */
 class NeoPixel {
     Adafruit_NeoPixel &strip;
+    NeoStripManager *manager = nullptr;// if set, the manager will call show()
+    const uint8_t chain = 0;           // chain of the pixel on the manager
     const uint16_t startPixel;         // one pixel of the strip
     uint32_t onColor = 0x808080;       // color when pixel is on
     uint32_t offColor = 0x000000;      // color when pixel is "off" - could be another colour than "black"
+    uint32_t lastColor = 0;            // shadow: color written to startPixel (unscaled)
+    uint8_t written = 0;               // shadow valid for pixel 0..7 (bit 0 = startPixel)
+    uint8_t level = 0;                 // shadow: logical state of pixel 0..7
+
+    void show(uint16_t pixel) {
+      if (manager) manager->markDirty(chain, pixel); else strip.show();
+    }
+
+    // startPixel, any color
+    void write(uint32_t color) {
+      if ((written & 1) && color == lastColor) return;
+      lastColor = color;
+      written |= 1;
+      if (color == offColor) level &= ~1; else level |= 1;
+      strip.setPixelColor(startPixel, color);
+      show(startPixel);
+    }
 
   public:
     NeoPixel(Adafruit_NeoPixel &strip, uint16_t startPixel) : strip(strip), startPixel(startPixel) {}
+    
+    NeoPixel(NeoStripManager &manager, uint8_t chain, uint16_t startPixel) : 
+      strip(manager.getStrip(chain)), manager(&manager), chain(chain), startPixel(startPixel) {}
 
     void begin() {} // no need, the strip needs one begin only.
     
 
     void digWrite(uint8_t val) {
-      if (val == 0) strip.setPixelColor(startPixel, offColor); else strip.setPixelColor(startPixel, onColor);
-      strip.show();
+      write(val == 0 ? offColor : onColor);
     }
     
     void digWrite(uint8_t pixel, uint8_t val) {
+      if (pixel == 0) {
+        digWrite(val);
+        return;
+      }
+      uint8_t mask = (pixel < 8) ? 1 << pixel : 0;   // shadow for the first 8 pixels only
+      if ((written & mask) && ((level & mask) != 0) == (val != 0)) return;
+      written |= mask;
+      if (val == 0) level &= ~mask; else level |= mask;
       if (val == 0) strip.setPixelColor(startPixel + pixel, offColor); else strip.setPixelColor(startPixel + pixel, onColor);
-      strip.show();
+      show(startPixel + pixel);
     }
 
+/**
+   \brief the logical state from the shadow
+   
+   @return LOW if the pixel shows the off color (or was never written), HIGH otherwise
+*/
     int digRead() {
-      if (strip.getPixelColor(startPixel) == offColor)
-        return LOW;
-      else
-        return HIGH;
+      return (level & 1) ? HIGH : LOW;
     }    
+
+/**
+   \brief the color written last
+   
+   @return the color before the brightness scaling of the strip
+*/
+    uint32_t getColor() {
+      return lastColor;
+    }
 /*
     
     @todo rework according https://learn.adafruit.com/led-tricks-gamma-correction/the-quick-fix
@@ -60,17 +352,19 @@ class NeoPixel {
       r = r * pwm / 255;
       g = g * pwm / 255;
       b = b * pwm / 255;
-      uint32_t color = strip.Color(r, g, b);
-      strip.setPixelColor(startPixel, color);
-      strip.show();
+      write(strip.Color(r, g, b));
     }
 
     void setOnColor(uint32_t _onColor) {
+      if (onColor != _onColor) written &= 1;     // other pixels: same state needs a new write
       onColor = _onColor;
     }
    
     void setOffColor(uint32_t _offColor) {
+      if (offColor != _offColor) written &= 1;
       offColor = _offColor;
+      if (!(written & 1)) return;                // never written: stays LOW
+      if (lastColor == offColor) level &= ~1; else level |= 1;
     }
 };
 
@@ -81,14 +375,61 @@ class NeoPixel {
 template<size_t noOfPixel>
 class NeoPixelGroup {
     Adafruit_NeoPixel &strip;          // the strip object to be used
+    NeoStripManager *manager = nullptr;// if set, the manager will call show()
+    const uint8_t chain = 0;           // chain of the pixels on the manager
     uint16_t pixel[noOfPixel];         // pixel index on strip
     uint32_t onColor[noOfPixel];       // on color for each pixel
     uint32_t offColor = 0x000000;      // one "off" color for all
+    uint32_t lastColor[noOfPixel];     // shadow: color written to each pixel (unscaled)
+    uint8_t written[(noOfPixel + 7) / 8] {0};  // shadow valid for pixel
+
+    void show(uint16_t index) {
+      if (manager) manager->markDirty(chain, index); else strip.show();
+    }
+
+    void write(size_t actual, uint32_t color) {
+      if (actual >= noOfPixel) return;
+      uint8_t mask = 1 << (actual % 8);
+      if ((written[actual / 8] & mask) && lastColor[actual] == color) return;
+      written[actual / 8] |= mask;
+      lastColor[actual] = color;
+      strip.setPixelColor(pixel[actual], color);
+      show(pixel[actual]);
+    }
 
   public:
     NeoPixelGroup(Adafruit_NeoPixel &strip, uint16_t pixelA, uint16_t pixelB, uint16_t pixelC) : strip(strip), pixel{pixelA, pixelB, pixelC} {
       for (auto &i : onColor) i = 0x808080;
     }
+    
+    NeoPixelGroup(NeoStripManager &manager, uint8_t chain, uint16_t pixelA, uint16_t pixelB, uint16_t pixelC) : 
+      strip(manager.getStrip(chain)), manager(&manager), chain(chain), pixel{pixelA, pixelB, pixelC} {
+      for (auto &i : onColor) i = 0x808080;
+    }
+
+/**
+   \brief a group of consecutive pixels
+   
+   @param strip a reference to your strip object
+   @param firstPixel the first pixel of the group, the next noOfPixel-1 pixels will be used also
+**/
+    NeoPixelGroup(Adafruit_NeoPixel &strip, uint16_t firstPixel) : strip(strip) {
+      for (size_t i = 0; i < noOfPixel; i++) pixel[i] = firstPixel + i;
+      for (auto &i : onColor) i = 0x808080;
+    }
+
+/**
+   \brief a group of consecutive pixels on a strip manager
+   
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param firstPixel the first pixel of the group, the next noOfPixel-1 pixels will be used also
+**/
+    NeoPixelGroup(NeoStripManager &manager, uint8_t chain, uint16_t firstPixel) : 
+      strip(manager.getStrip(chain)), manager(&manager), chain(chain) {
+      for (size_t i = 0; i < noOfPixel; i++) pixel[i] = firstPixel + i;
+      for (auto &i : onColor) i = 0x808080;
+    }
 
     void begin() {}   // no need, the strip needs one begin only.
     
@@ -97,12 +438,22 @@ class NeoPixelGroup {
     }
     
     void digWrite(size_t actual, uint8_t newState) {
-      if (newState == 0) strip.setPixelColor(pixel[actual], offColor); else strip.setPixelColor(pixel[actual], onColor[actual]);
-      strip.show();
+      write(actual, newState == 0 ? offColor : onColor[actual]);
     }
 
     // a read for group of pixels doesn't make sense
     //int digRead(){}    
+
+/**
+   \brief the logical state of one pixel from the shadow
+   
+   @param actual the index in the group
+   @return LOW if the pixel shows the off color (or was never written), HIGH otherwise
+*/
+    int digRead(size_t actual) {
+      if (actual >= noOfPixel || !(written[actual / 8] & (1 << (actual % 8)))) return LOW;
+      return lastColor[actual] == offColor ? LOW : HIGH;
+    }
 /*
     
     @todo rework according https://learn.adafruit.com/led-tricks-gamma-correction/the-quick-fix
@@ -118,20 +469,257 @@ class NeoPixelGroup {
       r = r * pwm / 255;
       g = g * pwm / 255;
       b = b * pwm / 255;
-      uint32_t color = strip.Color(r, g, b);
-      strip.setPixelColor(pixel[actual], color);
-      strip.show();
+      write(actual, strip.Color(r, g, b));
     }
 
     void setOnColor(uint16_t actual, uint32_t _onColor) {
       onColor[actual] = _onColor;
     }
+
+    // one on color for all pixels of the group
+    void setOnColor(uint32_t _onColor) {
+      for (auto &i : onColor) i = _onColor;
+    }
    
     void setOffColor(uint32_t _offColor) {
       offColor = _offColor;
     }   
 };
 
+// each pixel of the group has its own on color
+template<size_t noOfPixel>
+struct OutputTraits<NeoPixelGroup<noOfPixel>> : OutputTraitsBase<NeoPixelGroup<noOfPixel>> {
+  static constexpr bool hasColor = true;
+};
+
+/*
+   a frame of pixels as palette indexes
+   
+   Each pixel needs 4 or 8 bit instead of a color. The palette has 16 or 256 colors.
+   The indexes get expanded to the colors of the strip when the frame is committed,
+   only the dirty pixels are expanded. A new palette changes the colors of the whole 
+   strip and costs the size of the palette, the strip gets expanded with the next frame.
+   
+   This does not save RAM: Adafruit_NeoPixel keeps its buffer of 3 byte per pixel
+   in any case, the index frame and the palette come on top of it.
+   What it saves is work: effects write one index per pixel and 
+   a color change of the palette recolors all its pixels without touching them.
+   
+   \tparam bits 4 or 8 bit per pixel
+   \tparam noOfPixel pixels in the frame, starting with pixel 0 of the strip
+*/
+template<uint8_t bits, uint16_t noOfPixel>
+class NeoPaletteStrip : public NeoFrameSource {
+    static_assert(bits == 4 || bits == 8, "a palette index has 4 or 8 bit");
+    static constexpr uint16_t noOfColors = 1 << bits;
+    Adafruit_NeoPixel &strip;
+    NeoStripManager *manager = nullptr;// if set, the manager will call show()
+    const uint8_t chain = 0;           // chain of the frame on the manager
+    uint8_t index[(noOfPixel * bits + 7) / 8] {0};   // palette index of each pixel
+    uint32_t palette[noOfColors] {0};  // the colors
+    uint16_t dirtyFirst = 0;           // dirty segment if there is no manager
+    uint16_t dirtyLast = noOfPixel - 1;
+
+    void markDirty(uint16_t first, uint16_t last) {
+      if (manager) {
+        manager->markDirty(chain, first);
+        manager->markDirty(chain, last);
+        return;
+      }
+      if (first < dirtyFirst) dirtyFirst = first;
+      if (last > dirtyLast) dirtyLast = last;
+    }
+
+  public:
+/**
+   @param strip a reference to your strip object
+**/
+    NeoPaletteStrip(Adafruit_NeoPixel &strip) : strip(strip) {}
+
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+**/
+    NeoPaletteStrip(NeoStripManager &manager, uint8_t chain) : 
+      strip(manager.getStrip(chain)), manager(&manager), chain(chain) {
+      manager.attach(chain, *this);
+    }
+
+/**
+   \brief the palette index of a pixel
+*/
+    uint8_t getPixel(uint16_t pixel) {
+      if (pixel >= noOfPixel) return 0;
+      if (bits == 8) return index[pixel];
+      return (index[pixel / 2] >> ((pixel & 1) * 4)) & 0x0F;
+    }
+
+/**
+   \brief set the palette index of a pixel
+   
+   \param pixel the pixel on the strip
+   \param entry the palette entry
+*/
+    void setPixel(uint16_t pixel, uint8_t entry) {
+      if (pixel >= noOfPixel || getPixel(pixel) == entry) return;
+      if (bits == 8) {
+        index[pixel] = entry;
+      }
+      else {
+        uint8_t shift = (pixel & 1) * 4;
+        index[pixel / 2] = (index[pixel / 2] & ~(0x0F << shift)) | ((entry & 0x0F) << shift);
+      }
+      markDirty(pixel, pixel);
+    }
+
+/**
+   \brief set all pixels to one palette entry
+*/
+    void fill(uint8_t entry) {
+      uint8_t value = (bits == 8) ? entry : (entry & 0x0F) * 0x11;
+      for (auto &i : index) i = value;
+      markDirty(0, noOfPixel - 1);
+    }
+
+/**
+   \brief change one color of the palette
+   
+   \param entry the palette entry
+   \param color the new color
+*/
+    void setPaletteColor(uint8_t entry, uint32_t color) {
+      if (entry >= noOfColors || palette[entry] == color) return;
+      palette[entry] = color;
+      markDirty(0, noOfPixel - 1);
+    }
+
+    uint32_t getPaletteColor(uint8_t entry) {
+      return (entry < noOfColors) ? palette[entry] : 0;
+    }
+
+/**
+   \brief load a palette from flash
+   
+   \param colors a table of colors in PROGMEM
+   \param count the number of colors, starting with entry 0
+*/
+    void setPalette(const uint32_t *colors, uint16_t count) {
+      if (count > noOfColors) count = noOfColors;
+      for (uint16_t i = 0; i < count; i++) palette[i] = pgm_read_dword(&colors[i]);
+      markDirty(0, noOfPixel - 1);
+    }
+
+/**
+   \brief write the colors of pixels first..last into the strip
+*/
+    void expand(uint16_t first, uint16_t last) override {
+      if (last >= noOfPixel) last = noOfPixel - 1;
+      for (uint16_t i = first; i <= last && i < noOfPixel; i++) strip.setPixelColor(i, palette[getPixel(i)]);
+    }
+
+/**
+   \brief expand the dirty pixels and send the strip
+   
+   Only needed if the frame is not on a strip manager.
+*/
+    void show() {
+      if (manager) {
+        manager->show();
+        return;
+      }
+      if (dirtyFirst > dirtyLast) return;
+      expand(dirtyFirst, dirtyLast);
+      dirtyFirst = 0xFFFF;
+      dirtyLast = 0;
+      strip.show();
+    }
+};
+
+/*
+   class to encapsulate a pixel of a palette frame into object
+   and to offer a unified interface
+   
+   The on and off colors are palette entries. 
+   pwmWrite scales the color of the on entry by the level, so all pixels 
+   showing this entry dim together. Give a pixel an entry of its own to dim it alone.
+   Full on or a digWrite brings back the color the entry had before.
+   \tparam S a NeoPaletteStrip
+*/
+template<class S>
+class NeoPalettePixel {
+    S &frame;
+    const uint16_t startPixel;         // one pixel of the frame
+    uint8_t onIndex = 1;               // palette entry when pixel is on
+    uint8_t offIndex = 0;              // palette entry when pixel is off
+    uint32_t onColor = 0;              // color of the on entry before it was dimmed
+    bool dimmed = false;               // the on entry holds a scaled onColor
+
+    // give the on entry its color back
+    void undim() {
+      if (!dimmed) return;
+      frame.setPaletteColor(onIndex, onColor);
+      dimmed = false;
+    }
+
+  public:
+    NeoPalettePixel(S &frame, uint16_t startPixel) : frame(frame), startPixel(startPixel) {}
+
+    void begin() {} // no need, the strip needs one begin only.
+
+    void digWrite(uint8_t val) {
+      if (val != 0) undim();
+      frame.setPixel(startPixel, val == 0 ? offIndex : onIndex);
+    }
+    
+    void digWrite(uint8_t pixel, uint8_t val) {
+      if (val != 0) undim();
+      frame.setPixel(startPixel + pixel, val == 0 ? offIndex : onIndex);
+    }
+
+    int digRead() {
+      return frame.getPixel(startPixel) == offIndex ? LOW : HIGH;
+    }
+
+    void pwmWrite(int pwm) {
+      if (pwm <= 0 || pwm >= 255) {
+        digWrite(pwm > 0 ? HIGH : LOW);
+        return;
+      }
+      if (!dimmed) {
+        onColor = frame.getPaletteColor(onIndex);
+        dimmed = true;
+      }
+      uint8_t r = onColor >> 16;
+      uint8_t g = (onColor & 0xFF00) >> 8;
+      uint8_t b = onColor & 0xFF;
+      r = r * pwm / 255;
+      g = g * pwm / 255;
+      b = b * pwm / 255;
+      frame.setPaletteColor(onIndex, (uint32_t)r << 16 | (uint32_t)g << 8 | b);
+      frame.setPixel(startPixel, onIndex);
+    }
+
+/**
+   \brief set the on color
+   
+   \param entry the palette entry for on
+*/
+    void setOnColor(uint32_t entry) {
+      if (entry == onIndex) return;
+      undim();
+      onIndex = entry;
+    }
+
+/**
+   \brief set the off color
+   
+   \param entry the palette entry for off
+*/
+    void setOffColor(uint32_t entry) {
+      offIndex = entry;
+    }
+};
+
 /* **************************************************************
   wrapper make to make the interface more 
   userfriendly
@@ -151,6 +739,12 @@ class AlternatingPixel : public Alternating<NeoPixel> {
    @param pixel the first of two pixels on the strip to be used (also the next pixel will be used!)
 **/
     AlternatingPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Alternating(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    AlternatingPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Alternating(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -167,6 +761,12 @@ class BlinkPixel : public Blink<NeoPixel> {
    @param pixel the pixel on the strip to be used 
 **/
     BlinkPixel(Adafruit_NeoPixel &strip, byte pixel) : Blink(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    BlinkPixel(NeoStripManager &manager, uint8_t chain, byte pixel) : Blink(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -185,6 +785,84 @@ class Bounce5Pixel : public Bounce5<NeoPixel> {
    @param pixel the first of 5 pixels on the strip to be used 
 **/
     Bounce5Pixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Bounce5(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    Bounce5Pixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Bounce5(neoPixel), neoPixel(manager, chain, pixel) {};
+};
+
+/**
+   \brief running light over N Neopixel
+   
+   wrapper for a Scanner on N consecutive Neopixel, e.g. a full LED ring.
+   Inherits "style" class and composites NeoPixelGroup
+   \tparam N number of pixels
+   \tparam pattern SCAN_BOUNCE or SCAN_WRAP
+   \tparam tail number of dimmed pixels behind the head
+*/
+template<uint8_t N, ScanPattern pattern = SCAN_BOUNCE, uint8_t tail = 0>
+class ScannerPixel : public Scanner<NeoPixelGroup<N>, N, pattern, tail> {
+    NeoPixelGroup<N> neoPixel;
+  public:
+/**
+   @param strip a reference to your strip object
+   @param pixel the first of N pixels on the strip to be used 
+**/
+    ScannerPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Scanner<NeoPixelGroup<N>, N, pattern, tail>(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the first of N pixels on the chain to be used 
+**/
+    ScannerPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Scanner<NeoPixelGroup<N>, N, pattern, tail>(neoPixel), neoPixel(manager, chain, pixel) {};
+};
+
+/**
+   \brief rotate the hue of a Neopixel
+   
+   wrapper for a color cycling Neopixel.
+   Inherits "style" class and composites NeoPixel
+*/
+class HueCyclePixel : public HueCycle<NeoPixel> {
+    NeoPixel neoPixel;
+  public:
+/**
+   @param strip a reference to your strip object
+   @param pixel the pixel on the strip to be used 
+**/
+    HueCyclePixel(Adafruit_NeoPixel &strip, uint16_t pixel) : HueCycle(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    HueCyclePixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : HueCycle(neoPixel), neoPixel(manager, chain, pixel) {};
+};
+
+/**
+   \brief rotating rainbow over N Neopixel
+   
+   wrapper for a Rainbow on N consecutive Neopixel, e.g. a full LED ring.
+   Inherits "style" class and composites NeoPixelGroup
+   \tparam N number of pixels
+*/
+template<uint8_t N>
+class RainbowPixel : public Rainbow<NeoPixelGroup<N>, N> {
+    NeoPixelGroup<N> neoPixel;
+  public:
+/**
+   @param strip a reference to your strip object
+   @param pixel the first of N pixels on the strip to be used 
+**/
+    RainbowPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Rainbow<NeoPixelGroup<N>, N>(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the first of N pixels on the chain to be used 
+**/
+    RainbowPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Rainbow<NeoPixelGroup<N>, N>(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -201,6 +879,12 @@ class EffectPixel : public Effect<NeoPixel> {
    \param pixel the pixel to be used
 **/
     EffectPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Effect(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    EffectPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Effect(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -217,6 +901,12 @@ class FlickerPixel : public Flicker<NeoPixel> {
    @param pixel the pixel on the strip to be used 
 **/
     FlickerPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Flicker(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    FlickerPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Flicker(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -233,6 +923,12 @@ class FluorescentPixel : public Fluorescent<NeoPixel> {
    @param pixel the pixel on the strip to be used 
 **/
     FluorescentPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Fluorescent(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    FluorescentPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Fluorescent(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -249,6 +945,12 @@ class HeartbeatPixel : public Heartbeat<NeoPixel> {
    @param pixel the pixel on the strip to be used 
 **/
     HeartbeatPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Heartbeat(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    HeartbeatPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Heartbeat(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -267,6 +969,12 @@ class OnOffPixel : public OnOff<NeoPixel> {
    @param pixel the pixel on the strip to be used 
 **/
     OnOffPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : OnOff(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    OnOffPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : OnOff(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -283,6 +991,12 @@ class PulsePixel : public Pulse<NeoPixel> {
    @param pixel the pixel on the strip to be used 
 **/
     PulsePixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Pulse(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    PulsePixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Pulse(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -299,6 +1013,12 @@ class RhythmPixel : public Rhythm<NeoPixel> {
    @param pixel the pixel on the strip to be used 
 **/
     RhythmPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Rhythm(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    RhythmPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Rhythm(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -315,6 +1035,12 @@ class SmoothPixel : public Smooth<NeoPixel> {
    @param pixel the pixel on the strip to be used 
 **/
     SmoothPixel(Adafruit_NeoPixel &strip, uint16_t pixel) : Smooth(neoPixel), neoPixel(strip, pixel) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixel the pixel on the chain to be used 
+**/
+    SmoothPixel(NeoStripManager &manager, uint8_t chain, uint16_t pixel) : Smooth(neoPixel), neoPixel(manager, chain, pixel) {};
 };
 
 /**
@@ -334,6 +1060,14 @@ class TrafficlightPixel : public Trafficlight<NeoPixelGroup<3>> {
    @param pixelC the pixel on the strip to be used for green
 **/
     TrafficlightPixel(Adafruit_NeoPixel &strip, byte pixelA, byte pixelB, byte pixelC) : Trafficlight(neoPixel), neoPixel(strip, pixelA, pixelB, pixelC) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixelA the first pixel on the chain
+   @param pixelB the second pixel on the chain
+   @param pixelC the third pixel on the chain
+**/
+    TrafficlightPixel(NeoStripManager &manager, uint8_t chain, byte pixelA, byte pixelB, byte pixelC) : Trafficlight(neoPixel), neoPixel(manager, chain, pixelA, pixelB, pixelC) {};
 };
 
 /**
@@ -353,4 +1087,12 @@ class TurnsignalPixel : public Turnsignal<NeoPixelGroup<3>> {
    @param pixelC the pixel on the strip to be used for hazard light
 **/
     TurnsignalPixel(Adafruit_NeoPixel &strip, byte pixelA, byte pixelB, byte pixelC) : Turnsignal(neoPixel), neoPixel(strip, pixelA, pixelB, pixelC) {};
+/**
+   @param manager a reference to your strip manager
+   @param chain the chain on the manager
+   @param pixelA the first pixel on the chain
+   @param pixelB the second pixel on the chain
+   @param pixelC the third pixel on the chain
+**/
+    TurnsignalPixel(NeoStripManager &manager, uint8_t chain, byte pixelA, byte pixelB, byte pixelC) : Turnsignal(neoPixel), neoPixel(manager, chain, pixelA, pixelB, pixelC) {};
 };
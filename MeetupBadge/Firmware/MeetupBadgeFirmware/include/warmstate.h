@@ -0,0 +1,172 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// warmstate.h
+//
+// Runtime state kept in RTC memory over a reset or deep sleep
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define WARM_MAGIC        0x4D524157UL  // "WARM"
+#define WARM_VERSION      2
+#define WARM_RECENT       8             // uids tapped last
+#define WARM_PHASES       8             // blinking LEDs, one per badge LED
+#define WARM_URL_MAX      128           // QR screen url, longer ones aren't restored
+#define WARM_RESTORE_MAX  2             // warm boots in a row without a clean loop(), then the screen isn't restored
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// What's on the OLED, with what it needs to be drawn again
+enum WarmScreen : uint8_t {
+    WARM_SCREEN_WAITING,              // waiting for a card
+    WARM_SCREEN_CARD,                 // card info, uid is recent[newest]
+    WARM_SCREEN_URL,                  // QR code of url
+    WARM_SCREEN_TAG,                  // event tag, args are action and arg
+    WARM_SCREEN_CHECKPOINT,           // hunt checkpoint, args are verdict, checkpoint and new
+    WARM_SCREEN_LIST,                 // contact list at listPosition
+};
+
+// One blinking LED, the fields of Blink::Phase
+struct WarmPhase {
+    uint8_t state;
+    uint8_t reserved[3];
+    uint32_t elapsed;
+};
+
+struct WarmUid {
+    uint8_t uid[7];
+    uint8_t uidLength;
+};
+
+// ----------------------------------------------------------------------------
+// Everything restored on a warm boot. It lives in RTC slow memory, which
+// keeps its content over a watchdog, panic, brown-out or software reset and
+// over deep sleep, but not over a power cycle. check covers the rest.
+// ----------------------------------------------------------------------------
+struct WarmData {
+    uint32_t magic;                   // WARM_MAGIC
+    uint16_t version;                 // WARM_VERSION
+    uint16_t size;                    // sizeof(WarmData), a changed layout is a cold boot
+
+    // counters, kept from the last cold boot
+    uint32_t seconds;                 // badge time, carries on over warm boots
+    uint32_t taps;
+    uint16_t warmBoots;
+    uint16_t brownouts;
+    uint16_t watchdogs;
+    uint16_t sleeps;
+
+    uint8_t screen;                   // WarmScreen
+    uint8_t args[3];
+    uint32_t listPosition;
+    char url[WARM_URL_MAX];
+
+    WarmPhase phases[WARM_PHASES];
+    WarmUid recent[WARM_RECENT];
+    uint8_t recentNext;
+    uint8_t restores;                 // warm boots since loop() last ran through
+    uint8_t reserved[2];
+
+    uint32_t check;                   // CRC-32 of the fields above
+};
+
+// ----------------------------------------------------------------------------
+// Fast restart after a reset the badge recovers from. begin() decides
+// between a warm boot, the RTC copy checks out and the reset wasn't a power
+// cycle or the reset pin, and a cold one that starts over.
+//
+// A screen that crashes the badge would crash it again when it's restored.
+// After a panic, or WARM_RESTORE_MAX warm boots in a row that never got
+// through loop(), the badge comes back warm but on the waiting screen.
+//
+// The copy is sealed with a CRC only when something in it changed. The
+// set*() calls seal right away, so a crash before the end of loop() doesn't
+// cost the change. save() at the end of loop() catches the time and marks
+// the loop as clean.
+// ----------------------------------------------------------------------------
+class WarmState {
+  public:
+    // check the RTC copy, true for a warm boot
+    bool begin();
+    bool warm() const { return isWarm; }
+    const char* reason() const;
+
+    // warm, but the screen was dropped in case it's what crashed
+    bool safe() const { return isSafe; }
+
+    const WarmData& data() const { return *state; }
+
+    // badge time in seconds, millis() restarts at every boot
+    uint32_t seconds() const { return bootSeconds + millis() / 1000; }
+
+    void setScreen(WarmScreen screen, uint8_t arg0 = 0, uint8_t arg1 = 0, uint8_t arg2 = 0);
+    void setUrl(const char* url);
+    void setList(uint32_t position);
+    void addTap(const uint8_t* uid, uint8_t uidLength);
+    const WarmUid& lastTap() const;
+
+    // keep a blink state, the time into it is only taken when it changes
+    void setPhase(uint8_t led, uint8_t phaseState, uint32_t elapsed);
+
+    // loop() got through, bring the time up to date and seal if anything
+    // changed since the last seal
+    void save();
+
+  private:
+    WarmData* state = nullptr;
+    bool isWarm = false;
+    bool isSafe = false;
+    bool dirty = false;
+    uint8_t resetReason = 0;
+    uint32_t bootSeconds = 0;
+
+    void seal();
+};
+
+extern WarmState warmState;
@@ -0,0 +1,79 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// blocklist.cpp
+//
+// Blocked tags, a Bloom filter built from blocklist.txt
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+#include "blocklist.h"
+#include "blocklist_table.h"    // generated from blocklist.txt by tools/gen_blocklist.py
+#include "uidkey.h"
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : blocklistContains
+// DESCRIPTION : Test the uid against the filter, the probes are double
+//               hashed and mapped onto the filter with a multiply, same as
+//               probes() in the generator
+// ----------------------------------------------------------------------------
+bool blocklistContains(const uint8_t* uid, uint8_t uidLength) {
+    if (BLOCK_KEYS == 0) {
+        return false;
+    }
+
+    UidKey key = uidKey(uid, uidLength);
+    uint32_t h = uidHash(key.hi, key.lo, BLOCK_SEED1);
+    uint32_t step = uidHash(key.hi, key.lo, BLOCK_SEED2) | 1;
+    for (uint8_t i = 0; i < BLOCK_HASHES; i++) {
+        uint32_t bit = ((uint64_t) h * BLOCK_BITS) >> 32;
+        if (!(blockFilter[bit >> 5] & (1UL << (bit & 31)))) {
+            return false;
+        }
+        h += step;
+    }
+    return true;
+}
@@ -0,0 +1,371 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// console.cpp
+//
+// Binary request/response console over the serial port
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#include "console.h"
+
+// ============================================================================
+// Globals
+// ============================================================================
+Console console(Serial);
+
+// CRC-16/CCITT-FALSE, poly 0x1021
+static const uint16_t crcTable[256] PROGMEM = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+// Rates the host may ask for with CONSOLE_CMD_SET_BAUD
+static const uint32_t allowedBaud[] = { 115200, 230400, 460800, 921600, 2000000 };
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::cobsEncode
+// DESCRIPTION : COBS encode len bytes from in, out needs len + len/254 + 1
+//               bytes. Returns the encoded length, the 0x00 delimiter is
+//               not written.
+// ----------------------------------------------------------------------------
+size_t Console::cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t write = 1;
+    size_t codeIdx = 0;
+    uint8_t code = 1;
+
+    for (size_t read = 0; read < len; read++) {
+        if (in[read] == 0) {
+            out[codeIdx] = code;
+            code = 1;
+            codeIdx = write++;
+        } else {
+            out[write++] = in[read];
+            if (++code == 0xFF) {
+                out[codeIdx] = code;
+                code = 1;
+                codeIdx = write++;
+            }
+        }
+    }
+    out[codeIdx] = code;
+    return write;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::cobsDecode
+// DESCRIPTION : Decode one COBS frame (without delimiter). out needs len
+//               bytes. Returns the decoded length, 0 on a malformed frame.
+// ----------------------------------------------------------------------------
+size_t Console::cobsDecode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t read = 0;
+    size_t write = 0;
+
+    while (read < len) {
+        uint8_t code = in[read];
+        if (code == 0 || read + code > len) {
+            return 0;
+        }
+        read++;
+        for (uint8_t i = 1; i < code; i++) {
+            out[write++] = in[read++];
+        }
+        if (code != 0xFF && read != len) {
+            out[write++] = 0;
+        }
+    }
+    return write;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::crc16
+// DESCRIPTION : CRC-16/CCITT-FALSE, pass the previous result to chain blocks
+// ----------------------------------------------------------------------------
+uint16_t Console::crc16(const uint8_t* data, size_t len, uint16_t crc) {
+    while (len--) {
+        crc = (crc << 8) ^ pgm_read_word(&crcTable[((crc >> 8) ^ *data++) & 0xFF]);
+    }
+    return crc;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::begin
+// DESCRIPTION : Start the console. On the ESP32 frames are handled in their
+//               own task so loop() never waits on the host.
+// ----------------------------------------------------------------------------
+void Console::begin() {
+#ifdef ARDUINO_ARCH_ESP32
+    xTaskCreatePinnedToCore(task, "console", CONSOLE_TASK_STACK, this,
+                            CONSOLE_TASK_PRIO, nullptr, CONSOLE_TASK_CORE);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::registerHandler
+// DESCRIPTION : Attach a handler for a command id. The built-in ids and ids
+//               with the response bit set are reserved.
+// ----------------------------------------------------------------------------
+bool Console::registerHandler(uint8_t cmd, ConsoleHandler handler) {
+    if (cmd <= CONSOLE_CMD_SET_BAUD || cmd >= CONSOLE_MAX_HANDLERS || handlers[cmd]) {
+        return false;
+    }
+    handlers[cmd] = handler;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::task
+// DESCRIPTION : Console task body
+// ----------------------------------------------------------------------------
+void Console::task(void* arg) {
+    Console* self = static_cast<Console*>(arg);
+    for (;;) {
+        self->poll();
+#ifdef ARDUINO_ARCH_ESP32
+        vTaskDelay(pdMS_TO_TICKS(2));
+#endif
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::poll
+// DESCRIPTION : Read what the UART has buffered and handle every complete
+//               frame. Pipelined requests are answered back to back.
+// ----------------------------------------------------------------------------
+void Console::poll() {
+    while (port.available() > 0) {
+        uint8_t c = port.read();
+
+        if (c != 0) {
+            if (rxLen < sizeof(rxBuf)) {
+                rxBuf[rxLen++] = c;
+            } else {
+                rxOverflow = true;
+            }
+            continue;
+        }
+
+        // delimiter, anything in front of it is one frame
+        if (rxLen > 0 && !rxOverflow) {
+            uint8_t frame[CONSOLE_MAX_ENCODED];
+            size_t len = cobsDecode(rxBuf, rxLen, frame);
+            if (len > 0) {
+                handleFrame(frame, len);
+            }
+        }
+        rxLen = 0;
+        rxOverflow = false;
+    }
+
+    // the host never talked to us at the new rate, fall back
+    if (baudUnconfirmed && millis() - baudChangedAt > CONSOLE_BAUD_CONFIRM_MS) {
+        baudUnconfirmed = false;
+        applyBaud(previousBaud);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::handleFrame
+// DESCRIPTION : Check and answer one decoded request. Frames with a bad CRC
+//               are dropped silently, the host times out and retries.
+// ----------------------------------------------------------------------------
+void Console::handleFrame(const uint8_t* frame, size_t len) {
+    if (len < 4) {
+        return;
+    }
+    uint16_t crc = frame[len - 2] | (frame[len - 1] << 8);
+    if (crc16(frame, len - 2) != crc) {
+        return;
+    }
+
+    // any good frame at the new rate confirms it
+    baudUnconfirmed = false;
+
+    uint8_t seq = frame[0];
+    uint8_t cmd = frame[1];
+    uint8_t resp[CONSOLE_MAX_PAYLOAD];
+    size_t respLen = sizeof(resp);
+
+    uint8_t status = dispatch(cmd, frame + 2, len - 4, resp, &respLen);
+    if (status != CONSOLE_OK || respLen > sizeof(resp)) {
+        respLen = 0;
+    }
+    sendResponse(seq, cmd, status, resp, respLen);
+
+    if (pendingBaud) {
+        port.flush();                  // the ACK must leave at the old rate
+        previousBaud = baud;
+        applyBaud(pendingBaud);
+        pendingBaud = 0;
+        baudUnconfirmed = true;
+        baudChangedAt = millis();
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::dispatch
+// DESCRIPTION : Built-in commands, everything else goes to a handler
+// ----------------------------------------------------------------------------
+uint8_t Console::dispatch(uint8_t cmd, const uint8_t* req, size_t reqLen, uint8_t* resp, size_t* respLen) {
+    switch (cmd) {
+        case CONSOLE_CMD_PING:
+            if (reqLen > *respLen) {
+                return CONSOLE_ERR_ARGS;
+            }
+            memcpy(resp, req, reqLen);
+            *respLen = reqLen;
+            return CONSOLE_OK;
+
+        case CONSOLE_CMD_INFO: {
+            uint32_t uptime = millis();
+#ifdef ARDUINO_ARCH_ESP32
+            uint32_t heap = ESP.getFreeHeap();
+#else
+            uint32_t heap = 0;
+#endif
+            uint16_t maxPayload = CONSOLE_MAX_PAYLOAD;
+            memcpy(resp + 0, &uptime, 4);
+            memcpy(resp + 4, &heap, 4);
+            memcpy(resp + 8, &baud, 4);
+            memcpy(resp + 12, &maxPayload, 2);
+            *respLen = 14;
+            return CONSOLE_OK;
+        }
+
+        case CONSOLE_CMD_SET_BAUD: {
+            if (reqLen != 4 || pendingBaud) {
+                return CONSOLE_ERR_ARGS;
+            }
+            uint32_t newBaud;
+            memcpy(&newBaud, req, 4);
+            for (uint32_t rate : allowedBaud) {
+                if (rate == newBaud) {
+                    pendingBaud = newBaud;
+                    memcpy(resp, &newBaud, 4);
+                    *respLen = 4;
+                    return CONSOLE_OK;
+                }
+            }
+            return CONSOLE_ERR_ARGS;
+        }
+    }
+
+    if (cmd < CONSOLE_MAX_HANDLERS && handlers[cmd]) {
+        return handlers[cmd](req, reqLen, resp, respLen);
+    }
+    return CONSOLE_ERR_UNKNOWN;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::sendResponse
+// DESCRIPTION : Frame and write one response. The leading delimiter resyncs
+//               the host after plain Serial.println() output.
+// ----------------------------------------------------------------------------
+void Console::sendResponse(uint8_t seq, uint8_t cmd, uint8_t status, const uint8_t* payload, size_t len) {
+    uint8_t frame[CONSOLE_MAX_FRAME];
+    uint8_t out[CONSOLE_MAX_ENCODED + 2];
+
+    frame[0] = seq;
+    frame[1] = cmd | CONSOLE_RESPONSE;
+    frame[2] = status;
+    memcpy(frame + 3, payload, len);
+    uint16_t crc = crc16(frame, len + 3);
+    frame[len + 3] = crc & 0xFF;
+    frame[len + 4] = crc >> 8;
+
+    out[0] = 0;
+    size_t outLen = cobsEncode(frame, len + 5, out + 1) + 1;
+    out[outLen++] = 0;
+    port.write(out, outLen);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Console::applyBaud
+// DESCRIPTION : Switch the UART rate without reinstalling the driver
+// ----------------------------------------------------------------------------
+void Console::applyBaud(uint32_t newBaud) {
+#ifdef ARDUINO_ARCH_ESP32
+    port.updateBaudRate(newBaud);
+#else
+    port.begin(newBaud);
+#endif
+    baud = newBaud;
+}
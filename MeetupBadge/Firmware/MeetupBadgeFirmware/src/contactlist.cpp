@@ -0,0 +1,225 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// contactlist.cpp
+//
+// Scrolling list of the collected contacts on the OLED
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+#include "contactlist.h"
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactList::ContactList
+// DESCRIPTION : Constructor, starts with an empty row cache
+// ----------------------------------------------------------------------------
+ContactList::ContactList(Adafruit_SSD1306& display, ContactStore& store) : display(display), store(store) {
+    for (uint8_t i = 0; i < LIST_CACHE; i++) {
+        cache[i].index = UINT32_MAX;
+        cache[i].used = 0;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactList::refresh
+// DESCRIPTION : Drop the cache if compaction renumbered the records since it
+//               was filled, true if it did
+// ----------------------------------------------------------------------------
+bool ContactList::refresh() {
+    if (store.wear().generation == generation) {
+        return false;
+    }
+    generation = store.wear().generation;
+    for (uint8_t i = 0; i < LIST_CACHE; i++) {
+        cache[i].index = UINT32_MAX;
+        cache[i].used = 0;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactList::row
+// DESCRIPTION : Text of the row at a list position, from the cache or
+//               decoded from the store
+// ----------------------------------------------------------------------------
+const char* ContactList::row(uint32_t position) {
+    uint32_t index = total - 1 - position;     // newest first
+    Row* victim = &cache[0];
+    for (uint8_t i = 0; i < LIST_CACHE; i++) {
+        if (cache[i].index == index) {
+            cache[i].used = ++tick;
+            return cache[i].text;
+        }
+        if (cache[i].used < victim->used) {
+            victim = &cache[i];
+        }
+    }
+
+    ContactRecord rec;
+    victim->index = index;
+    victim->used = ++tick;
+    int len = snprintf(victim->text, sizeof(victim->text), "%5lu ", (unsigned long) index + 1);
+    if (store.read(index, rec)) {
+        for (uint8_t i = 0; i < rec.uidLength && len + 2 < (int) sizeof(victim->text); i++) {
+            len += snprintf(victim->text + len, sizeof(victim->text) - len, "%02X", rec.uid[i]);
+        }
+    } else {
+        snprintf(victim->text + len, sizeof(victim->text) - len, "damaged");
+    }
+    return victim->text;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactList::drawRow
+// DESCRIPTION : Clear one text line and draw the row at position into it
+// ----------------------------------------------------------------------------
+void ContactList::drawRow(uint8_t line, uint32_t position) {
+    int16_t y = (line + 1) * LIST_ROW_HEIGHT;
+    display.fillRect(0, y, display.width(), LIST_ROW_HEIGHT, SSD1306_BLACK);
+    if (position < total) {
+        display.setCursor(0, y);
+        display.print(row(position));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactList::drawTitle
+// DESCRIPTION : Title line with the position in the list
+// ----------------------------------------------------------------------------
+void ContactList::drawTitle() {
+    char title[32];                             // fits 21 columns up to 5 digit counts
+    if (total) {
+        snprintf(title, sizeof(title), "CONTACTS %lu/%lu", (unsigned long) top + 1, (unsigned long) total);
+    } else {
+        snprintf(title, sizeof(title), "CONTACTS none yet");
+    }
+    display.fillRect(0, 0, display.width(), LIST_ROW_HEIGHT, SSD1306_BLACK);
+    display.setCursor(0, 0);
+    display.print(title);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactList::prefetch
+// DESCRIPTION : Decode the rows just outside the view into the cache
+// ----------------------------------------------------------------------------
+void ContactList::prefetch() {
+    for (uint8_t i = 1; i <= LIST_PREFETCH; i++) {
+        if (top >= i) {
+            row(top - i);
+        }
+        if (top + LIST_ROWS - 1 + i < total) {
+            row(top + LIST_ROWS - 1 + i);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactList::open
+// DESCRIPTION : Draw the whole list from position, 0 is the newest contact
+// ----------------------------------------------------------------------------
+void ContactList::open(uint32_t position) {
+    // the cache is keyed by record index, it stays valid across opens as
+    // long as the log wasn't compacted
+    refresh();
+    opened = true;
+    total = store.count();
+    top = total > LIST_ROWS ? total - LIST_ROWS : 0;
+    if (position < top) {
+        top = position;
+    }
+
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    drawTitle();
+    for (uint8_t line = 0; line < LIST_ROWS; line++) {
+        drawRow(line, top + line);
+    }
+    display.display();
+    prefetch();
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactList::scroll
+// DESCRIPTION : Move the view by one row, the rest of the screen is shifted
+//               in the display buffer instead of being drawn again
+// ----------------------------------------------------------------------------
+void ContactList::scroll(int8_t step) {
+    if (!opened || step == 0) {
+        return;
+    }
+
+    // compacted under the open list, the rows on screen are gone
+    if (refresh()) {
+        open(top);
+        return;
+    }
+    if (step < 0) {
+        if (top == 0) {
+            return;
+        }
+        top--;
+    } else {
+        if (top + LIST_ROWS >= total) {
+            return;
+        }
+        top++;
+    }
+
+    // one text row is one page of display width bytes, page 0 is the title
+    uint8_t* buffer = display.getBuffer();
+    size_t page = display.width();
+    if (step < 0) {
+        memmove(buffer + 2 * page, buffer + page, (LIST_ROWS - 1) * page);
+        drawRow(0, top);
+    } else {
+        memmove(buffer + page, buffer + 2 * page, (LIST_ROWS - 1) * page);
+        drawRow(LIST_ROWS - 1, top + LIST_ROWS - 1);
+    }
+    drawTitle();
+    display.display();
+    prefetch();
+}
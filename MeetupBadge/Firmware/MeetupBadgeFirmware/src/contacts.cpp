@@ -0,0 +1,1118 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// contacts.cpp
+//
+// Contact store, the UIDs collected from other badges
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#endif
+
+#include "contacts.h"
+#include "hmac.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define CONTACT_KDF_LABEL  "BSC1"
+#define DICT_ENTRY         (CONTACT_DICT_PREFIX + 1)     // prefix + CRC-8
+#define DICT_BYTES         (CONTACT_DICT_ENTRIES * DICT_ENTRY)
+#define HEADER_CHECKED     offsetof(ContactPageHeader, commit)
+
+// ============================================================================
+// Global instance
+// ============================================================================
+ContactStore contacts;
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : nowMicros
+// DESCRIPTION : Microsecond clock for the compaction budget
+// ----------------------------------------------------------------------------
+static uint32_t nowMicros() {
+#ifdef ARDUINO
+    return micros();
+#else
+    return (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::crc8
+// DESCRIPTION : CRC-8, polynomial 0x31, init 0xFF
+// ----------------------------------------------------------------------------
+uint8_t ContactStore::crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0xFF;
+    while (len--) {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::isErased
+// DESCRIPTION : True if every byte reads back as erased flash
+// ----------------------------------------------------------------------------
+bool ContactStore::isErased(const uint8_t* data, size_t len) {
+    while (len--) {
+        if (*data++ != FLASH_ERASED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::committed
+// DESCRIPTION : Records of a frame whose commit bit is cleared, in order
+// ----------------------------------------------------------------------------
+uint8_t ContactStore::committed(const ContactPageHeader& ph) {
+    uint8_t n = 0;
+    while (n < CONTACT_PAGE_RECORDS && !(ph.commit[n / 8] & (1 << (n % 8)))) {
+        n++;
+    }
+    return n;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::encode
+// DESCRIPTION : Pack one record, previous is the seconds of the record
+//               before it in the frame. entry is the dictionary entry
+//               holding the uid's prefix, or -1.
+// ----------------------------------------------------------------------------
+size_t ContactStore::encode(const ContactRecord& rec, uint32_t previous, int8_t entry, uint8_t* out) const {
+    uint8_t* p = out;
+    const uint8_t* uid = rec.uid;
+    uint8_t uidBytes = rec.uidLength;
+
+    if (entry >= 0) {
+        *p = CONTACT_FORM_DICT | entry;
+        uid += CONTACT_DICT_PREFIX;
+        uidBytes -= CONTACT_DICT_PREFIX;
+    } else {
+        *p = CONTACT_FORM_RAW | rec.uidLength;
+    }
+    if (rec.flags != CONTACT_FLAGS) {
+        *p |= CONTACT_TAG_FLAGS;
+    }
+    p++;
+
+    // zigzag, taps are usually seconds to minutes apart so this is 1-2 bytes
+    int32_t delta = (int32_t) (rec.seconds - previous);
+    uint32_t zz = ((uint32_t) delta << 1) ^ (uint32_t) (delta >> 31);
+    while (zz >= 0x80) {
+        *p++ = (uint8_t) zz | 0x80;
+        zz >>= 7;
+    }
+    *p++ = (uint8_t) zz;
+
+    if (rec.flags != CONTACT_FLAGS) {
+        *p++ = rec.flags;
+    }
+    memcpy(p, uid, uidBytes);
+    p += uidBytes;
+    return p - out;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::decode
+// DESCRIPTION : Unpack one record, returns the bytes used or 0 if it's
+//               damaged or runs past len
+// ----------------------------------------------------------------------------
+size_t ContactStore::decode(const uint8_t* in, size_t len, uint32_t previous, ContactRecord& rec) const {
+    const uint8_t* p = in;
+    const uint8_t* end = in + len;
+    if (p == end) {
+        return 0;
+    }
+    uint8_t tag = *p++;
+    if (tag & CONTACT_TAG_UNUSED) {
+        return 0;
+    }
+
+    uint32_t zz = 0;
+    for (uint8_t shift = 0;; shift += 7) {
+        if (p == end || shift > 28) {
+            return 0;
+        }
+        uint8_t b = *p++;
+        zz |= (uint32_t) (b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            break;
+        }
+    }
+    rec.seconds = previous + (uint32_t) ((zz >> 1) ^ -(zz & 1));
+
+    rec.flags = CONTACT_FLAGS;
+    if (tag & CONTACT_TAG_FLAGS) {
+        if (p == end) {
+            return 0;
+        }
+        rec.flags = *p++;
+    }
+
+    uint8_t low = tag & CONTACT_TAG_LOW;
+    uint8_t* uid = rec.uid;
+    uint8_t uidBytes;
+    if (tag & CONTACT_FORM_DICT) {
+        if (low >= dictUsed || (dictBad & (1 << low))) {
+            return 0;
+        }
+        memcpy(uid, dict[low], CONTACT_DICT_PREFIX);
+        uid += CONTACT_DICT_PREFIX;
+        uidBytes = CONTACT_UID_MAX - CONTACT_DICT_PREFIX;
+        rec.uidLength = CONTACT_UID_MAX;
+    } else {
+        if (low == 0 || low > CONTACT_UID_MAX) {
+            return 0;
+        }
+        uidBytes = low;
+        rec.uidLength = low;
+    }
+    if ((size_t) (end - p) < uidBytes) {
+        return 0;
+    }
+    memcpy(uid, p, uidBytes);
+    return p + uidBytes - in;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::format
+// DESCRIPTION : Start a new log, erasing whatever is in the partition
+// ----------------------------------------------------------------------------
+bool ContactStore::format(const uint8_t* master) {
+    uint8_t raw[sizeof(ContactHeader) + DICT_BYTES];
+    if (!flash->read(0, raw, sizeof(raw)) || !isErased(raw, sizeof(raw))) {
+        if (!flash->erase(0, flash->size())) {
+            return false;
+        }
+    }
+    memcpy(header.magic, CONTACT_MAGIC, sizeof(header.magic));
+    header.version = CONTACT_VERSION;
+    header.cipher = master ? CONTACT_AES_CTR : CONTACT_PLAIN;
+    memset(header.keyCheck, FLASH_ERASED, sizeof(header.keyCheck));
+#ifdef ARDUINO_ARCH_ESP32
+    header.epoch = ((uint64_t) esp_random() << 32) | esp_random();
+#else
+    header.epoch = ((uint64_t) rand() << 32) ^ ((uint64_t) rand() << 16) ^ rand();
+#endif
+    return flash->write(0, &header, sizeof(header)) && writeHalf(0, 1, 0) && activateHalf(0, 0);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::readHalf
+// DESCRIPTION : Fetch a half header, false if it's torn or erased
+// ----------------------------------------------------------------------------
+bool ContactStore::readHalf(uint8_t h, ContactHalfHeader& hh) {
+    return flash->read(halfPage(h) * CONTACT_PAGE, &hh, sizeof(hh))
+        && memcmp(hh.magic, CONTACT_HALF_MAGIC, sizeof(hh.magic)) == 0
+        && hh.check == crc8((const uint8_t*) &hh, offsetof(ContactHalfHeader, check));
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::activeHalf
+// DESCRIPTION : Half holding the log, -1 if neither is active. Also picks
+//               up the wear counters and the newest generation.
+// ----------------------------------------------------------------------------
+int8_t ContactStore::activeHalf() {
+    int8_t found = -1;
+    uint32_t generation = 0;
+    generations = 0;
+    memset(&wearStats, 0, sizeof(wearStats));
+    for (uint8_t h = 0; h < 2; h++) {
+        ContactHalfHeader hh;
+        if (!readHalf(h, hh)) {
+            continue;
+        }
+        wearStats.erases[h] = hh.erases;
+        if (hh.generation > generations) {
+            generations = hh.generation;
+        }
+        if (hh.active == 0 && hh.generation > generation) {
+            found = h;
+            generation = hh.generation;
+            wearStats.generation = hh.generation;
+            wearStats.dropped = hh.dropped;
+        }
+    }
+    return found;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::writeHalf
+// DESCRIPTION : Claim an erased half for a generation, not active yet
+// ----------------------------------------------------------------------------
+bool ContactStore::writeHalf(uint8_t h, uint32_t generation, uint32_t erases) {
+    ContactHalfHeader hh;
+    memset(&hh, FLASH_ERASED, sizeof(hh));
+    memcpy(hh.magic, CONTACT_HALF_MAGIC, sizeof(hh.magic));
+    hh.generation = generation;
+    hh.erases = erases;
+    hh.check = crc8((const uint8_t*) &hh, offsetof(ContactHalfHeader, check));
+    if (generation > generations) {
+        generations = generation;
+    }
+    return flash->write(halfPage(h) * CONTACT_PAGE, &hh, sizeof(hh));
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::activateHalf
+// DESCRIPTION : Make a claimed half the log, a single write so a reset
+//               leaves either the old or the new half active
+// ----------------------------------------------------------------------------
+bool ContactStore::activateHalf(uint8_t h, uint32_t dropped) {
+    uint8_t bytes[sizeof(dropped) + 1];
+    memcpy(bytes, &dropped, sizeof(dropped));
+    bytes[sizeof(dropped)] = 0;
+    static_assert(offsetof(ContactHalfHeader, active) == offsetof(ContactHalfHeader, dropped) + sizeof(dropped),
+                  "active follows dropped");
+    return flash->write(halfPage(h) * CONTACT_PAGE + offsetof(ContactHalfHeader, dropped), bytes, sizeof(bytes));
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::startTail
+// DESCRIPTION : Point a tail at the start of an empty half
+// ----------------------------------------------------------------------------
+void ContactStore::startTail(Tail& t, uint8_t h, uint32_t generation) {
+    t.generation = generation;
+    t.start = halfPage(h) + 1;
+    t.end = halfPage(h) + halfSectors * CONTACT_SECTOR_PAGES;
+    t.next = t.start;
+    t.sequence = 0;
+    t.records = 0;
+    t.page = 0;
+    t.seq = 0;
+    t.first = 0;
+    t.prev = 0;
+    t.count = 0;
+    t.used = 0;
+    t.full = true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::loadDictionary
+// DESCRIPTION : Read the uid prefixes learned so far from page 0. Frame 0
+//               of the key stream covers page 0, data frames start at 1.
+// ----------------------------------------------------------------------------
+void ContactStore::loadDictionary() {
+    uint8_t raw[DICT_BYTES];
+    uint8_t plain[DICT_BYTES];
+    dictUsed = 0;
+    dictBad = 0;
+    if (!flash->read(CONTACT_DICT_OFFSET, raw, sizeof(raw))) {
+        return;
+    }
+    memcpy(plain, raw, sizeof(plain));
+    if (encrypted()) {
+        aes.crypt(header.epoch, CONTACT_DICT_OFFSET / AES_BLOCK, plain, sizeof(plain));
+    }
+    while (dictUsed < CONTACT_DICT_ENTRIES && !isErased(raw + dictUsed * DICT_ENTRY, DICT_ENTRY)) {
+        const uint8_t* entry = plain + dictUsed * DICT_ENTRY;
+        memcpy(dict[dictUsed], entry, CONTACT_DICT_PREFIX);
+        if (entry[CONTACT_DICT_PREFIX] != crc8(entry, CONTACT_DICT_PREFIX)) {
+            dictBad |= 1 << dictUsed;
+        }
+        dictUsed++;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::learnPrefix
+// DESCRIPTION : Dictionary entry for the prefix of a 7 byte uid, adding it
+//               if there's room. -1 if the uid has to be stored whole.
+// ----------------------------------------------------------------------------
+int8_t ContactStore::learnPrefix(const uint8_t* uid) {
+    for (uint8_t i = 0; i < dictUsed; i++) {
+        if (!(dictBad & (1 << i)) && memcmp(dict[i], uid, CONTACT_DICT_PREFIX) == 0) {
+            return i;
+        }
+    }
+    if (dictUsed >= CONTACT_DICT_ENTRIES) {
+        return -1;
+    }
+
+    uint8_t i = dictUsed++;
+    uint8_t entry[DICT_BYTES];
+    uint8_t* bytes = entry + i * DICT_ENTRY;
+    memset(entry, 0, sizeof(entry));
+    if (encrypted()) {
+        aes.crypt(header.epoch, CONTACT_DICT_OFFSET / AES_BLOCK, entry, sizeof(entry));
+    }
+    for (uint8_t j = 0; j < CONTACT_DICT_PREFIX; j++) {
+        bytes[j] ^= uid[j];
+    }
+    bytes[CONTACT_DICT_PREFIX] ^= crc8(uid, CONTACT_DICT_PREFIX);
+    memcpy(dict[i], uid, CONTACT_DICT_PREFIX);
+
+    // the entry is used either way, the flash is no longer erased
+    if (!flash->write(CONTACT_DICT_OFFSET + i * DICT_ENTRY, bytes, DICT_ENTRY)) {
+        dictBad |= 1 << i;
+        return -1;
+    }
+    return i;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::readHeader
+// DESCRIPTION : Fetch a frame header, false if it's torn or erased
+// ----------------------------------------------------------------------------
+bool ContactStore::readHeader(uint32_t page, ContactPageHeader& ph) {
+    return flash->read(page * CONTACT_PAGE, &ph, sizeof(ph))
+        && !isErased((const uint8_t*) &ph, sizeof(ph))
+        && ph.check == crc8((const uint8_t*) &ph, HEADER_CHECKED);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::loadFrame
+// DESCRIPTION : Read and decrypt a whole frame for read()
+// ----------------------------------------------------------------------------
+bool ContactStore::loadFrame(uint32_t page) {
+    framePage = 0;
+    if (!flash->read(page * CONTACT_PAGE, frame, sizeof(frame))) {
+        return false;
+    }
+    ContactPageHeader ph;
+    memcpy(&ph, frame, sizeof(ph));
+    if (isErased(frame, sizeof(ph)) || ph.check != crc8(frame, HEADER_CHECKED)) {
+        return false;
+    }
+    if (encrypted()) {
+        // from the block holding the first data byte, the header is parsed already
+        uint8_t* from = frame + CONTACT_PAGE_HEADER / AES_BLOCK * AES_BLOCK;
+        aes.crypt(nonce(tail.generation), (uint64_t) ph.sequence * (CONTACT_PAGE / AES_BLOCK) + CONTACT_PAGE_HEADER / AES_BLOCK,
+                  from, frame + sizeof(frame) - from);
+    }
+    framePage = page;
+    frameFirst = ph.first;
+    frameCount = committed(ph);
+    frameNext = 0;
+    frameOffset = 0;
+    framePrev = ph.base;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::locate
+// DESCRIPTION : Page holding record index, binary search over the frame
+//               headers for the last one starting at or before it. 0 if
+//               none.
+// ----------------------------------------------------------------------------
+uint32_t ContactStore::locate(uint32_t index) {
+    if (tail.page && index >= tail.first) {
+        return tail.page;
+    }
+    ContactPageHeader ph;
+
+    // scrolling steps into the frame next to the last one
+    if (framePage) {
+        uint32_t near = index < frameFirst ? framePage - 1 : framePage + 1;
+        if (near >= tail.start && near <= tail.page && readHeader(near, ph)
+            && ph.first <= index && index - ph.first < committed(ph)) {
+            return near;
+        }
+    }
+
+    uint32_t lo = tail.start;
+    uint32_t hi = tail.page;
+    uint32_t found = 0;
+    while (lo <= hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+
+        // a damaged header holds no records, use the good one below it
+        uint32_t probe = mid;
+        while (probe >= lo && !readHeader(probe, ph)) {
+            probe--;
+        }
+        if (probe < lo) {
+            lo = mid + 1;
+        } else if (ph.first <= index) {
+            found = probe;
+            lo = mid + 1;
+        } else {
+            hi = probe - 1;
+        }
+    }
+    return found;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::openPage
+// DESCRIPTION : Start a new frame on the next erased page of a half
+// ----------------------------------------------------------------------------
+bool ContactStore::openPage(Tail& t, uint32_t seconds) {
+    if (t.next >= t.end) {
+        return false;
+    }
+    ContactPageHeader ph;
+    memset(&ph, FLASH_ERASED, sizeof(ph));
+    ph.sequence = ++t.sequence;
+    ph.first = t.records;
+    ph.base = seconds;
+    ph.check = crc8((const uint8_t*) &ph, HEADER_CHECKED);
+
+    // the page is used either way, the header is no longer erased
+    uint32_t page = t.next++;
+    if (!flash->write(page * CONTACT_PAGE, &ph, sizeof(ph))) {
+        t.full = true;
+        return false;
+    }
+    t.page = page;
+    t.seq = ph.sequence;
+    t.first = t.records;
+    t.prev = seconds;
+    t.count = 0;
+    t.used = 0;
+    t.full = false;
+    if (encrypted()) {
+        memset(t.pad, 0, sizeof(t.pad));
+        aes.crypt(nonce(t.generation), (uint64_t) t.seq * (CONTACT_PAGE / AES_BLOCK), t.pad, sizeof(t.pad));
+    }
+    return true;
+}
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::findTail
+// DESCRIPTION : Find the first erased page of the active half and pick up
+//               the tail frame
+// ----------------------------------------------------------------------------
+void ContactStore::findTail() {
+    ContactHalfHeader hh;
+    readHalf(half, hh);
+    startTail(tail, half, hh.generation);
+
+    // frames are only ever appended, so written pages are a prefix
+    uint32_t lo = tail.start;
+    uint32_t hi = tail.end;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        ContactPageHeader ph;
+        if (flash->read(mid * CONTACT_PAGE, &ph, sizeof(ph)) && isErased((const uint8_t*) &ph, sizeof(ph))) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    tail.next = lo;
+    tail.sequence = tail.next - tail.start;
+
+    // the newest good header has the count, torn ones after it are skipped
+    ContactPageHeader ph;
+    uint32_t page = tail.next - 1;
+    while (page >= tail.start && !readHeader(page, ph)) {
+        page--;
+    }
+    if (page < tail.start) {
+        return;
+    }
+    tail.page = page;
+    tail.seq = ph.sequence;
+    tail.first = ph.first;
+    tail.prev = ph.base;
+    tail.count = committed(ph);
+    tail.sequence = ph.sequence + (tail.next - 1 - page);
+    tail.records = ph.first + tail.count;
+    tail.full = page != tail.next - 1 || tail.count >= CONTACT_PAGE_RECORDS;
+
+    haveLast = tail.records && read(tail.records - 1, last);
+    if (tail.count) {
+        if (haveLast && framePage == page) {
+            tail.used = frameOffset;
+            tail.prev = last.seconds;
+        } else {
+            tail.full = true;
+        }
+    }
+
+    // bytes past the last committed record mean a record torn by a reset
+    if (!tail.full) {
+        uint8_t raw[CONTACT_PAGE_DATA];
+        size_t rest = CONTACT_PAGE_DATA - tail.used;
+        tail.full = !rest || !flash->read(page * CONTACT_PAGE + CONTACT_PAGE_HEADER + tail.used, raw, rest)
+                    || !isErased(raw, rest);
+    }
+    if (!tail.full && encrypted()) {
+        memset(tail.pad, 0, sizeof(tail.pad));
+        aes.crypt(nonce(tail.generation), (uint64_t) tail.seq * (CONTACT_PAGE / AES_BLOCK), tail.pad, sizeof(tail.pad));
+    }
+}
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::crc32
+// DESCRIPTION : CRC-32 (IEEE, reflected), pass the last result to continue
+// ----------------------------------------------------------------------------
+uint32_t ContactStore::crc32(const uint8_t* data, size_t len, uint32_t crc) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::snapshotCrypt
+// DESCRIPTION : XOR the key stream of a snapshot at a 16 byte aligned
+//               offset of its slot. No-op for a plain log.
+// ----------------------------------------------------------------------------
+void ContactStore::snapshotCrypt(uint32_t sequence, uint32_t offset, uint8_t* data, size_t len) {
+    if (encrypted()) {
+        aes.crypt(~header.epoch, (uint64_t) sequence * (CONTACT_SNAP_BYTES / AES_BLOCK) + offset / AES_BLOCK, data, len);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::readSnapshot
+// DESCRIPTION : Fetch a snapshot header, false if the slot has none that
+//               fits this log
+// ----------------------------------------------------------------------------
+bool ContactStore::readSnapshot(uint8_t slot, ContactSnapshot& snap) {
+    return flash->read(snapBase + slot * CONTACT_SNAP_BYTES, &snap, sizeof(snap))
+        && memcmp(snap.magic, CONTACT_SNAP_MAGIC, sizeof(snap.magic)) == 0
+        && snap.check == crc32((const uint8_t*) &snap, offsetof(ContactSnapshot, check))
+        && snap.epoch == header.epoch
+        && snap.entries <= UIDSET_MAX;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::loadSnapshot
+// DESCRIPTION : Fill the seen set from a snapshot, the set is left empty if
+//               the fingerprints don't match their CRC
+// ----------------------------------------------------------------------------
+bool ContactStore::loadSnapshot(uint8_t slot, const ContactSnapshot& snap) {
+    uint32_t at = snapBase + slot * CONTACT_SNAP_BYTES;
+    uint32_t offset = sizeof(snap);
+    uint32_t end = offset + snap.entries * sizeof(uint32_t);
+    uint32_t crc = 0;
+    uint8_t chunk[CONTACT_PAGE];
+
+    seenSet.clear();
+    while (offset < end) {
+        size_t len = end - offset < sizeof(chunk) ? end - offset : sizeof(chunk);
+        if (!flash->read(at + offset, chunk, len)) {
+            break;
+        }
+        crc = crc32(chunk, len, crc);
+        snapshotCrypt(snap.sequence, offset, chunk, len);
+        for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+            uint32_t fingerprint;
+            memcpy(&fingerprint, chunk + i, sizeof(fingerprint));
+            seenSet.insert(fingerprint);
+        }
+        offset += len;
+    }
+    if (offset != end || crc != snap.payloadCrc) {
+        seenSet.clear();
+        return false;
+    }
+    snapRecords = snap.records;
+    snapSlot = slot;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::loadIndex
+// DESCRIPTION : Rebuild the seen set from the newest good snapshot and the
+//               records written after it
+// ----------------------------------------------------------------------------
+void ContactStore::loadIndex() {
+    seenSet.clear();
+    snapRecords = 0;
+    snapSeq = 0;
+    snapSlot = CONTACT_SNAP_SLOTS - 1;
+    replayCount = 0;
+
+    ContactSnapshot snaps[CONTACT_SNAP_SLOTS];
+    bool good[CONTACT_SNAP_SLOTS];
+    for (uint8_t slot = 0; slot < CONTACT_SNAP_SLOTS; slot++) {
+        good[slot] = readSnapshot(slot, snaps[slot]);
+
+        // a newer snapshot with bad fingerprints still used its sequence
+        if (good[slot] && snaps[slot].sequence > snapSeq) {
+            snapSeq = snaps[slot].sequence;
+        }
+        good[slot] = good[slot] && snaps[slot].generation == (uint16_t) tail.generation
+                     && snaps[slot].records <= tail.records;
+    }
+
+    // newest first, an older snapshot only means a longer replay
+    for (uint8_t tries = 0; tries < CONTACT_SNAP_SLOTS; tries++) {
+        int8_t pick = -1;
+        for (uint8_t slot = 0; slot < CONTACT_SNAP_SLOTS; slot++) {
+            if (good[slot] && (pick < 0 || snaps[slot].sequence > snaps[pick].sequence)) {
+                pick = slot;
+            }
+        }
+        if (pick < 0) {
+            break;
+        }
+        if (loadSnapshot(pick, snaps[pick])) {
+            break;
+        }
+        good[pick] = false;
+    }
+
+    ContactRecord rec;
+    for (uint32_t i = snapRecords; i < tail.records; i++) {
+        if (read(i, rec)) {
+            seenSet.insert(UidSet::fingerprint(rec.uid, rec.uidLength));
+        }
+        replayCount++;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::snapshot
+// DESCRIPTION : Save the seen set to the slot not holding the newest
+//               snapshot. The fingerprints go out first and the header
+//               after them.
+// ----------------------------------------------------------------------------
+bool ContactStore::snapshot() {
+    if (!ready) {
+        return false;
+    }
+
+    // a failed attempt waits for the next CONTACT_SNAP_EVERY records too
+    snapRecords = tail.records;
+    uint8_t slot = (snapSlot + 1) % CONTACT_SNAP_SLOTS;
+    uint32_t at = snapBase + slot * CONTACT_SNAP_BYTES;
+    if (!flash->erase(at, CONTACT_SNAP_BYTES)) {
+        return false;
+    }
+
+    ContactSnapshot snap;
+    memset(&snap, FLASH_ERASED, sizeof(snap));
+    memcpy(snap.magic, CONTACT_SNAP_MAGIC, sizeof(snap.magic));
+    snap.sequence = ++snapSeq;
+    snap.epoch = header.epoch;
+    snap.records = tail.records;
+    snap.entries = 0;
+    snap.generation = (uint16_t) tail.generation;
+    snap.payloadCrc = 0;
+
+    uint8_t chunk[CONTACT_PAGE];
+    size_t fill = 0;
+    uint32_t offset = sizeof(snap);
+    for (uint16_t i = 0; i < UIDSET_SLOTS; i++) {
+        uint32_t fingerprint = seenSet.slot(i);
+        if (fingerprint != UIDSET_EMPTY) {
+            memcpy(chunk + fill, &fingerprint, sizeof(fingerprint));
+            fill += sizeof(fingerprint);
+            snap.entries++;
+        }
+        if (fill == sizeof(chunk) || (fill && i == UIDSET_SLOTS - 1)) {
+            snapshotCrypt(snap.sequence, offset, chunk, fill);
+            snap.payloadCrc = crc32(chunk, fill, snap.payloadCrc);
+            if (!flash->write(at + offset, chunk, fill)) {
+                return false;
+            }
+            offset += fill;
+            fill = 0;
+        }
+    }
+
+    snap.check = crc32((const uint8_t*) &snap, offsetof(ContactSnapshot, check));
+    if (!flash->write(at, &snap, sizeof(snap))) {
+        return false;
+    }
+    snapSlot = slot;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::begin
+// DESCRIPTION : Attach the flash, check the header, derive the key, pick up
+//               the tail frame and rebuild the seen set
+// ----------------------------------------------------------------------------
+bool ContactStore::begin(FlashDevice& flash, const uint8_t* master) {
+    // reads, appends, snapshots and compaction stay off until the end, a
+    // failed begin() must not compact a log it couldn't open
+    this->flash = &flash;
+    ready = false;
+    openStatus = CONTACT_NO_FLASH;
+    snapBase = flash.size() > CONTACT_SNAP_SLOTS * CONTACT_SNAP_BYTES
+             ? flash.size() - CONTACT_SNAP_SLOTS * CONTACT_SNAP_BYTES : 0;
+    halfSectors = snapBase / FLASH_SECTOR_SIZE > 1 ? (snapBase / FLASH_SECTOR_SIZE - 1) / 2 : 0;
+    startTail(tail, 0, 0);
+    tail.end = tail.start;
+    framePage = 0;
+    haveLast = false;
+    seenSet.clear();
+    snapRecords = 0;
+    compactState = COMPACT_IDLE;
+    compactBackoff = 0;
+    if (halfSectors < 1) {
+        return false;
+    }
+
+    // a blank partition, an unknown layout or a format cut short starts a new log
+    int8_t active = -1;
+    if (!flash.read(0, &header, sizeof(header))
+        || memcmp(header.magic, CONTACT_MAGIC, sizeof(header.magic)) != 0
+        || header.version != CONTACT_VERSION
+        || (active = activeHalf()) < 0) {
+        if (!format(master) || (active = activeHalf()) < 0) {
+            openStatus = CONTACT_FLASH_FAILED;
+            return false;
+        }
+    }
+    half = active;
+
+    if (encrypted()) {
+        if (!master) {
+            openStatus = CONTACT_NO_KEY;
+            return false;
+        }
+        uint8_t info[sizeof(CONTACT_KDF_LABEL) - 1 + sizeof(header.epoch)];
+        memcpy(info, CONTACT_KDF_LABEL, sizeof(CONTACT_KDF_LABEL) - 1);
+        memcpy(info + sizeof(CONTACT_KDF_LABEL) - 1, &header.epoch, sizeof(header.epoch));
+        uint8_t key[SHA256_BYTES];
+        hmacSha256(master, CONTACT_MASTER_BYTES, info, sizeof(info), key);
+        aes.begin(key);
+        memset(key, 0, sizeof(key));
+
+        uint8_t check[AES_BLOCK];
+        memset(check, 0, sizeof(check));
+        aes.crypt(header.epoch, 0, check, sizeof(check));
+        if (isErased(header.keyCheck, sizeof(header.keyCheck))) {
+            memcpy(header.keyCheck, check, sizeof(header.keyCheck));
+            flash.write(offsetof(ContactHeader, keyCheck), header.keyCheck, sizeof(header.keyCheck));
+        } else if (memcmp(header.keyCheck, check, sizeof(header.keyCheck)) != 0) {
+            openStatus = CONTACT_WRONG_KEY;
+            return false;
+        }
+    }
+    ready = true;
+    openStatus = CONTACT_OK;
+    loadDictionary();
+    findTail();
+    loadIndex();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::statusText
+// DESCRIPTION : What begin() found, for the log
+// ----------------------------------------------------------------------------
+const char* ContactStore::statusText() const {
+    switch (openStatus) {
+        case CONTACT_OK:           return "ok";
+        case CONTACT_NO_FLASH:     return "no flash region, or too small";
+        case CONTACT_FLASH_FAILED: return "flash write failed";
+        case CONTACT_NO_KEY:       return "encrypted, no key";
+        case CONTACT_WRONG_KEY:    return "encrypted with another key";
+        default:                   return "unknown";
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::erase
+// DESCRIPTION : Erase the whole region and start a new log
+// ----------------------------------------------------------------------------
+bool ContactStore::erase(const uint8_t* master) {
+    if (!flash) {
+        return false;
+    }
+    FlashDevice& device = *flash;
+    ready = false;
+    if (!device.erase(0, device.size())) {
+        openStatus = CONTACT_FLASH_FAILED;
+        return false;
+    }
+    return begin(device, master);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::read
+// DESCRIPTION : Fetch one record by index. Reading forward through a frame
+//               carries on from the last record decoded.
+// ----------------------------------------------------------------------------
+bool ContactStore::read(uint32_t index, ContactRecord& rec) {
+    if (!ready || index >= tail.records) {
+        return false;
+    }
+    if (!framePage || index < frameFirst || index - frameFirst >= frameCount) {
+        uint32_t page = locate(index);
+        if (!page || !loadFrame(page) || index - frameFirst >= frameCount) {
+            return false;
+        }
+    }
+    uint8_t target = index - frameFirst;
+    if (target < frameNext) {
+        frameNext = 0;
+        frameOffset = 0;
+        ContactPageHeader ph;
+        memcpy(&ph, frame, sizeof(ph));
+        framePrev = ph.base;
+    }
+    while (frameNext <= target) {
+        size_t n = decode(frame + CONTACT_PAGE_HEADER + frameOffset, CONTACT_PAGE_DATA - frameOffset, framePrev, rec);
+        if (!n) {
+            framePage = 0;
+            return false;
+        }
+        frameOffset += n;
+        framePrev = rec.seconds;
+        frameNext++;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::writeRecord
+// DESCRIPTION : Add a record to a half. The record goes out first and its
+//               commit bit after it.
+// ----------------------------------------------------------------------------
+bool ContactStore::writeRecord(Tail& t, const ContactRecord& rec) {
+    int8_t entry = rec.uidLength == CONTACT_UID_MAX ? learnPrefix(rec.uid) : -1;
+    uint8_t bytes[CONTACT_RECORD_MAX];
+    size_t n = encode(rec, t.prev, entry, bytes);
+    if (t.full || t.count >= CONTACT_PAGE_RECORDS || t.used + n > CONTACT_PAGE_DATA) {
+        if (!openPage(t, rec.seconds)) {
+            return false;
+        }
+        n = encode(rec, t.prev, entry, bytes);
+    }
+    if (encrypted()) {
+        const uint8_t* stream = t.pad + CONTACT_PAGE_HEADER + t.used;
+        for (uint8_t i = 0; i < n; i++) {
+            bytes[i] ^= stream[i];
+        }
+    }
+
+    // a failed write leaves the frame unusable, the next record opens a new one
+    uint32_t at = t.page * CONTACT_PAGE;
+    uint8_t bit = t.count % 8;
+    uint8_t commit = (uint8_t) (0xFF << (bit + 1));
+    if (!flash->write(at + CONTACT_PAGE_HEADER + t.used, bytes, n)
+        || !flash->write(at + offsetof(ContactPageHeader, commit) + t.count / 8, &commit, 1)) {
+        t.full = true;
+        return false;
+    }
+    if (framePage == t.page) {
+        framePage = 0;
+    }
+    t.used += n;
+    t.count++;
+    t.prev = rec.seconds;
+    t.records++;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::append
+// DESCRIPTION : Write a tap to the end of the log
+// ----------------------------------------------------------------------------
+bool ContactStore::append(const uint8_t* uid, uint8_t uidLength, uint32_t seconds, uint8_t flags) {
+    if (!ready || uidLength == 0 || uidLength > CONTACT_UID_MAX) {
+        return false;
+    }
+    if (haveLast && last.uidLength == uidLength && memcmp(last.uid, uid, uidLength) == 0) {
+        return false;
+    }
+
+    ContactRecord rec;
+    memcpy(rec.uid, uid, uidLength);
+    rec.uidLength = uidLength;
+    rec.seconds = seconds;
+    rec.flags = flags;
+    if (!writeRecord(tail, rec)) {
+        return false;
+    }
+    last = rec;
+    haveLast = true;
+    seenSet.insert(UidSet::fingerprint(uid, uidLength));
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::compactDue
+// DESCRIPTION : Worth compacting, the half is half full and a quarter of
+//               it repeats, or nearly full with anything to drop
+// ----------------------------------------------------------------------------
+bool ContactStore::compactDue() const {
+    uint32_t used = tail.next - tail.start;
+    uint32_t room = tail.end - tail.start;
+    uint32_t repeats = tail.records > seenSet.size() ? tail.records - seenSet.size() : 0;
+    if (!ready || !room || tail.records < compactBackoff) {
+        return false;
+    }
+    return (used * 2 >= room && repeats * 4 >= tail.records) || (used * 8 >= room * 7 && repeats);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::compactEnd
+// DESCRIPTION : Stop compacting, the next run waits for more records
+// ----------------------------------------------------------------------------
+void ContactStore::compactEnd() {
+    compactState = COMPACT_IDLE;
+    copied.clear();
+    compactBackoff = tail.records + CONTACT_COMPACT_BACKOFF;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::compactStep
+// DESCRIPTION : One bounded unit of compaction: a sector erase, a record
+//               copy or the switch to the new half
+// ----------------------------------------------------------------------------
+bool ContactStore::compactStep() {
+    uint8_t other = 1 - half;
+
+    if (compactState == COMPACT_ERASE) {
+        // the header sector goes last, it keeps the erase count until then
+        compactSector--;
+        uint32_t at = (halfPage(other) / CONTACT_SECTOR_PAGES + compactSector) * FLASH_SECTOR_SIZE;
+        if (!flash->erase(at, FLASH_SECTOR_SIZE)) {
+            compactEnd();
+            return false;
+        }
+        if (compactSector) {
+            return true;
+        }
+        wearStats.erases[other]++;
+        uint32_t generation = generations + 1;
+        if (!writeHalf(other, generation, wearStats.erases[other])) {
+            compactEnd();
+            return false;
+        }
+        startTail(copy, other, generation);
+        copied.clear();
+        compactCursor = 0;
+        compactDropped = 0;
+        compactState = COMPACT_COPY;
+        return true;
+    }
+
+    // caught up with the log, the copy takes over. Appends during the run
+    // went to the log and were copied like the rest.
+    if (compactCursor >= tail.records) {
+        uint32_t dropped = wearStats.dropped + compactDropped;
+        if (!activateHalf(other, dropped)) {
+            compactEnd();
+            return false;
+        }
+        half = other;
+        tail = copy;
+        framePage = 0;
+        wearStats.generation = tail.generation;
+        wearStats.dropped = dropped;
+
+        // old snapshots count records of the old half
+        snapRecords = 0;
+        compactEnd();
+        return false;
+    }
+
+    // the first visible record of each uid is kept, a damaged one is lost
+    ContactRecord rec;
+    bool keep = read(compactCursor, rec) && (rec.flags & CONTACT_FLAG_HIDDEN);
+    if (keep) {
+        uint32_t fingerprint = UidSet::fingerprint(rec.uid, rec.uidLength);
+        keep = !copied.contains(fingerprint);
+        copied.insert(fingerprint);
+    }
+    if (keep && !writeRecord(copy, rec)) {
+        compactEnd();
+        return false;
+    }
+    compactDropped += !keep;
+    compactCursor++;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::compactStart
+// DESCRIPTION : Begin a run if one is due, true while one is under way
+// ----------------------------------------------------------------------------
+bool ContactStore::compactStart() {
+    if (!ready) {
+        return false;
+    }
+    if (compactState == COMPACT_IDLE) {
+        if (!compactDue()) {
+            return false;
+        }
+        compactSector = halfSectors;
+        compactState = COMPACT_ERASE;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::compact
+// DESCRIPTION : Run compaction steps until budgetUs is spent. A step is at
+//               most one sector erase, so that's all a slice overruns by.
+// ----------------------------------------------------------------------------
+bool ContactStore::compact(uint32_t budgetUs) {
+    if (!compactStart()) {
+        return false;
+    }
+    uint32_t start = nowMicros();
+    while (compactStep() && nowMicros() - start < budgetUs) {
+    }
+    return compacting();
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : ContactStore::compactSteps
+// DESCRIPTION : Run at most steps compaction steps, at least one like
+//               compact(0)
+// ----------------------------------------------------------------------------
+bool ContactStore::compactSteps(uint32_t steps) {
+    if (!compactStart()) {
+        return false;
+    }
+    for (uint32_t done = 1; compactStep() && done < steps; done++) {
+    }
+    return compacting();
+}
\ No newline at end of file
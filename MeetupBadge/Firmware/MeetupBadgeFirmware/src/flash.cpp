@@ -0,0 +1,193 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// flash.cpp
+//
+// Raw flash access for the badge data stores
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <string.h>
+#endif
+
+#include "flash.h"
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+#ifdef ARDUINO_ARCH_ESP32
+// ----------------------------------------------------------------------------
+// NAME        : EspPartitionFlash::begin
+// DESCRIPTION : Look up a data partition by its label
+// ----------------------------------------------------------------------------
+bool EspPartitionFlash::begin(const char* label) {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    return partition != nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : EspPartitionFlash::read
+// DESCRIPTION : Read len bytes at offset
+// ----------------------------------------------------------------------------
+bool EspPartitionFlash::read(uint32_t offset, void* buf, size_t len) {
+    if (!partition || offset + len > partition->size) {
+        return false;
+    }
+    return esp_partition_read(partition, offset, buf, len) == ESP_OK;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : EspPartitionFlash::write
+// DESCRIPTION : Program len bytes at offset, the bytes must be erased
+// ----------------------------------------------------------------------------
+bool EspPartitionFlash::write(uint32_t offset, const void* buf, size_t len) {
+    if (!partition || offset + len > partition->size) {
+        return false;
+    }
+    return esp_partition_write(partition, offset, buf, len) == ESP_OK;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : EspPartitionFlash::erase
+// DESCRIPTION : Erase whole sectors
+// ----------------------------------------------------------------------------
+bool EspPartitionFlash::erase(uint32_t offset, size_t len) {
+    if (!partition || offset % FLASH_SECTOR_SIZE || len % FLASH_SECTOR_SIZE || offset + len > partition->size) {
+        return false;
+    }
+    return esp_partition_erase_range(partition, offset, len) == ESP_OK;
+}
+#endif
+
+#ifndef ARDUINO
+// ----------------------------------------------------------------------------
+// NAME        : FileFlash::~FileFlash
+// DESCRIPTION : Close the image
+// ----------------------------------------------------------------------------
+FileFlash::~FileFlash() {
+    if (file) {
+        fclose(file);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : FileFlash::begin
+// DESCRIPTION : Open an existing image or create an erased one
+// ----------------------------------------------------------------------------
+bool FileFlash::begin(const char* path, uint32_t len) {
+    if (len % FLASH_SECTOR_SIZE) {
+        return false;
+    }
+    length = len;
+    file = fopen(path, "r+b");
+    if (file) {
+        return true;
+    }
+    file = fopen(path, "w+b");
+    if (!file) {
+        return false;
+    }
+    return erase(0, len);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : FileFlash::read
+// DESCRIPTION : Read len bytes at offset, beyond the end of the file the
+//               image is erased
+// ----------------------------------------------------------------------------
+bool FileFlash::read(uint32_t offset, void* buf, size_t len) {
+    if (!file || offset + len > length) {
+        return false;
+    }
+    memset(buf, FLASH_ERASED, len);
+    fseek(file, offset, SEEK_SET);
+    fread(buf, 1, len, file);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : FileFlash::write
+// DESCRIPTION : Program len bytes at offset, like NOR flash only 1 -> 0
+// ----------------------------------------------------------------------------
+bool FileFlash::write(uint32_t offset, const void* buf, size_t len) {
+    uint8_t old[64];
+    const uint8_t* in = (const uint8_t*) buf;
+    while (len) {
+        size_t n = len < sizeof(old) ? len : sizeof(old);
+        if (!read(offset, old, n)) {
+            return false;
+        }
+        for (size_t i = 0; i < n; i++) {
+            old[i] &= in[i];
+        }
+        fseek(file, offset, SEEK_SET);
+        if (fwrite(old, 1, n, file) != n) {
+            return false;
+        }
+        offset += n;
+        in += n;
+        len -= n;
+    }
+    return fflush(file) == 0;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : FileFlash::erase
+// DESCRIPTION : Erase whole sectors
+// ----------------------------------------------------------------------------
+bool FileFlash::erase(uint32_t offset, size_t len) {
+    if (!file || offset % FLASH_SECTOR_SIZE || len % FLASH_SECTOR_SIZE || offset + len > length) {
+        return false;
+    }
+    uint8_t blank[FLASH_SECTOR_SIZE];
+    memset(blank, FLASH_ERASED, sizeof(blank));
+    fseek(file, offset, SEEK_SET);
+    for (size_t done = 0; done < len; done += sizeof(blank)) {
+        if (fwrite(blank, 1, sizeof(blank), file) != sizeof(blank)) {
+            return false;
+        }
+    }
+    return fflush(file) == 0;
+}
+#endif
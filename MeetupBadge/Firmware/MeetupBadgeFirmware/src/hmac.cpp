@@ -0,0 +1,218 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// hmac.cpp
+//
+// SHA-256 and HMAC-SHA256
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <string.h>
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <mbedtls/md.h>
+#endif
+
+#include "hmac.h"
+
+// ============================================================================
+// DATA
+// ============================================================================
+static const uint32_t sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+static inline uint32_t ror(uint32_t x, uint8_t n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Sha256::begin
+// DESCRIPTION : Start a new digest
+// ----------------------------------------------------------------------------
+void Sha256::begin() {
+    static const uint32_t init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(state, init, sizeof(state));
+    length = 0;
+    used = 0;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Sha256::compress
+// DESCRIPTION : Fold one 64 byte block into the state
+// ----------------------------------------------------------------------------
+void Sha256::compress(const uint8_t* data) {
+    uint32_t w[64];
+    for (uint8_t i = 0; i < 16; i++) {
+        w[i] = ((uint32_t) data[4 * i] << 24) | ((uint32_t) data[4 * i + 1] << 16)
+             | ((uint32_t) data[4 * i + 2] << 8) | data[4 * i + 3];
+    }
+    for (uint8_t i = 16; i < 64; i++) {
+        uint32_t s0 = ror(w[i - 15], 7) ^ ror(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ror(w[i - 2], 17) ^ ror(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (uint8_t i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + sha256K[i] + w[i];
+        uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Sha256::update
+// DESCRIPTION : Hash more data
+// ----------------------------------------------------------------------------
+void Sha256::update(const void* data, size_t len) {
+    const uint8_t* in = (const uint8_t*) data;
+    length += len;
+    while (len) {
+        if (used == 0 && len >= SHA256_BLOCK) {
+            compress(in);
+            in += SHA256_BLOCK;
+            len -= SHA256_BLOCK;
+            continue;
+        }
+        size_t n = SHA256_BLOCK - used;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(block + used, in, n);
+        used += n;
+        in += n;
+        len -= n;
+        if (used == SHA256_BLOCK) {
+            compress(block);
+            used = 0;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Sha256::finish
+// DESCRIPTION : Pad, write the digest
+// ----------------------------------------------------------------------------
+void Sha256::finish(uint8_t* digest) {
+    uint64_t bits = length * 8;
+    uint8_t pad = 0x80;
+    update(&pad, 1);
+    pad = 0;
+    while (used != SHA256_BLOCK - 8) {
+        update(&pad, 1);
+    }
+    uint8_t tail[8];
+    for (uint8_t i = 0; i < 8; i++) {
+        tail[i] = bits >> (56 - 8 * i);
+    }
+    update(tail, 8);
+    for (uint8_t i = 0; i < 8; i++) {
+        digest[4 * i] = state[i] >> 24;
+        digest[4 * i + 1] = state[i] >> 16;
+        digest[4 * i + 2] = state[i] >> 8;
+        digest[4 * i + 3] = state[i];
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : hmacSha256Soft
+// DESCRIPTION : HMAC-SHA256 (RFC 2104) on Sha256
+// ----------------------------------------------------------------------------
+void hmacSha256Soft(const uint8_t* key, size_t keyLen, const uint8_t* data, size_t len, uint8_t* mac) {
+    uint8_t pad[SHA256_BLOCK] = { 0 };
+    Sha256 sha;
+    if (keyLen > SHA256_BLOCK) {
+        sha.begin();
+        sha.update(key, keyLen);
+        sha.finish(pad);
+    } else {
+        memcpy(pad, key, keyLen);
+    }
+
+    for (uint8_t i = 0; i < SHA256_BLOCK; i++) {
+        pad[i] ^= 0x36;
+    }
+    sha.begin();
+    sha.update(pad, SHA256_BLOCK);
+    sha.update(data, len);
+    sha.finish(mac);
+
+    for (uint8_t i = 0; i < SHA256_BLOCK; i++) {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    sha.begin();
+    sha.update(pad, SHA256_BLOCK);
+    sha.update(mac, SHA256_BYTES);
+    sha.finish(mac);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : hmacSha256
+// DESCRIPTION : HMAC-SHA256 on the fastest engine of the target
+// ----------------------------------------------------------------------------
+void hmacSha256(const uint8_t* key, size_t keyLen, const uint8_t* data, size_t len, uint8_t* mac) {
+#ifdef ARDUINO_ARCH_ESP32
+    mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), key, keyLen, data, len, mac);
+#else
+    hmacSha256Soft(key, keyLen, data, len, mac);
+#endif
+}
@@ -0,0 +1,308 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// hunt.cpp
+//
+// Scavenger hunt checkpoints, HMAC signed tags verified offline
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <Preferences.h>
+
+#include "hunt.h"
+#include "hmac.h"
+#include "console.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define HUNT_MESSAGE_MAX  (sizeof(HUNT_DOMAIN) - 1 + 2 + 7)
+
+// ============================================================================
+// Global instance
+// ============================================================================
+Hunt hunt;
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : hexNibble
+// DESCRIPTION : Value of a hex digit, -1 if it isn't one
+// ----------------------------------------------------------------------------
+static int8_t hexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : hexBytes
+// DESCRIPTION : Decode len bytes of hex, false on a non hex digit
+// ----------------------------------------------------------------------------
+static bool hexBytes(const char* text, uint8_t* out, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        int8_t hi = hexNibble(text[2 * i]);
+        int8_t lo = hi < 0 ? -1 : hexNibble(text[2 * i + 1]);
+        if (lo < 0) {
+            return false;
+        }
+        out[i] = (hi << 4) | lo;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : huntSetKey / huntBench
+// DESCRIPTION : Console commands, run in the console task
+// ----------------------------------------------------------------------------
+static uint8_t huntSetKey(const uint8_t* req, size_t reqLen, uint8_t* resp, size_t* respLen) {
+    *respLen = 0;
+    return hunt.setKey(req, reqLen) ? CONSOLE_OK : CONSOLE_ERR_ARGS;
+}
+
+static uint8_t huntBench(const uint8_t* req, size_t reqLen, uint8_t* resp, size_t* respLen) {
+    uint32_t rates[2];
+    hunt.benchmark(200, &rates[0], &rates[1]);
+    memcpy(resp, rates, sizeof(rates));
+    *respLen = sizeof(rates);
+    return CONSOLE_OK;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::begin
+// DESCRIPTION : Load key and progress, register the console commands
+// ----------------------------------------------------------------------------
+void Hunt::begin() {
+    Preferences prefs;
+    prefs.begin(HUNT_PREFS, true);
+    haveKey = prefs.getBytes("key", key, sizeof(key)) == sizeof(key);
+    found = prefs.getULong64("found", 0);
+    prefs.end();
+
+    console.registerHandler(HUNT_CMD_SET_KEY, huntSetKey);
+    console.registerHandler(HUNT_CMD_BENCH, huntBench);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::setKey
+// DESCRIPTION : Store a new key, verify() switches to it and drops the cache
+// ----------------------------------------------------------------------------
+bool Hunt::setKey(const uint8_t* newKey, size_t len) {
+    if (len != HUNT_KEY_BYTES || keyPending) {
+        return false;
+    }
+    Preferences prefs;
+    prefs.begin(HUNT_PREFS, false);
+    bool ok = prefs.putBytes("key", newKey, len) == len;
+    prefs.end();
+    if (ok) {
+        memcpy(pendingKey, newKey, len);
+        __sync_synchronize();
+        keyPending = true;
+    }
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::parseUrl
+// DESCRIPTION : Pick checkpoint and mac out of a hunt url
+// ----------------------------------------------------------------------------
+bool Hunt::parseUrl(const char* url, uint8_t* checkpoint, uint8_t* mac) {
+    const char* p = strstr(url, HUNT_URL_MARKER);
+    if (!p) {
+        return false;
+    }
+    p += sizeof(HUNT_URL_MARKER) - 1;
+    if (!hexBytes(p, checkpoint, 1) || p[2] != '/' || !hexBytes(p + 3, mac, HUNT_MAC_BYTES)) {
+        return false;
+    }
+    char end = p[3 + 2 * HUNT_MAC_BYTES];
+    return end == '\0' || end == '/' || end == '?';
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::message
+// DESCRIPTION : The signed bytes, "BSH1" | checkpoint | uidLength | uid
+// ----------------------------------------------------------------------------
+size_t Hunt::message(const uint8_t* uid, uint8_t uidLength, uint8_t checkpoint, uint8_t* out) {
+    size_t len = sizeof(HUNT_DOMAIN) - 1;
+    memcpy(out, HUNT_DOMAIN, len);
+    out[len++] = checkpoint;
+    out[len++] = uidLength;
+    memcpy(out + len, uid, uidLength);
+    return len + uidLength;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::sameMac
+// DESCRIPTION : Compare two macs in constant time
+// ----------------------------------------------------------------------------
+bool Hunt::sameMac(const uint8_t* a, const uint8_t* b) {
+    uint8_t diff = 0;
+    for (uint8_t i = 0; i < HUNT_MAC_BYTES; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::verify
+// DESCRIPTION : Verdict for a uid and the url on the tag
+// ----------------------------------------------------------------------------
+HuntVerdict Hunt::verify(const uint8_t* uid, uint8_t uidLength, const String& url, uint8_t* checkpoint) {
+    uint8_t mac[HUNT_MAC_BYTES];
+    if (!parseUrl(url.c_str(), checkpoint, mac)) {
+        return HUNT_NONE;
+    }
+    return verifyMac(uid, uidLength, *checkpoint, mac);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::verifyMac
+// DESCRIPTION : Verdict for a parsed payload, from the cache if this uid
+//               showed the same payload recently
+// ----------------------------------------------------------------------------
+HuntVerdict Hunt::verifyMac(const uint8_t* uid, uint8_t uidLength, uint8_t checkpoint, const uint8_t* mac) {
+    if (keyPending) {
+        memcpy(key, pendingKey, sizeof(key));
+        haveKey = true;
+        cached = 0;
+        nextEntry = 0;
+        __sync_synchronize();
+        keyPending = false;
+    }
+    if (!haveKey) {
+        return HUNT_NO_KEY;
+    }
+    if (uidLength > 7 || checkpoint >= HUNT_CHECKPOINTS) {
+        return HUNT_FORGED;
+    }
+
+    UidKey id = uidKey(uid, uidLength);
+    for (uint8_t i = 0; i < cached; i++) {
+        CacheEntry& e = cache[i];
+        if (e.key.hi == id.hi && e.key.lo == id.lo && e.checkpoint == checkpoint && memcmp(e.mac, mac, HUNT_MAC_BYTES) == 0) {
+            return e.verdict;
+        }
+    }
+
+    uint8_t msg[HUNT_MESSAGE_MAX];
+    uint8_t expected[SHA256_BYTES];
+    hmacSha256(key, sizeof(key), msg, message(uid, uidLength, checkpoint, msg), expected);
+    HuntVerdict verdict = sameMac(expected, mac) ? HUNT_VALID : HUNT_FORGED;
+
+    CacheEntry& e = cache[nextEntry];
+    e.key = id;
+    e.checkpoint = checkpoint;
+    memcpy(e.mac, mac, HUNT_MAC_BYTES);
+    e.verdict = verdict;
+    nextEntry = (nextEntry + 1) % HUNT_CACHE;
+    if (cached < HUNT_CACHE) {
+        cached++;
+    }
+    return verdict;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::markFound
+// DESCRIPTION : Add a checkpoint to the progress in NVS
+// ----------------------------------------------------------------------------
+bool Hunt::markFound(uint8_t checkpoint) {
+    if (checkpoint >= HUNT_CHECKPOINTS) {
+        return false;
+    }
+    uint64_t bit = 1ULL << checkpoint;
+    if (found & bit) {
+        return false;
+    }
+    found |= bit;
+    Preferences prefs;
+    prefs.begin(HUNT_PREFS, false);
+    prefs.putULong64("found", found);
+    prefs.end();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::foundCount
+// DESCRIPTION : Number of checkpoints found so far
+// ----------------------------------------------------------------------------
+uint8_t Hunt::foundCount() const {
+    uint8_t n = 0;
+    for (uint64_t f = found; f; f &= f - 1) {
+        n++;
+    }
+    return n;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : Hunt::benchmark
+// DESCRIPTION : Time full verifications (message, HMAC, compare) without the
+//               cache, once through hmacSha256() and once in software
+// ----------------------------------------------------------------------------
+void Hunt::benchmark(uint16_t rounds, uint32_t* hardware, uint32_t* software) {
+    static const uint8_t benchKey[HUNT_KEY_BYTES] = { 0x42 };
+    uint8_t uid[7] = { 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+    uint8_t msg[HUNT_MESSAGE_MAX];
+    uint8_t mac[SHA256_BYTES];
+    uint8_t presented[HUNT_MAC_BYTES] = { 0 };
+    volatile uint8_t valid = 0;
+
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        uint32_t start = micros();
+        for (uint16_t i = 0; i < rounds; i++) {
+            uid[6] = i;
+            size_t len = message(uid, sizeof(uid), i % HUNT_CHECKPOINTS, msg);
+            if (pass == 0) {
+                hmacSha256(benchKey, sizeof(benchKey), msg, len, mac);
+            } else {
+                hmacSha256Soft(benchKey, sizeof(benchKey), msg, len, mac);
+            }
+            valid += sameMac(mac, presented);
+        }
+        uint32_t elapsed = micros() - start;
+        uint32_t rate = elapsed ? (uint64_t) rounds * 1000000UL / elapsed : 0;
+        *(pass == 0 ? hardware : software) = rate;
+    }
+}
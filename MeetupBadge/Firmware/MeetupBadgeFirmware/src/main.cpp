@@ -64,6 +64,15 @@
 #include <utility/Noiasca_neopixel.h>
 
 #include "bitmaps.h"
+#include "console.h"
+#include "qr.h"
+#include "flash.h"
+#include "contacts.h"
+#include "contactlist.h"
+#include "tags.h"
+#include "blocklist.h"
+#include "hunt.h"
+#include "warmstate.h"
 
 // ============================================================================
 // DEFINES
@@ -83,7 +92,8 @@
 
 // various delay timers
 #define PN532_ACK_DELAY 100
-#define LOOP_READ_DELAY 250
+#define LOOP_READ_DELAY 250   // ms a held button repeats in, and the reader gets rearmed
+#define NDEF_URL_MAX    134   // url bytes read from a tag, more don't fit a version 6 QR code
 
 // OLED settings
 #define SCREEN_WIDTH    128 // OLED display width, in pixels
@@ -94,10 +104,13 @@
 // WS2812 LED
 #define LED_PIN    27
 #define LED_COUNT  7
+#define LED_CHAIN  0      // chain of the badge LEDs on the strip manager
+#define LED_FRAME  20     // ms between two strip updates
+#define LED_ORDER  NEO_GRB  // byte order of the badge LEDs, colors below are plain 0xRRGGBB
 
 // LED colors
-#define LED_RED 0x00FF00
-#define LED_GRN 0xFF0000
+#define LED_RED 0xFF0000
+#define LED_GRN 0x00FF00
 #define LED_BLU 0x0000FF
 
 // LED assignments
@@ -111,6 +124,12 @@
 
 // Prefs
 #define PREF_READONLY false
+#define PREF_CONTACTS_KEY "contactsKey"
+
+// Flash partitions, see partitions.csv
+#define CONTACTS_PARTITION "contacts"
+#define CONTACTS_COMPACT_SLICE_US 5000      // per loop(), on top of one sector erase
+#define CONTACTS_ERASE_HOLD_MS    5000      // both buttons, erases a log the key doesn't open
 
 
 // ============================================================================
@@ -124,22 +143,35 @@ Adafruit_PN532 nfc(PN532_SS);
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 
 // WS2812 LED strip
-Adafruit_NeoPixel strip(LED_COUNT, LED_PIN, NEO_RGB + NEO_KHZ800);
+Adafruit_NeoPixel strip(LED_COUNT, LED_PIN, LED_ORDER + NEO_KHZ800);
+
+// Strip manager, pixels only mark their chain dirty and it's shown once per frame
+NeoStripManager strips(strip);
 
 // 
-BlinkPixel blinkPixelSouth(strip, SOUTH_LED);  // a blink LED on a Neopixel strip using pixel 0
-BlinkPixel blinkPixelNorth(strip, NORTH_LED);  // a blink LED on a Neopixel strip using pixel 1
-BlinkPixel blinkPixelEast(strip, EAST_LED);    // a blink LED on a Neopixel strip using pixel 2
-BlinkPixel blinkPixelWest(strip, WEST_LED);    // a blink LED on a Neopixel strip using pixel 3
-BlinkPixel blinkPixelPrime(strip, PRIME_LED);  // a blink LED on a Neopixel strip using pixel 4
-BlinkPixel blinkPixelNW(strip, NW_LED);        // a blink LED on a Neopixel strip using pixel 5
-BlinkPixel blinkPixelGal(strip, GAL_LED);      // a blink LED on a Neopixel strip using pixel 6
+BlinkPixel blinkPixelSouth(strips, LED_CHAIN, SOUTH_LED);  // a blink LED on a Neopixel strip using pixel 0
+BlinkPixel blinkPixelNorth(strips, LED_CHAIN, NORTH_LED);  // a blink LED on a Neopixel strip using pixel 1
+BlinkPixel blinkPixelEast(strips, LED_CHAIN, EAST_LED);    // a blink LED on a Neopixel strip using pixel 2
+BlinkPixel blinkPixelWest(strips, LED_CHAIN, WEST_LED);    // a blink LED on a Neopixel strip using pixel 3
+BlinkPixel blinkPixelPrime(strips, LED_CHAIN, PRIME_LED);  // a blink LED on a Neopixel strip using pixel 4
+BlinkPixel blinkPixelNW(strips, LED_CHAIN, NW_LED);        // a blink LED on a Neopixel strip using pixel 5
+BlinkPixel blinkPixelGal(strips, LED_CHAIN, GAL_LED);      // a blink LED on a Neopixel strip using pixel 6
+
+// All of them, their phases are kept over a warm restart
+BlinkPixel* const badgeLeds[LED_COUNT] = {
+    &blinkPixelSouth, &blinkPixelNorth, &blinkPixelEast, &blinkPixelWest,
+    &blinkPixelPrime, &blinkPixelNW, &blinkPixelGal,
+};
 
 
 
 // Data persistence using Preferences
 Preferences prefs;
 
+// Contact log in its own flash partition and the list view on the OLED
+EspPartitionFlash contactsFlash;
+ContactList contactList(display, contacts);
+
 // ============================================================================
 // Global variables
 // ============================================================================
@@ -153,6 +185,9 @@ bool readerDisabled        = false;
 
 int btn1State              = HIGH;
 int btn2State              = HIGH;
+uint32_t eraseHeldSince    = 0;                        // both buttons down since, 0 when not
+uint32_t buttonsActedAt    = 0;                        // last button press acted on
+uint32_t readerArmedAt     = 0;                        // last passive detection started
 
 // ============================================================================
 // FUNCTIONS
@@ -169,6 +204,374 @@ void ICACHE_RAM_ATTR nfcInterruptHandler() {
 }
 
 
+// ----------------------------------------------------------------------------
+// NAME        : displayUrl
+// DESCRIPTION : Show an url as QR code on the right side of the OLED
+// ----------------------------------------------------------------------------
+void displayUrl(const String& url) {
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    display.setCursor(0, 0);
+
+    // M if it fits, L gets a longer url into version 6
+    if (qrCode.encode(url.c_str(), QR_ECC_M) || qrCode.encode(url.c_str(), QR_ECC_L)) {
+        qrCode.render(display.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
+        display.println("SCAN ME");
+    } else {
+        display.println("URL too long:");
+        display.println(url);
+    }
+    display.display();
+    warmState.setUrl(url.c_str());
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : displayTagAction
+// DESCRIPTION : Screen for an event tag from tags.csv
+// ----------------------------------------------------------------------------
+void displayTagAction(TagAction action, uint8_t arg) {
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    display.setCursor(0, 0);
+
+    switch (action) {
+        case TAG_SPONSOR:
+            display.println("** SPONSOR BOOTH **");
+            display.println();
+            display.setTextSize(3);
+            display.print("  #"); display.println(arg);
+            display.setTextSize(1);
+            display.println("Thanks for visiting!");
+            break;
+        case TAG_ROOM:
+            display.println("**   TALK ROOM   **");
+            display.println();
+            display.setTextSize(3);
+            display.print("  "); display.println(arg);
+            display.setTextSize(1);
+            break;
+        case TAG_ORGANISER:
+            display.println("**   ORGANISER   **");
+            display.println();
+            display.println("Questions? Ask me!");
+            break;
+        default:
+            break;
+    }
+    display.display();
+    warmState.setScreen(WARM_SCREEN_TAG, action, arg);
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : displayCheckpoint
+// DESCRIPTION : Screen for a scavenger hunt tag, isNew for a checkpoint
+//               found with this tap
+// ----------------------------------------------------------------------------
+void displayCheckpoint(HuntVerdict verdict, uint8_t checkpoint, bool isNew) {
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    display.setCursor(0, 0);
+
+    switch (verdict) {
+        case HUNT_VALID:
+            display.println("** SCAVENGER HUNT **");
+            display.println();
+            display.print("Checkpoint "); display.println(checkpoint);
+            display.println(isNew ? "FOUND!" : "already found");
+            display.println();
+            display.print(hunt.foundCount()); display.println(" found so far");
+            break;
+        case HUNT_FORGED:
+            display.println("** SCAVENGER HUNT **");
+            display.println();
+            display.println("Nice try, this tag");
+            display.println("is not genuine.");
+            break;
+        default:
+            display.println("** SCAVENGER HUNT **");
+            display.println();
+            display.println("Badge has no hunt key");
+            break;
+    }
+    display.display();
+    warmState.setScreen(WARM_SCREEN_CHECKPOINT, verdict, checkpoint, isNew);
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : displayCard
+// DESCRIPTION : Basic information about the card just read
+// ----------------------------------------------------------------------------
+void displayCard(const uint8_t* uid, uint8_t uidLength) {
+    display.clearDisplay();
+    display.setTextSize(1);               // Normal 1:1 pixel scale
+    display.setTextColor(SSD1306_WHITE);  // Draw white text
+    display.setCursor(0, 0);              // Start at top-left corner
+
+    // Display card info on OLED
+    display.println(" ** Card Detected **");
+    display.println("---------------------");
+    
+    display.println("UID length: ");
+    display.print(uidLength, DEC);
+    display.println(" bytes");
+    display.println();
+
+    display.println("UID bytes: ");
+
+    // Print each uid byte seen to the display
+    for (uint8_t i = 0; i < uidLength; i++)
+    {
+        display.print(" 0x"); display.print(uid[i], HEX);
+    }
+
+    // Render the display buffer
+    display.display();
+    warmState.setScreen(WARM_SCREEN_CARD);
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : displayWaiting
+// DESCRIPTION : Idle screen
+// ----------------------------------------------------------------------------
+void displayWaiting() {
+    display.clearDisplay();
+    display.setTextSize(1);               // Normal 1:1 pixel scale
+    display.setTextColor(SSD1306_WHITE);  // Draw white text
+    display.setCursor(0, 0);              // Start at top-left corner
+    display.println("= WAITING FOR CARD =");
+    if (contacts.locked()) {
+        display.println();
+        display.println("CONTACTS LOCKED");
+        display.println("hold both buttons 5s");
+        display.println("to erase them");
+    }
+    display.display();
+    warmState.setScreen(WARM_SCREEN_WAITING);
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : loadContactsMaster
+// DESCRIPTION : Contacts secret from the prefs, made on the first boot
+// ----------------------------------------------------------------------------
+void loadContactsMaster(uint8_t* master) {
+    prefs.begin("MeetupBadge", PREF_READONLY);
+    if (prefs.getBytes(PREF_CONTACTS_KEY, master, CONTACT_MASTER_BYTES) != CONTACT_MASTER_BYTES) {
+        Serial.println("loadContactsMaster(): new contacts key");
+        for (uint8_t i = 0; i < CONTACT_MASTER_BYTES; i += 4) {
+            uint32_t r = esp_random();
+            memcpy(master + i, &r, 4);
+        }
+        prefs.putBytes(PREF_CONTACTS_KEY, master, CONTACT_MASTER_BYTES);
+    }
+    prefs.end();
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : holdContactsErase
+// DESCRIPTION : A log the key doesn't open (new key after an NVS erase, or a
+//               log from another badge) can't be read by anyone. Holding both
+//               buttons for CONTACTS_ERASE_HOLD_MS erases it and starts a new
+//               one. Returns true while both buttons are held.
+// ----------------------------------------------------------------------------
+bool holdContactsErase() {
+    if (digitalRead(BTN1) != LOW || digitalRead(BTN2) != LOW) {
+        eraseHeldSince = 0;
+        return false;
+    }
+    if (!eraseHeldSince) {
+        eraseHeldSince = millis() | 1;
+        contactList.close();
+        display.clearDisplay();
+        display.setTextSize(1);
+        display.setTextColor(SSD1306_WHITE);
+        display.setCursor(0, 0);
+        display.println("= ERASE CONTACTS =");
+        display.println();
+        display.println("keep holding to erase");
+        display.println("release to cancel");
+        display.display();
+        return true;
+    }
+    if (millis() - eraseHeldSince < CONTACTS_ERASE_HOLD_MS) {
+        return true;
+    }
+
+    Serial.println("holdContactsErase(): erasing contacts");
+    uint8_t master[CONTACT_MASTER_BYTES];
+    loadContactsMaster(master);
+    bool erased = contacts.erase(master);
+    memset(master, 0, sizeof(master));
+    Serial.print("holdContactsErase(): contacts ");
+    Serial.println(erased ? "erased, new log" : contacts.statusText());
+    eraseHeldSince = 0;
+    displayWaiting();
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : restoreScreen
+// DESCRIPTION : Draw the screen that was up before a warm restart
+// ----------------------------------------------------------------------------
+void restoreScreen() {
+    const WarmData& warm = warmState.data();
+    switch (warm.screen) {
+        case WARM_SCREEN_CARD: {
+            const WarmUid& last = warmState.lastTap();
+            displayCard(last.uid, last.uidLength);
+            break;
+        }
+        case WARM_SCREEN_URL:
+            if (warm.url[0]) {
+                displayUrl(warm.url);
+            } else {
+                displayWaiting();
+            }
+            break;
+        case WARM_SCREEN_TAG:
+            displayTagAction((TagAction) warm.args[0], warm.args[1]);
+            break;
+        case WARM_SCREEN_CHECKPOINT:
+            displayCheckpoint((HuntVerdict) warm.args[0], warm.args[1], warm.args[2]);
+            break;
+        case WARM_SCREEN_LIST:
+            contactList.open(warm.listPosition);
+            warmState.setList(contactList.position());
+            break;
+        default:
+            displayWaiting();
+            break;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : saveLeds / restoreLeds
+// DESCRIPTION : Keep the blink phases in RTC memory, continue them after a
+//               warm restart
+// ----------------------------------------------------------------------------
+void saveLeds() {
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < LED_COUNT; i++) {
+        BlinkPixel::Phase phase = badgeLeds[i]->getPhase(now);
+        warmState.setPhase(i, phase.state, phase.elapsed);
+    }
+}
+
+void restoreLeds() {
+    const WarmData& warm = warmState.data();
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < LED_COUNT; i++) {
+        BlinkPixel::Phase phase;
+        phase.state = warm.phases[i].state;
+        phase.elapsed = warm.phases[i].elapsed;
+        badgeLeds[i]->setPhase(phase, now);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// NAME        : readNdefUrl
+// DESCRIPTION : Read the URI record of an NTAG2xx into url. Every byte comes
+//               from the tag, so the length is checked against the buffer
+//               and a failed page read gives up. url is left alone then.
+// ----------------------------------------------------------------------------
+bool readNdefUrl(String& url) {
+    // TODO: Parsing from the app "NFC Reader" on Android Play store, not only the spec. To be validated
+    // Read only the first record
+    uint8_t headerPage[4];
+
+    // Read tag type, if any
+    if (!nfc.ntag2xx_ReadPage(4, headerPage)) {
+        return false;
+    }
+    Serial.print("Header 4: ");
+    nfc.PrintHex(headerPage, 4);
+    Serial.println();
+    if (headerPage[1] != 0x03) {
+        return false;
+    }
+
+    Serial.println("NDEF RECORD");
+    // Read header
+    if (!nfc.ntag2xx_ReadPage(5, headerPage)) {
+        return false;
+    }
+    Serial.print("Header 5: ");
+    nfc.PrintHex(headerPage, 4);
+    Serial.println();
+    if ((headerPage[3] & 0x07) != 0x01) {
+        return false;
+    }
+
+    if (!nfc.ntag2xx_ReadPage(6, headerPage)) {
+        return false;
+    }
+    Serial.print("Header 6: ");
+    nfc.PrintHex(headerPage, 4);
+    Serial.println();
+    Serial.println("NDEF - Well known record");
+    if (headerPage[2] != 0x55) {
+        return false;
+    }
+
+    Serial.println("NDEF - Well known URI");
+    String found;
+    switch(headerPage[3]) {
+        case 0x01:
+        found = "http://www.";
+        break;
+        case 0x02:
+        found = "https://www.";
+        break;
+        case 0x03:
+        found = "http://";
+        break;
+        case 0x04:
+        found = "https://";
+        break;
+        default:
+        Serial.print("NDEF - Value: '0x");
+        Serial.print(headerPage[3], HEX);
+        Serial.println("' unknown.");
+    }
+
+    // the payload length counts the prefix code in front of the url
+    uint8_t payloadLength = headerPage[1];
+    if (payloadLength == 0 || payloadLength - 1 > NDEF_URL_MAX) {
+        Serial.print("NDEF - URI length ");
+        Serial.print(payloadLength);
+        Serial.println(" not supported");
+        return false;
+    }
+    uint8_t urlLength = payloadLength - 1;
+
+    // Read URL, whole pages from page 7
+    uint8_t data[NDEF_URL_MAX + 4];
+    for (uint8_t page = 0; page * 4 < urlLength; page++) {
+        if (!nfc.ntag2xx_ReadPage(7 + page, data + page * 4)) {
+            return false;
+        }
+    }
+
+    data[urlLength] = '\0';
+    nfc.PrintHex(data, urlLength);
+    found += String((char *) data);
+    Serial.print("NDEF - URL: ");
+    Serial.println(found);
+    url = found;
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // NAME        : processUid
 // DESCRIPTION : Process a card read uid
@@ -179,68 +582,20 @@ void processUid(uint8_t* uid, uint8_t uidLength) {
 
     // Try to read NTAG2xx memory and extract an URL
     // TODO: mifare classic/ultralight
-    // TODO: Parsing from the app "NFC Reader" on Android Play store, not only the spec. To be validated
-    // Read only the first record
-  
     if (uidLength == 7) {
+        readNdefUrl(lmUrl);
+    }
 
-        uint8_t headerPage[4];
-        // Read tag type, if any
-        nfc.ntag2xx_ReadPage(4, headerPage);
-        Serial.print("Header 4: ");
-        nfc.PrintHex(headerPage, 4);
-        Serial.println();
-
-        if (headerPage[1] == 0x03) {
-            Serial.println("NDEF RECORD");
-            // Read header
-            nfc.ntag2xx_ReadPage(5, headerPage);
-            Serial.print("Header 5: ");
-            nfc.PrintHex(headerPage, 4);
-            Serial.println();
-
-            if ((headerPage[3] && 0x07) == 0x01) {
-                nfc.ntag2xx_ReadPage(6, headerPage);
-                Serial.print("Header 6: ");
-                nfc.PrintHex(headerPage, 4);
-                Serial.println();
-                Serial.println("NDEF - Well known record");
-
-                if (headerPage[2] == 0x55) {
-                Serial.println("NDEF - Well known URI");
-                switch(headerPage[3]) {
-                    case 0x01:
-                    lmUrl = "http://www.";
-                    break;
-                    case 0x02:
-                    lmUrl = "https://www.";
-                    break;
-                    case 0x03:
-                    lmUrl = "http://";
-                    break;
-                    case 0x04:
-                    lmUrl = "https://";
-                    break;
-                    default:
-                    Serial.print("NDEF - Value: '0x");
-                    Serial.print(headerPage[3], HEX);
-                    Serial.println("' unknown.");
-                }
-
-                // Read URL
-                uint8_t data[((headerPage[1]-1)/4+1)*4+1];
-                for (uint8_t page = 7; page < ((headerPage[1]-1)/4+1) + 7; page ++) {
-                    nfc.ntag2xx_ReadPage(page, data + (page - 7) * 4);
-                }
-
-                data[headerPage[1]-1] = '\0';
-                nfc.PrintHex(data, 12);
-                lmUrl += String((char *) data);
-                Serial.print("NDEF - URL: ");
-                Serial.println(lmUrl);
-                }
-            }
-        }
+    // Scavenger hunt tags show the checkpoint instead of the url
+    uint8_t checkpoint;
+    HuntVerdict verdict = hunt.verify(uid, uidLength, lmUrl, &checkpoint);
+    if (verdict != HUNT_NONE) {
+        Serial.print("processUid(): hunt verdict ");
+        Serial.println(verdict);
+        bool isNew = verdict == HUNT_VALID && hunt.markFound(checkpoint);
+        displayCheckpoint(verdict, checkpoint, isNew);
+        Serial.println("processUid(): leaving");
+        return;
     }
 
     if (lmUrl.length() == 0) {
@@ -252,9 +607,17 @@ void processUid(uint8_t* uid, uint8_t uidLength) {
         }
         Serial.print("processUid(): URL: ");
         Serial.println(url);
+        lmUrl = url;
+    }
 
+    bool met = contacts.seen(uid, uidLength);
+    if (contacts.append(uid, uidLength, warmState.seconds())) {
+        Serial.print(met ? "processUid(): stored repeat contact " : "processUid(): stored new contact ");
+        Serial.println(contacts.count());
     }
 
+    displayUrl(lmUrl);
+
     Serial.println("processUid(): leaving");
 }
 
@@ -262,18 +625,70 @@ void processUid(uint8_t* uid, uint8_t uidLength) {
 // Setup
 // ----------------------------------------------------------------------------
 void setup() {
-    Serial.begin(115200);
+    Serial.setRxBufferSize(CONSOLE_RX_BUFFER);
+    Serial.begin(CONSOLE_DEFAULT_BAUD);
     Serial.println("setup(): entering");
 
-    // Load prefs
-    prefs.begin("MeetupBadge", PREF_READONLY);
-    prefs.end();
+    // RTC memory tells a warm restart from a cold boot, a warm one skips
+    // the splash and the hardware checks and comes back where it was
+    bool warm = warmState.begin();
+    Serial.print(warm ? "setup(): warm boot after " : "setup(): cold boot after ");
+    Serial.println(warmState.reason());
+    if (warm) {
+        const WarmData& data = warmState.data();
+        Serial.print("setup(): warm boots "); Serial.print(data.warmBoots);
+        Serial.print(", watchdog "); Serial.print(data.watchdogs);
+        Serial.print(", brown-out "); Serial.print(data.brownouts);
+        Serial.print(", sleep "); Serial.print(data.sleeps);
+        Serial.print(", taps "); Serial.println(data.taps);
+        if (warmState.safe()) {
+            Serial.println("setup(): the screen is not restored, it may be what crashed");
+        }
+    }
+
+    // Binary console, runs in its own task
+    Serial.println("setup(): starting console");
+    console.begin();
+
+    // Contacts, encrypted on flash with a key derived from the secret in
+    // the prefs. A log the secret doesn't open stays untouched until it's
+    // erased with both buttons, see holdContactsErase().
+    Serial.println("setup(): opening contact store");
+    uint8_t contactsMaster[CONTACT_MASTER_BYTES];
+    loadContactsMaster(contactsMaster);
+    bool contactsOk = false;
+    if (!contactsFlash.begin(CONTACTS_PARTITION)) {
+        Serial.println("setup(): no contacts partition, contacts are not stored");
+    } else if (!(contactsOk = contacts.begin(contactsFlash, contactsMaster))) {
+        Serial.print("setup(): contacts not opened: "); Serial.println(contacts.statusText());
+        if (contacts.locked()) {
+            Serial.println("setup(): hold both buttons 5s to erase the contacts and start a new log");
+        }
+    }
+    memset(contactsMaster, 0, sizeof(contactsMaster));
+    if (contactsOk) {
+        Serial.print("setup(): contacts: "); Serial.print(contacts.count());
+        Serial.print(" in "); Serial.print(contacts.pagesUsed());
+        Serial.print(" of "); Serial.print(contacts.pageCount()); Serial.println(" pages");
+        Serial.print("setup(): contacts: "); Serial.print(contacts.unique());
+        Serial.print(" unique, replayed "); Serial.println(contacts.replayed());
+        const ContactWear& wear = contacts.wear();
+        Serial.print("setup(): contacts: generation "); Serial.print(wear.generation);
+        Serial.print(", erases "); Serial.print(wear.erases[0]); Serial.print("/"); Serial.print(wear.erases[1]);
+        Serial.print(", dropped "); Serial.println(wear.dropped);
+    }
+
+    // Scavenger hunt key and progress
+    hunt.begin();
 
     // LED strip
     Serial.println("setup(): Configure/start LED strip");
     strip.begin();
-    strip.show();
+    if (!warm) {
+        strip.show();
+    }
     strip.setBrightness(50);
+    strips.setFrameInterval(LED_FRAME);
     blinkPixelSouth.setOnInterval(250);      // set the on time of a pixel
     blinkPixelSouth.setOnColor(LED_BLU);    // set the on color of a pixel
     
@@ -295,6 +710,10 @@ void setup() {
     blinkPixelWest.setOffInterval(250);     // set the off time of a pixel
     blinkPixelWest.setOnColor(LED_RED);    // set the on color of a pixel
 
+    // the intervals are set, the blinks carry on where they were
+    if (warm) {
+        restoreLeds();
+    }
 
 
     // SSD1306_SWITCHCAPVCC = generate display voltage from 3.3V internally
@@ -305,23 +724,22 @@ void setup() {
         for(;;); // Don't proceed, loop forever
     }
 
-    // Show initial display buffer contents on the screen --
-    // the library initializes this with an Adafruit splash screen.
-    // TODO: make this a BurbSec logo
-    //display.clearDisplay();
-    delay(1000);
-    display.clearDisplay();
-    display.drawBitmap(0, 0, epd_bitmap_burbsec_interstate_shields, 128, 64, WHITE);
-    display.display();
-    delay(2000); // Pause for 2 seconds
+    if (warm) {
+        // Straight back to the screen that was up
+        restoreScreen();
+    } else {
+        // Show initial display buffer contents on the screen --
+        // the library initializes this with an Adafruit splash screen.
+        // TODO: make this a BurbSec logo
+        //display.clearDisplay();
+        delay(1000);
+        display.clearDisplay();
+        display.drawBitmap(0, 0, epd_bitmap_burbsec_interstate_shields, 128, 64, WHITE);
+        display.display();
+        delay(2000); // Pause for 2 seconds
 
-    // Clear the buffer
-    display.clearDisplay();
-    display.setTextSize(1);               // Normal 1:1 pixel scale
-    display.setTextColor(SSD1306_WHITE);  // Draw white text
-    display.setCursor(0, 0);              // Start at top-left corner
-    display.println("= WAITING FOR CARD =");
-    display.display();
+        displayWaiting();
+    }
 
     // Configure input pullup resistors
     Serial.println("setup(): setting BTN1/BTN2/PN532_IRQ to INPUT_PULLUP");
@@ -332,8 +750,12 @@ void setup() {
     // NFC
     Serial.println("setup(): Setting up NFC reader");
     nfc.begin();
-    uint32_t versiondata = nfc.getFirmwareVersion();
-    if (! versiondata) {
+
+    // the PN532 was found before a warm restart, it isn't reset with us
+    uint32_t versiondata = 0;
+    if (warm) {
+        Serial.println("setup(): PN532 kept from before the restart");
+    } else if (! (versiondata = nfc.getFirmwareVersion())) {
         Serial.print("setup(): Didn't find PN53x board");
         display.println("* ERROR NO PN532 *");
         display.display();
@@ -348,19 +770,25 @@ void setup() {
     // configure board to read RFID tags
     Serial.println("setup(): calling nfc.SAMConfig");
     nfc.SAMConfig();
-    delay(PN532_ACK_DELAY);
+    if (!warm) {
+        delay(PN532_ACK_DELAY);
+    }
 
     // Start looking for reads
     // Most commands to the PN532 need a delay at the end to ensure completion
     Serial.println("setup(): nfc set passive detection");
     nfc.startPassiveTargetIDDetection(PN532_MIFARE_ISO14443A);
-    delay(PN532_ACK_DELAY);
+    readerArmedAt = millis();
+    if (!warm) {
+        delay(PN532_ACK_DELAY);
+    }
 
     // Register IRQ
     Serial.println("setup(): attaching nfc interrupt");
     attachInterrupt(digitalPinToInterrupt(PN532_IRQ), nfcInterruptHandler, FALLING);
 
     Serial.println("setup(): Waiting for an ISO14443A Card ...");
+    Serial.print("setup(): ready after "); Serial.print(millis()); Serial.println(" ms");
     Serial.println("setup(): leaving");
 }
 
@@ -368,31 +796,49 @@ void setup() {
 // Main loop
 // ============================================================================
 void loop() {
+    uint32_t loopStartedAt = millis();
 
     // Wait for an ISO14443A type cards (Mifare, etc.).  When one is found
     // 'uid' will be populated with the UID, and uidLength will indicate
     // if the uid is 4 bytes (Mifare Classic) or 7 bytes (Mifare Ultralight)
 
-    // read button 1
+    // both buttons held erase a locked contact log, they don't touch the
+    // list meanwhile
+    bool erasing = contacts.locked() && holdContactsErase();
+
+    // read button 1, opens the contact list or scrolls it towards newer
+    // contacts. A press acts at once, holding it repeats every
+    // LOOP_READ_DELAY, the loop itself runs every LED_FRAME.
     // TODO: replace with interrupt?
-    btn1State = digitalRead(BTN1);
+    bool buttonsDue = loopStartedAt - buttonsActedAt >= LOOP_READ_DELAY;
+    btn1State = (erasing || !buttonsDue) ? HIGH : digitalRead(BTN1);
     if (btn1State == LOW) {
         Serial.println("loop(): BTN1 pressed");
-        display.clearDisplay();
-        display.setCursor(0, 0);
-        display.println("BUTTON 1");
-        display.display();
+        if (contactList.isOpen()) {
+            contactList.scroll(-1);
+        } else {
+            contactList.open();
+        }
     }
 
-    // read button 2
+    // read button 2, same towards older contacts
     // TODO: replace with interrupt?
-    btn2State = digitalRead(BTN2);
+    btn2State = (erasing || !buttonsDue) ? HIGH : digitalRead(BTN2);
     if (btn2State == LOW) {
         Serial.println("loop(): BTN2 pressed");
-        display.clearDisplay();
-        display.setCursor(0, 0);       
-        display.println("BUTTON 2");
-        display.display();
+        if (contactList.isOpen()) {
+            contactList.scroll(1);
+        } else {
+            contactList.open();
+        }
+    }
+
+    // the list comes back at the same spot after a warm restart
+    if (btn1State == LOW || btn2State == LOW) {
+        buttonsActedAt = loopStartedAt;
+        if (contactList.isOpen()) {
+            warmState.setList(contactList.position());
+        }
     }
 
     // Basic LED colors
@@ -406,6 +852,7 @@ void loop() {
     blinkPixelPrime.update();
     blinkPixelNW.update();
     blinkPixelGal.update();
+    strips.update();
 
     // Got an nfc passive (non-blocking) read interrupt
     if (nfcInterruptTriggered == true) {
@@ -413,6 +860,17 @@ void loop() {
         // Read the card and stash the results in uid
         nfcCardReadSuccess = nfc.readDetectedPassiveTargetID(uid, &uidLength);
 
+        // Blocked tags are dropped before any NDEF read or display work
+        if (nfcCardReadSuccess && blocklistContains(uid, uidLength)) {
+            Serial.print("loop(): blocked tag ignored: ");
+            nfc.PrintHex(uid, uidLength);
+            nfcCardReadSuccess = 0;
+        }
+
+        if (nfcCardReadSuccess) {
+            warmState.addTap(uid, uidLength);
+        }
+
         // reset the interrupt state indicating we're done reading the card
         nfcInterruptTriggered = false;
     }
@@ -428,62 +886,77 @@ void loop() {
         Serial.print("loop():  => UID Value: ");
         nfc.PrintHex(uid, uidLength);
 
-        // Display setup
-        // TODO: move this to a function
-        // TODO: perhaps we don't have to do this every time?
-        display.clearDisplay();
-        display.setTextSize(1);               // Normal 1:1 pixel scale
-        display.setTextColor(SSD1306_WHITE);  // Draw white text
-        display.setCursor(0, 0);              // Start at top-left corner
+        // The card screen replaces the contact list
+        contactList.close();
 
-        // Display card info on OLED
-        display.println(" ** Card Detected **");
-        display.println("---------------------");
-        
-        display.println("UID length: ");
-        display.print(uidLength, DEC);
-        display.println(" bytes");
-        display.println();
+        displayCard(uid, uidLength);
     
-        display.println("UID bytes: ");
-
-        // Print each uid byte seen to the display
-        for (uint8_t i = 0; i < uidLength; i++)
-        {
-            display.print(" 0x"); display.print(uid[i], HEX);
+        // Event tags from tags.csv get their own screen
+        uint8_t tagArg = 0;
+        TagAction tagAction = tagLookup(uid, uidLength, &tagArg);
+        if (tagAction != TAG_NONE) {
+            Serial.print("loop(): event tag, action ");
+            Serial.println(tagAction);
+            displayTagAction(tagAction, tagArg);
         }
 
-        // Render the display buffer
-        display.display();
-    
         // These are most of the cards I have
-        if (uidLength == 4) {
+        else if (uidLength == 4) {
             // We probably have a Mifare Classic card ... 
             processUid(uid, 4);
         }
         
-        // Deal with these types later
-        if (uidLength == 7) {
-            // We probably have a Mifare Ultralight card or NTAG ...
-            Serial.println("loop(): unsupported card detected");
-            // processUid(uid, 7);
+        // Mifare Ultralight or NTAG, these carry the NDEF urls
+        else if (uidLength == 7) {
+            processUid(uid, 7);
         }
 
         // Rearm for next tag, 
         nfcCardReadSuccess = 0;
   }
 
+    // Save the seen contacts index while nothing else is going on, boot
+    // then only replays the contacts stored after it
+    else if (contacts.snapshotDue()) {
+        Serial.println(contacts.snapshot() ? "loop(): contact index saved" : "loop(): contact index not saved");
+    }
+
+    // Compact the contact log a slice at a time, a tap waits for one slice
+    // at most. A run is logged when it starts and when it ends.
+    else {
+        bool wasCompacting = contacts.compacting();
+        bool compacting = contacts.compact(CONTACTS_COMPACT_SLICE_US);
+        if (compacting && !wasCompacting) {
+            Serial.println("loop(): compacting contacts");
+        } else if (wasCompacting && !compacting) {
+            Serial.print("loop(): contacts compacted to "); Serial.print(contacts.count());
+            Serial.print(", generation "); Serial.println(contacts.wear().generation);
+        }
+    }
+
 
     // Tell the reader to go back into passive detection mode
-    // and reattach the intterupt handler
-    readerDisabled = false;
-    nfc.startPassiveTargetIDDetection(PN532_MIFARE_ISO14443A);
-    attachInterrupt(digitalPinToInterrupt(PN532_IRQ), nfcInterruptHandler, FALLING);
+    // and reattach the intterupt handler, right after a read and
+    // every LOOP_READ_DELAY otherwise as before
+    if (readerDisabled || millis() - readerArmedAt >= LOOP_READ_DELAY) {
+        readerArmedAt = millis();
+        readerDisabled = false;
+        nfc.startPassiveTargetIDDetection(PN532_MIFARE_ISO14443A);
+        attachInterrupt(digitalPinToInterrupt(PN532_IRQ), nfcInterruptHandler, FALLING);
+    }
 
     // reset button states on the way out of the loop
     btn1State = HIGH;
     btn2State = HIGH;
 
-    // spam loop
-    delay(LOOP_READ_DELAY);
+    // Keep the LED phases and the time current for a warm restart
+    saveLeds();
+    warmState.save();
+
+    // sleep out the rest of the LED frame, a slow pass (a tag read) goes
+    // straight on
+    uint32_t spent = millis() - loopStartedAt;
+    if (spent < LED_FRAME) {
+        delay(LED_FRAME - spent);
+    }
 }
\ No newline at end of file
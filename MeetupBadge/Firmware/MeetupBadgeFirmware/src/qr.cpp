@@ -0,0 +1,549 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// qr.cpp
+//
+// QR code encoder (version 1 to 6, byte mode) for the OLED
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+#include "qr.h"
+
+// ============================================================================
+// Globals
+// ============================================================================
+QrCode qrCode;
+
+// Layout of versions 1 to 6, [0] is level M and [1] level L (the format bits)
+struct QrVersion {
+    uint8_t total;                                // data + ecc codewords
+    uint8_t ecc[2];                               // ecc codewords per block
+    uint8_t blocks[2];                            // all blocks have the same size up to version 6
+    uint8_t generator[2];                         // offset in rsGenerator
+    uint8_t align;                                // center of the 2nd alignment pattern, 0 = none
+};
+
+static const QrVersion qrVersions[QR_MAX_VERSION] PROGMEM = {
+    {  26, { 10,  7 }, { 1, 1 }, {   7,   0 },  0 },
+    {  44, { 16, 10 }, { 1, 1 }, {  32,   7 }, 18 },
+    {  70, { 26, 15 }, { 1, 1 }, { 110,  17 }, 22 },
+    { 100, { 18, 20 }, { 2, 1 }, {  48,  66 }, 26 },
+    { 134, { 24, 26 }, { 2, 1 }, {  86, 110 }, 30 },
+    { 172, { 16, 18 }, { 4, 2 }, {  32,  48 }, 34 },
+};
+
+// GF(256) with the QR polynomial 0x11D, exp and log of each element
+static const uint8_t gfExp[256] PROGMEM = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26,
+    0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0,
+    0x9D, 0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+    0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1,
+    0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0,
+    0xFD, 0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+    0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE,
+    0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC,
+    0x85, 0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+    0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73,
+    0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF,
+    0xE3, 0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+    0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6,
+    0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09,
+    0x12, 0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+    0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01,
+};
+
+static const uint8_t gfLog[256] PROGMEM = {
+    0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE, 0x1B, 0x68, 0xC7, 0x4B,
+    0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81, 0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71,
+    0x05, 0x8A, 0x65, 0x2F, 0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+    0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78, 0x4D, 0xE4, 0x72, 0xA6,
+    0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD, 0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88,
+    0x36, 0xD0, 0x94, 0xCE, 0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+    0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54, 0xFA, 0x85, 0xBA, 0x3D,
+    0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B, 0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57,
+    0x07, 0x70, 0xC0, 0xF7, 0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+    0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9, 0x23, 0x20, 0x89, 0x2E,
+    0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD, 0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61,
+    0xF2, 0x56, 0xD3, 0xAB, 0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+    0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC, 0x7F, 0x0C, 0x6F, 0xF6,
+    0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA, 0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A,
+    0xCB, 0x59, 0x5F, 0xB0, 0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+    0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA, 0xA8, 0x50, 0x58, 0xAF,
+};
+
+// Reed-Solomon generator polynomials without the leading 1, highest
+// power first, as logs. Offsets are in qrVersions.
+static const uint8_t rsGenerator[] PROGMEM = {
+     87, 229, 146, 149, 238, 102,  21,  // degree 7
+    251,  67,  46,  61, 118,  70,  64,  94,  32,  45,  // degree 10
+      8, 183,  61,  91, 202,  37,  51,  58,  58, 237, 140, 124,   5,  // degree 15
+     99, 105,
+    120, 104, 107, 109, 102, 161,  76,   3,  91, 191, 147, 169, 182,  // degree 16
+    194, 225, 120,
+    215, 234, 158,  94, 184,  97, 118, 170,  79, 187, 152, 148, 252,  // degree 18
+    179,   5,  98,  96, 153,
+     17,  60,  79,  50,  61, 163,  26, 187, 202, 180, 221, 225,  83,  // degree 20
+    239, 156, 164, 212, 212, 188, 190,
+    229, 121, 135,  48, 211, 117, 251, 126, 159, 180, 169, 152, 192,  // degree 24
+    226, 228, 218, 111,   0, 117, 232,  87,  96, 227,  21,
+    173, 125, 158,   2, 103, 182, 118,  17, 145, 201, 111,  28, 165,  // degree 26
+     53, 161,  21, 245, 142,  13, 102,  48, 227, 153, 145, 218,  70,
+};
+
+// 15 bit format info (BCH coded and masked with 0x5412) for [level][mask]
+static const uint16_t qrFormat[2][8] PROGMEM = {
+    { 0x5412, 0x5125, 0x5E7C, 0x5B4B, 0x45F9, 0x40CE, 0x4F97, 0x4AA0 },
+    { 0x77C4, 0x72F3, 0x7DAA, 0x789D, 0x662F, 0x6318, 0x6C41, 0x6976 },
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : rsRemainder
+// DESCRIPTION : Reed-Solomon ecc of len data bytes with a precomputed
+//               generator of the given degree, written to ecc
+// ----------------------------------------------------------------------------
+static void rsRemainder(const uint8_t* data, uint8_t len, const uint8_t* generator, uint8_t degree, uint8_t* ecc) {
+    memset(ecc, 0, degree);
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t factor = data[i] ^ ecc[0];
+        memmove(ecc, ecc + 1, degree - 1);
+        ecc[degree - 1] = 0;
+        if (factor == 0) {
+            continue;
+        }
+        uint16_t logFactor = pgm_read_byte(&gfLog[factor]);
+        for (uint8_t j = 0; j < degree; j++) {
+            ecc[j] ^= pgm_read_byte(&gfExp[(pgm_read_byte(&generator[j]) + logFactor) % 255]);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : maskBit
+// DESCRIPTION : true if the mask pattern inverts the module at x (column),
+//               y (row)
+// ----------------------------------------------------------------------------
+static bool maskBit(uint8_t mask, uint8_t x, uint8_t y) {
+    switch (mask) {
+        case 0:  return (x + y) % 2 == 0;
+        case 1:  return y % 2 == 0;
+        case 2:  return x % 3 == 0;
+        case 3:  return (x + y) % 3 == 0;
+        case 4:  return (x / 3 + y / 2) % 2 == 0;
+        case 5:  return x * y % 2 + x * y % 3 == 0;
+        case 6:  return (x * y % 2 + x * y % 3) % 2 == 0;
+        default: return ((x + y) % 2 + x * y % 3) % 2 == 0;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::setModule
+// DESCRIPTION : Set one module
+// ----------------------------------------------------------------------------
+void QrCode::setModule(uint8_t x, uint8_t y, bool dark) {
+    uint16_t i = y * size + x;
+    if (dark) {
+        modules[i >> 3] |= 1 << (i & 7);
+    } else {
+        modules[i >> 3] &= ~(1 << (i & 7));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::setFunction
+// DESCRIPTION : Set a module of a function pattern, it's skipped by the data
+//               placement and the masks
+// ----------------------------------------------------------------------------
+void QrCode::setFunction(uint8_t x, uint8_t y, bool dark) {
+    uint16_t i = y * size + x;
+    reserved[i >> 3] |= 1 << (i & 7);
+    setModule(x, y, dark);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::drawFinder
+// DESCRIPTION : Finder pattern with its separator around the center cx, cy
+// ----------------------------------------------------------------------------
+void QrCode::drawFinder(int8_t cx, int8_t cy) {
+    for (int8_t dy = -4; dy <= 4; dy++) {
+        for (int8_t dx = -4; dx <= 4; dx++) {
+            int8_t x = cx + dx;
+            int8_t y = cy + dy;
+            if (x < 0 || y < 0 || x >= size || y >= size) {
+                continue;
+            }
+            uint8_t dist = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+            setFunction(x, y, dist != 2 && dist != 4);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::drawAlignment
+// DESCRIPTION : 5x5 alignment pattern around the center cx, cy
+// ----------------------------------------------------------------------------
+void QrCode::drawAlignment(uint8_t cx, uint8_t cy) {
+    for (int8_t dy = -2; dy <= 2; dy++) {
+        for (int8_t dx = -2; dx <= 2; dx++) {
+            uint8_t dist = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+            setFunction(cx + dx, cy + dy, dist != 1);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::drawFormat
+// DESCRIPTION : Both copies of the format info, plus the dark module
+// ----------------------------------------------------------------------------
+void QrCode::drawFormat(uint8_t ecc, uint8_t mask) {
+    uint16_t bits = pgm_read_word(&qrFormat[ecc][mask]);
+
+    // around the top left finder
+    for (uint8_t i = 0; i <= 5; i++) {
+        setFunction(8, i, (bits >> i) & 1);
+    }
+    setFunction(8, 7, (bits >> 6) & 1);
+    setFunction(8, 8, (bits >> 7) & 1);
+    setFunction(7, 8, (bits >> 8) & 1);
+    for (uint8_t i = 9; i < 15; i++) {
+        setFunction(14 - i, 8, (bits >> i) & 1);
+    }
+
+    // split between the top right and the bottom left finder
+    for (uint8_t i = 0; i < 8; i++) {
+        setFunction(size - 1 - i, 8, (bits >> i) & 1);
+    }
+    for (uint8_t i = 8; i < 15; i++) {
+        setFunction(8, size - 15 + i, (bits >> i) & 1);
+    }
+    setFunction(8, size - 8, true);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::drawFunctionPatterns
+// DESCRIPTION : Timing, finder and alignment patterns. The format areas are
+//               reserved with a dummy format, the real one comes with the
+//               mask.
+// ----------------------------------------------------------------------------
+void QrCode::drawFunctionPatterns() {
+    for (uint8_t i = 0; i < size; i++) {
+        setFunction(6, i, i % 2 == 0);
+        setFunction(i, 6, i % 2 == 0);
+    }
+
+    drawFinder(3, 3);
+    drawFinder(size - 4, 3);
+    drawFinder(3, size - 4);
+
+    uint8_t align = pgm_read_byte(&qrVersions[version - 1].align);
+    if (align) {
+        drawAlignment(align, align);
+    }
+
+    drawFormat(0, 0);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::drawCodewords
+// DESCRIPTION : Place the interleaved codewords in the zigzag order, two
+//               columns at a time from the bottom right. Remainder bits stay
+//               light.
+// ----------------------------------------------------------------------------
+void QrCode::drawCodewords(uint16_t count) {
+    uint16_t bit = 0;
+    uint16_t bits = count * 8;
+
+    for (int8_t right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) {
+            right = 5;                            // skip the vertical timing pattern
+        }
+        bool upward = ((right + 1) & 2) == 0;
+        for (uint8_t vert = 0; vert < size; vert++) {
+            uint8_t y = upward ? size - 1 - vert : vert;
+            for (uint8_t j = 0; j < 2; j++) {
+                uint8_t x = right - j;
+                if (isFunction(x, y) || bit >= bits) {
+                    continue;
+                }
+                setModule(x, y, (codewords[bit >> 3] >> (7 - (bit & 7))) & 1);
+                bit++;
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::applyMask
+// DESCRIPTION : XOR a mask over the data modules, twice undoes it
+// ----------------------------------------------------------------------------
+void QrCode::applyMask(uint8_t mask) {
+    for (uint8_t y = 0; y < size; y++) {
+        for (uint8_t x = 0; x < size; x++) {
+            if (!isFunction(x, y) && maskBit(mask, x, y)) {
+                setModule(x, y, !getModule(x, y));
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::penalty
+// DESCRIPTION : Penalty score of the current symbol (ISO 18004 8.8.2):
+//               runs, 2x2 blocks, finder look-alikes and dark balance
+// ----------------------------------------------------------------------------
+uint16_t QrCode::penalty() const {
+    uint16_t result = 0;
+    uint16_t dark = 0;
+
+    // rows (pass 0) and columns (pass 1)
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint8_t a = 0; a < size; a++) {
+            uint8_t run = 0;
+            bool last = false;
+            uint16_t window = 0;                  // last 11 modules, light outside the symbol
+            for (uint8_t b = 0; b < size + 4; b++) {
+                bool color = false;
+                if (b < size) {
+                    color = pass ? getModule(a, b) : getModule(b, a);
+                    if (b > 0 && color == last) {
+                        run++;
+                        if (run == 5) {
+                            result += 3;
+                        } else if (run > 5) {
+                            result++;
+                        }
+                    } else {
+                        run = 1;
+                    }
+                    last = color;
+                }
+                window = ((window << 1) | color) & 0x7FF;
+                // 1:1:3:1:1 with 4 light modules on one side
+                if (b >= 10 || b >= size) {
+                    if (window == 0x5D0 || window == 0x05D) {
+                        result += 40;
+                    }
+                }
+            }
+        }
+    }
+
+    // the leading light modules in front of a row
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint8_t a = 0; a < size; a++) {
+            uint16_t window = 0;
+            for (uint8_t b = 0; b < 7; b++) {
+                window = (window << 1) | (pass ? getModule(a, b) : getModule(b, a));
+            }
+            if (window == 0x5D) {
+                result += 40;
+            }
+        }
+    }
+
+    for (uint8_t y = 0; y < size; y++) {
+        for (uint8_t x = 0; x < size; x++) {
+            bool color = getModule(x, y);
+            dark += color;
+            if (x + 1 < size && y + 1 < size && color == getModule(x + 1, y) &&
+                color == getModule(x, y + 1) && color == getModule(x + 1, y + 1)) {
+                result += 3;
+            }
+        }
+    }
+
+    uint16_t total = size * size;
+    uint16_t percent = (uint32_t) dark * 100 / total;
+    result += (percent > 50 ? percent - 50 : 50 - percent) / 5 * 10;
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::encode
+// DESCRIPTION : Encode len bytes in byte mode with the smallest version that
+//               fits. Returns false (and keeps nothing) if the data is too
+//               long for version 6.
+// ----------------------------------------------------------------------------
+bool QrCode::encode(const uint8_t* text, size_t len, uint8_t ecc) {
+    ecc = ecc ? 1 : 0;
+    version = 0;
+    size = 0;
+
+    QrVersion v;
+    uint8_t dataLen = 0;
+    for (uint8_t i = 1; i <= QR_MAX_VERSION; i++) {
+        memcpy_P(&v, &qrVersions[i - 1], sizeof(v));
+        dataLen = v.total - v.ecc[ecc] * v.blocks[ecc];
+        if (4 + 8 + 8 * len <= 8 * (size_t) dataLen) {
+            version = i;
+            break;
+        }
+    }
+    if (!version) {
+        return false;
+    }
+    size = 17 + 4 * version;
+
+    // bit stream: mode, count, bytes, terminator, pad to a byte, pad codewords
+    memset(codewords, 0, sizeof(codewords));
+    uint16_t bit = 0;
+    auto put = [&](uint16_t value, uint8_t n) {
+        while (n--) {
+            if ((value >> n) & 1) {
+                codewords[bit >> 3] |= 0x80 >> (bit & 7);
+            }
+            bit++;
+        }
+    };
+    put(0x4, 4);
+    put(len, 8);
+    for (size_t i = 0; i < len; i++) {
+        put(text[i], 8);
+    }
+    uint16_t room = dataLen * 8 - bit;
+    put(0, room < 4 ? room : 4);
+    bit = (bit + 7) & ~7;
+    for (uint8_t pad = 0xEC; bit < dataLen * 8; pad ^= 0xEC ^ 0x11) {
+        put(pad, 8);
+    }
+
+    // ecc per block, data stays in front: data = d0 d1 .. e0 e1 ..
+    uint8_t blocks = v.blocks[ecc];
+    uint8_t blockLen = dataLen / blocks;
+    uint8_t eccLen = v.ecc[ecc];
+    const uint8_t* generator = rsGenerator + v.generator[ecc];
+    memcpy(data, codewords, dataLen);
+    for (uint8_t b = 0; b < blocks; b++) {
+        rsRemainder(data + b * blockLen, blockLen, generator, eccLen, data + dataLen + b * eccLen);
+    }
+
+    // interleave: column by column over the blocks, first data then ecc
+    uint16_t n = 0;
+    for (uint8_t i = 0; i < blockLen; i++) {
+        for (uint8_t b = 0; b < blocks; b++) {
+            codewords[n++] = data[b * blockLen + i];
+        }
+    }
+    for (uint8_t i = 0; i < eccLen; i++) {
+        for (uint8_t b = 0; b < blocks; b++) {
+            codewords[n++] = data[dataLen + b * eccLen + i];
+        }
+    }
+
+    memset(modules, 0, sizeof(modules));
+    memset(reserved, 0, sizeof(reserved));
+    drawFunctionPatterns();
+    drawCodewords(n);
+
+    // try all masks, keep the one with the lowest penalty
+    uint8_t best = 0;
+    uint16_t bestPenalty = 0xFFFF;
+    for (uint8_t mask = 0; mask < 8; mask++) {
+        applyMask(mask);
+        drawFormat(ecc, mask);
+        uint16_t p = penalty();
+        if (p < bestPenalty) {
+            best = mask;
+            bestPenalty = p;
+        }
+        applyMask(mask);
+    }
+    applyMask(best);
+    drawFormat(ecc, best);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : QrCode::render
+// DESCRIPTION : Draw the symbol right aligned and vertically centered into a
+//               SSD1306 page buffer (buffer[x + page * width], bit 0 = top
+//               row of the page). 2x if it fits with a quiet zone of at
+//               least one module, else 1x. The quiet zone is as wide as
+//               the height allows. Returns the width used.
+// ----------------------------------------------------------------------------
+uint8_t QrCode::render(uint8_t* buffer, uint8_t width, uint8_t height) const {
+    if (!version) {
+        return 0;
+    }
+    uint8_t scale = (size + 2) * 2 <= height ? 2 : 1;
+    uint8_t quiet = (height / scale - size) / 2;
+    if (quiet > QR_MAX_QUIET) {
+        quiet = QR_MAX_QUIET;
+    }
+    uint8_t side = (size + 2 * quiet) * scale;
+    if (side > width || side > height) {
+        return 0;
+    }
+    uint8_t x0 = width - side;
+    uint8_t y0 = (height - side) / 2;
+
+    for (uint8_t page = y0 / 8; page <= (y0 + side - 1) / 8; page++) {
+        // rows of this page inside the symbol area
+        uint8_t cover = 0;
+        for (uint8_t b = 0; b < 8; b++) {
+            uint8_t y = page * 8 + b;
+            if (y >= y0 && y < y0 + side) {
+                cover |= 1 << b;
+            }
+        }
+        for (uint8_t px = 0; px < side; px++) {
+            int16_t mx = px / scale - quiet;
+            uint8_t bits = 0;
+            for (uint8_t b = 0; b < 8; b++) {
+                if (!(cover & (1 << b))) {
+                    continue;
+                }
+                int16_t my = (page * 8 + b - y0) / scale - quiet;
+                bool light = mx < 0 || my < 0 || mx >= size || my >= size || !getModule(mx, my);
+                if (light) {
+                    bits |= 1 << b;
+                }
+            }
+            uint8_t* dst = buffer + x0 + px + page * width;
+            *dst = (*dst & ~cover) | bits;
+        }
+    }
+    return side;
+}
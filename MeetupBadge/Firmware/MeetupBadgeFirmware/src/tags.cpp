@@ -0,0 +1,95 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// tags.cpp
+//
+// Event tags that trigger their own screen, see tags.csv
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+#include "tags.h"
+#include "tags_table.h"     // generated from tags.csv by tools/gen_tags.py
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// The table is a minimal perfect hash (hash and displace): the high half of
+// the hash picks a bucket, the bucket's displacement moves the low half to
+// the one slot that can hold the uid. So a lookup is one hash and one key
+// compare. The tables are constexpr, the ESP32 keeps them in flash and
+// reads them through the cache, no RAM is used.
+// ----------------------------------------------------------------------------
+static constexpr uint32_t tagSlot(uint32_t h) {
+    return ((h & 0xFFFF) + tagDisplace[(h >> 16) % TAG_TABLE_BUCKETS]) % TAG_TABLE_SIZE;
+}
+
+static constexpr int tagMatch(uint32_t slot, uint32_t hi, uint32_t lo) {
+    return (tagTable[slot].keyHi == hi && tagTable[slot].keyLo == lo) ? (int) slot : -1;
+}
+
+static constexpr int tagFind(uint32_t hi, uint32_t lo) {
+    return tagMatch(tagSlot(uidHash(hi, lo, TAG_TABLE_SEED)), hi, lo);
+}
+
+TAG_TABLE_CHECKS
+
+// ----------------------------------------------------------------------------
+// NAME        : tagLookup
+// DESCRIPTION : Find the action of an event tag
+// ----------------------------------------------------------------------------
+TagAction tagLookup(const uint8_t* uid, uint8_t uidLength, uint8_t* arg) {
+    if (uidLength != 4 && uidLength != 7) {
+        return TAG_NONE;
+    }
+
+    UidKey key = uidKey(uid, uidLength);
+    int slot = tagFind(key.hi, key.lo);
+    if (slot < 0) {
+        return TAG_NONE;
+    }
+    if (arg) {
+        *arg = tagTable[slot].arg;
+    }
+    return tagTable[slot].action;
+}
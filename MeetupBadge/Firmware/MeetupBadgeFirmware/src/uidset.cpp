@@ -0,0 +1,113 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// uidset.cpp
+//
+// Set of the UIDs in the contact log
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <string.h>
+#endif
+
+#include "uidset.h"
+#include "uidkey.h"
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : UidSet::clear
+// DESCRIPTION : Empty the set
+// ----------------------------------------------------------------------------
+void UidSet::clear() {
+    memset(slots, 0, sizeof(slots));
+    used = 0;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : UidSet::fingerprint
+// DESCRIPTION : Hash of the packed uid, UIDSET_EMPTY is moved to 1
+// ----------------------------------------------------------------------------
+uint32_t UidSet::fingerprint(const uint8_t* uid, uint8_t uidLength) {
+    UidKey key = uidKey(uid, uidLength);
+    uint32_t h = uidHash(key.hi, key.lo, UIDSET_SEED);
+    return h == UIDSET_EMPTY ? 1 : h;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : UidSet::insert
+// DESCRIPTION : Add a fingerprint, the low bits pick the first slot
+// ----------------------------------------------------------------------------
+bool UidSet::insert(uint32_t fingerprint) {
+    uint32_t i = fingerprint & (UIDSET_SLOTS - 1);
+    while (slots[i] != UIDSET_EMPTY) {
+        if (slots[i] == fingerprint) {
+            return false;
+        }
+        i = (i + 1) & (UIDSET_SLOTS - 1);
+    }
+    if (full()) {
+        return false;
+    }
+    slots[i] = fingerprint;
+    used++;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : UidSet::contains
+// DESCRIPTION : Look a fingerprint up, the load cap keeps an empty slot
+//               at the end of every probe
+// ----------------------------------------------------------------------------
+bool UidSet::contains(uint32_t fingerprint) const {
+    uint32_t i = fingerprint & (UIDSET_SLOTS - 1);
+    while (slots[i] != UIDSET_EMPTY) {
+        if (slots[i] == fingerprint) {
+            return true;
+        }
+        i = (i + 1) & (UIDSET_SLOTS - 1);
+    }
+    return false;
+}
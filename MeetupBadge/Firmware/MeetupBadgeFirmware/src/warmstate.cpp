@@ -0,0 +1,257 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// warmstate.cpp
+//
+// Runtime state kept in RTC memory over a reset or deep sleep
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+
+#include <string.h>
+#include <stddef.h>
+
+#include "warmstate.h"
+#include "contacts.h"
+
+// ============================================================================
+// Global instance
+// ============================================================================
+WarmState warmState;
+
+// RTC slow memory, the startup code leaves it alone so it outlives a reset
+static RTC_NOINIT_ATTR WarmData rtcState;
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : checkOf
+// DESCRIPTION : CRC-32 of everything in front of check
+// ----------------------------------------------------------------------------
+static uint32_t checkOf(const WarmData& data) {
+    return ContactStore::crc32((const uint8_t*) &data, offsetof(WarmData, check));
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::begin
+// DESCRIPTION : Keep the RTC copy for a warm boot, start over on a cold one
+// ----------------------------------------------------------------------------
+bool WarmState::begin() {
+    state = &rtcState;
+    resetReason = esp_reset_reason();
+
+    // power on and the reset pin start over, they are what a user does to
+    // get a fresh badge
+    bool kept = false;
+    switch (resetReason) {
+        case ESP_RST_SW:
+        case ESP_RST_PANIC:
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:
+        case ESP_RST_DEEPSLEEP:
+        case ESP_RST_BROWNOUT:
+            kept = true;
+            break;
+        default:
+            break;
+    }
+
+    // a brown-out may have hit in the middle of a save, the check catches it
+    isWarm = kept
+        && state->magic == WARM_MAGIC
+        && state->version == WARM_VERSION
+        && state->size == sizeof(WarmData)
+        && state->check == checkOf(*state)
+        && state->recentNext < WARM_RECENT;
+
+    if (isWarm) {
+        // a panic is most likely what the badge was doing, and a reset loop
+        // never gets to a clean save()
+        isSafe = resetReason == ESP_RST_PANIC || state->restores >= WARM_RESTORE_MAX;
+        if (isSafe) {
+            state->screen = WARM_SCREEN_WAITING;
+        }
+        state->restores++;
+        state->warmBoots++;
+        if (resetReason == ESP_RST_BROWNOUT) {
+            state->brownouts++;
+        } else if (resetReason == ESP_RST_DEEPSLEEP) {
+            state->sleeps++;
+        } else if (resetReason != ESP_RST_SW && resetReason != ESP_RST_PANIC) {
+            state->watchdogs++;
+        }
+    } else {
+        memset(state, 0, sizeof(WarmData));
+        state->magic = WARM_MAGIC;
+        state->version = WARM_VERSION;
+        state->size = sizeof(WarmData);
+        state->screen = WARM_SCREEN_WAITING;
+    }
+
+    bootSeconds = state->seconds;
+    seal();
+    return isWarm;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::reason
+// DESCRIPTION : Why the badge booted, for the log
+// ----------------------------------------------------------------------------
+const char* WarmState::reason() const {
+    switch (resetReason) {
+        case ESP_RST_POWERON:   return "power on";
+        case ESP_RST_EXT:       return "reset pin";
+        case ESP_RST_SW:        return "software reset";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:       return "watchdog";
+        case ESP_RST_DEEPSLEEP: return "deep sleep";
+        case ESP_RST_BROWNOUT:  return "brown-out";
+        default:                return "unknown";
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::setScreen
+// DESCRIPTION : Remember what's on the OLED
+// ----------------------------------------------------------------------------
+void WarmState::setScreen(WarmScreen screen, uint8_t arg0, uint8_t arg1, uint8_t arg2) {
+    state->screen = screen;
+    state->args[0] = arg0;
+    state->args[1] = arg1;
+    state->args[2] = arg2;
+    seal();
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::setUrl
+// DESCRIPTION : Remember the QR screen, a url that doesn't fit is dropped
+// ----------------------------------------------------------------------------
+void WarmState::setUrl(const char* url) {
+    size_t len = strlen(url);
+    if (len < sizeof(state->url)) {
+        memmove(state->url, url, len + 1);  // restoreScreen() hands in state->url
+    } else {
+        state->url[0] = '\0';
+    }
+    setScreen(WARM_SCREEN_URL);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::setList
+// DESCRIPTION : Remember the contact list and where it was scrolled to
+// ----------------------------------------------------------------------------
+void WarmState::setList(uint32_t position) {
+    state->listPosition = position;
+    setScreen(WARM_SCREEN_LIST);
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::addTap
+// DESCRIPTION : Count a tap and keep its uid with the recent ones
+// ----------------------------------------------------------------------------
+void WarmState::addTap(const uint8_t* uid, uint8_t uidLength) {
+    WarmUid& slot = state->recent[state->recentNext];
+    if (uidLength > sizeof(slot.uid)) {
+        uidLength = sizeof(slot.uid);
+    }
+    memset(slot.uid, 0, sizeof(slot.uid));
+    memcpy(slot.uid, uid, uidLength);
+    slot.uidLength = uidLength;
+    state->recentNext = (state->recentNext + 1) % WARM_RECENT;
+    state->taps++;
+    seal();
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::lastTap
+// DESCRIPTION : The uid added last, length 0 if there was none
+// ----------------------------------------------------------------------------
+const WarmUid& WarmState::lastTap() const {
+    return state->recent[(state->recentNext + WARM_RECENT - 1) % WARM_RECENT];
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::setPhase
+// DESCRIPTION : Keep the state of a blinking LED, a blink resumes in that
+//               state with the time into it as of the last toggle
+// ----------------------------------------------------------------------------
+void WarmState::setPhase(uint8_t led, uint8_t phaseState, uint32_t elapsed) {
+    if (led >= WARM_PHASES || state->phases[led].state == phaseState) {
+        return;
+    }
+    state->phases[led].state = phaseState;
+    state->phases[led].elapsed = elapsed;
+    dirty = true;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::save
+// DESCRIPTION : The end of a clean loop(), seal if anything changed
+// ----------------------------------------------------------------------------
+void WarmState::save() {
+    if (state->restores) {
+        state->restores = 0;
+        dirty = true;
+    }
+    if (state->seconds != seconds()) {
+        dirty = true;
+    }
+    if (dirty) {
+        seal();
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : WarmState::seal
+// DESCRIPTION : Bring the time up to date and checksum the copy
+// ----------------------------------------------------------------------------
+void WarmState::seal() {
+    state->seconds = seconds();
+    state->check = checkOf(*state);
+    dirty = false;
+}
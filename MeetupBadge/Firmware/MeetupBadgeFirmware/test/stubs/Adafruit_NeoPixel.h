@@ -0,0 +1,84 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// Adafruit_NeoPixel.h
+//
+// Stand-in for the NeoPixel driver in the host tests
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <algorithm>
+#include <vector>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define NEO_GRB      0x52
+#define NEO_KHZ800   0x0000
+
+// ----------------------------------------------------------------------------
+// Keeps the colors set and counts the transfers, a test checks what went
+// out to the strip and how often
+// ----------------------------------------------------------------------------
+class Adafruit_NeoPixel {
+  public:
+    std::vector<uint32_t> pixels;
+    uint32_t sets  = 0;               // setPixelColor() calls
+    uint32_t shows = 0;               // show() calls
+
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, uint16_t type = NEO_GRB + NEO_KHZ800) : pixels(n, 0) {}
+
+    void begin() {}
+    void show() { shows++; }
+    void clear() { std::fill(pixels.begin(), pixels.end(), 0); }
+    void setBrightness(uint8_t) {}
+    uint16_t numPixels() const { return pixels.size(); }
+    void setPixelColor(uint16_t n, uint32_t c) {
+        if (n < pixels.size()) {
+            pixels[n] = c;
+        }
+        sets++;
+    }
+    uint32_t getPixelColor(uint16_t n) const { return n < pixels.size() ? pixels[n] : 0; }
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return (uint32_t) r << 16 | (uint32_t) g << 8 | b; }
+};
@@ -0,0 +1,82 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// Adafruit_PWMServoDriver.h
+//
+// Stand-in for the PCA9685 driver in the host tests
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <Wire.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define PCA9685_LED0_ON_L 0x06        // first of 4 registers per channel
+#define PCA9685_ALLLED_ON_L 0xFA      // the same 4 registers for all channels
+
+// ----------------------------------------------------------------------------
+// Writes the registers like the driver does: one transmission of the start
+// register and ON_L, ON_H, OFF_L, OFF_H per setPWM(). Channel 61 lands on
+// the ALL_LED registers.
+// ----------------------------------------------------------------------------
+class Adafruit_PWMServoDriver {
+  public:
+    Adafruit_PWMServoDriver(uint8_t addr = 0x40, TwoWire& i2c = Wire) : addr(addr), i2c(i2c) {}
+
+    bool begin(uint8_t prescale = 0) { return true; }
+    void setPWMFreq(float freq) {}
+    uint8_t setPWM(uint8_t num, uint16_t on, uint16_t off) {
+        i2c.beginTransmission(addr);
+        i2c.write(PCA9685_LED0_ON_L + 4 * num);
+        i2c.write(on & 0xFF);
+        i2c.write(on >> 8);
+        i2c.write(off & 0xFF);
+        i2c.write(off >> 8);
+        return i2c.endTransmission();
+    }
+
+  private:
+    uint8_t addr;
+    TwoWire& i2c;
+};
@@ -0,0 +1,99 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// Adafruit_SSD1306.h
+//
+// Stand-in for the SSD1306 driver in the host tests
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+
+// ----------------------------------------------------------------------------
+// A text only display. Byte page * 128 + column of the buffer holds the
+// character at that text column, so a test reads what's on each text line
+// and memmove()s on the buffer work like on the real page layout.
+// ----------------------------------------------------------------------------
+class Adafruit_SSD1306 : public Print {
+  public:
+    uint8_t buffer[128 * 8];
+    uint32_t frames = 0;              // display() calls
+
+    Adafruit_SSD1306() { clearDisplay(); }
+
+    void clearDisplay() { memset(buffer, ' ', sizeof(buffer)); }
+    void display() { frames++; }
+    void setTextSize(uint8_t) {}
+    void setTextColor(uint16_t) {}
+    void setCursor(int16_t x, int16_t y) { column = x / 6; page = y / 8; }
+    void fillRect(int16_t, int16_t y, int16_t, int16_t, uint16_t) { memset(buffer + (y / 8) * 128, ' ', 128); }
+    int16_t width() const { return 128; }
+    int16_t height() const { return 64; }
+    uint8_t* getBuffer() { return buffer; }
+
+    size_t write(uint8_t c) override {
+        if (column < 128 && page < 8) {
+            buffer[page * 128 + column++] = c;
+        }
+        return 1;
+    }
+
+    // text line n without trailing blanks
+    std::string line(uint8_t n) const {
+        std::string s((const char*) buffer + n * 128, 21);
+        while (!s.empty() && s[s.size() - 1] == ' ') {
+            s.erase(s.size() - 1);
+        }
+        return s;
+    }
+
+  private:
+    int16_t column = 0;
+    int16_t page = 0;
+};
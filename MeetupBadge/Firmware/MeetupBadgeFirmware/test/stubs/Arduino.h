@@ -0,0 +1,172 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// Arduino.h
+//
+// Just enough of the Arduino core for the host tests
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define FALLING 2
+#define CHANGE 3
+#define DEC 10
+#define HEX 16
+#define PROGMEM
+#define F(x) x
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define pgm_read_byte(a) (*(const uint8_t*) (a))
+#define pgm_read_word(a) (*(const uint16_t*) (a))
+#define pgm_read_dword(a) (*(const uint32_t*) (a))
+#define memcpy_P memcpy
+#define digitalPinToInterrupt(p) (p)
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+
+typedef uint8_t byte;
+
+// ============================================================================
+// Time, a test moves it by hand
+// ============================================================================
+inline uint32_t& stubMillis() { static uint32_t now = 0; return now; }
+inline void stubAdvance(uint32_t ms) { stubMillis() += ms; }
+inline uint32_t millis() { return stubMillis(); }
+inline uint32_t micros() { return stubMillis() * 1000; }
+inline void delay(uint32_t ms) { stubAdvance(ms); }
+inline void yield() {}
+
+// ============================================================================
+// Pins, the levels written and the levels a test wants read back
+// ============================================================================
+inline uint8_t* stubPins() { static uint8_t pins[64]; return pins; }
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) { stubPins()[pin & 63] = value; }
+inline int digitalRead(uint8_t pin) { return stubPins()[pin & 63]; }
+inline void analogWrite(uint8_t pin, int value) { stubPins()[pin & 63] = value ? HIGH : LOW; }
+inline void attachInterrupt(uint8_t, void (*)(), int) {}
+inline void detachInterrupt(uint8_t) {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+inline long random(long howbig) { return howbig ? rand() % howbig : 0; }
+inline long random(long howsmall, long howbig) { return howsmall + random(howbig - howsmall); }
+inline void randomSeed(unsigned long seed) { srand(seed); }
+
+// ============================================================================
+// Print and String, output goes nowhere, Serial can keep it for a test
+// ============================================================================
+class String : public std::string {
+  public:
+    String() {}
+    String(const char* s) : std::string(s) {}
+    unsigned length() const { return size(); }
+};
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    size_t print(const char* s) { size_t n = 0; while (*s) n += write((uint8_t) *s++); return n; }
+    size_t print(char* s) { return print((const char*) s); }
+    size_t print(const String& s) { return print(s.c_str()); }
+    template<class X> size_t print(X) { return 0; }
+    template<class X> size_t print(X, int) { return 0; }
+    template<class X> size_t println(X value) { return print(value) + println(); }
+    template<class X> size_t println(X, int) { return println(); }
+    size_t println() { return write('\n'); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+};
+
+// a test feeds rx and reads back tx, nothing is kept unless capture is set
+class HardwareSerial : public Stream {
+  public:
+    std::string rx;
+    std::string tx;
+    bool capture  = false;
+    uint32_t baud = 0;
+
+    void begin(unsigned long rate) { baud = rate; }
+    void flush() {}
+    int available() override { return rx.size(); }
+    int read() override {
+        if (rx.empty()) {
+            return -1;
+        }
+        uint8_t c = rx[0];
+        rx.erase(0, 1);
+        return c;
+    }
+    size_t write(uint8_t c) override {
+        if (capture) {
+            tx += (char) c;
+        }
+        return 1;
+    }
+    size_t write(const uint8_t* buf, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            write(buf[i]);
+        }
+        return len;
+    }
+};
+
+static HardwareSerial Serial;
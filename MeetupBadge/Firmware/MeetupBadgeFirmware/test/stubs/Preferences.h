@@ -0,0 +1,92 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// Preferences.h
+//
+// Stand-in for the NVS key value store in the host tests
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+// ----------------------------------------------------------------------------
+// All instances share one store, like NVS. A test clears it with
+// stubPreferences().clear().
+// ----------------------------------------------------------------------------
+inline std::map<std::string, std::string>& stubPreferences() {
+    static std::map<std::string, std::string> store;
+    return store;
+}
+
+class Preferences {
+  public:
+    bool begin(const char* name, bool readOnly = false) {
+        space = name;
+        return true;
+    }
+    void end() {}
+
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        std::map<std::string, std::string>::iterator it = stubPreferences().find(space + "/" + key);
+        if (it == stubPreferences().end() || it->second.size() > maxLen) {
+            return 0;
+        }
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        stubPreferences()[space + "/" + key] = std::string((const char*) value, len);
+        return len;
+    }
+    uint64_t getULong64(const char* key, uint64_t defaultValue = 0) {
+        uint64_t value;
+        return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+    }
+    size_t putULong64(const char* key, uint64_t value) {
+        return putBytes(key, &value, sizeof(value));
+    }
+
+  private:
+    std::string space;
+};
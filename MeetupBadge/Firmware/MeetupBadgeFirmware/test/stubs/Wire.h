@@ -0,0 +1,97 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// Wire.h
+//
+// Stand-in for the I2C bus in the host tests
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+#pragma once
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Keeps every transmission and counts the reads. A test puts the bytes the
+// next requestFrom() gets into reply.
+// ----------------------------------------------------------------------------
+class TwoWire {
+  public:
+    std::vector<std::string> sent;    // one entry per endTransmission()
+    std::string reply;                // bytes for the next requestFrom()
+    uint32_t requests = 0;            // requestFrom() calls
+
+    void begin() {}
+    void beginTransmission(uint8_t) { frame.clear(); }
+    size_t write(uint8_t c) {
+        frame += (char) c;
+        return 1;
+    }
+    uint8_t endTransmission(bool stop = true) {
+        sent.push_back(frame);
+        return 0;
+    }
+    uint8_t requestFrom(uint8_t, uint8_t len) {
+        requests++;
+        if (reply.size() < len) {
+            reply.clear();
+            return 0;
+        }
+        rx = reply.substr(0, len);
+        reply.erase(0, len);
+        return len;
+    }
+    int available() { return rx.size(); }
+    int read() {
+        if (rx.empty()) {
+            return -1;
+        }
+        uint8_t c = rx[0];
+        rx.erase(0, 1);
+        return c;
+    }
+
+  private:
+    std::string frame;
+    std::string rx;
+};
+
+static TwoWire Wire;
@@ -0,0 +1,156 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the blocklist filter against blocklist.txt
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "blocklist.h"
+#include "blocklist_table.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define BLOCKLIST_TXT "blocklist.txt"
+#define NEGATIVES     1000000
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : readList
+// DESCRIPTION : The uids of blocklist.txt, the way tools/gen_blocklist.py
+//               reads them
+// ----------------------------------------------------------------------------
+static std::vector<std::string> readList() {
+    std::vector<std::string> uids;
+    FILE* f = fopen(BLOCKLIST_TXT, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char hex[32];
+        if (sscanf(line, " %31[0-9A-Fa-f]", hex) != 1) {
+            continue;
+        }
+        std::string uid;
+        for (size_t i = 0; i + 1 < strlen(hex); i += 2) {
+            unsigned byte;
+            sscanf(hex + i, "%2x", &byte);
+            uid += (char) byte;
+        }
+        uids.push_back(uid);
+    }
+    fclose(f);
+    return uids;
+}
+
+void setUp() {
+    srand(11);
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// Every listed uid is blocked
+// ----------------------------------------------------------------------------
+static void test_listed_are_blocked() {
+    std::vector<std::string> uids = readList();
+    TEST_ASSERT_EQUAL_UINT32(BLOCK_KEYS, uids.size());
+    for (size_t i = 0; i < uids.size(); i++) {
+        TEST_ASSERT_TRUE(blocklistContains((const uint8_t*) uids[i].data(), uids[i].size()));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Unlisted uids are blocked at about the rate the filter is built for,
+// (1 - e^(-k n / m))^k, plus five standard deviations of the count. An
+// empty list blocks nothing.
+// ----------------------------------------------------------------------------
+static void test_false_positive_rate() {
+    std::vector<std::string> uids = readList();
+    std::set<std::string> listed(uids.begin(), uids.end());
+
+    uint32_t tried = 0, hits = 0;
+    while (tried < NEGATIVES) {
+        uint8_t uid[7];
+        uint8_t len = rand() & 1 ? 4 : 7;
+        for (uint8_t j = 0; j < len; j++) {
+            uid[j] = rand();
+        }
+        if (listed.count(std::string((const char*) uid, len))) {
+            continue;
+        }
+        tried++;
+        hits += blocklistContains(uid, len);
+    }
+
+    double rate = pow(1 - exp(-(double) BLOCK_HASHES * BLOCK_KEYS / BLOCK_BITS), BLOCK_HASHES);
+    double bound = rate * tried + 5 * sqrt(rate * tried);
+    char message[96];
+    snprintf(message, sizeof(message), "%u of %u blocked, expected %.6f", hits, tried, rate);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(hits <= bound, message);
+    if (BLOCK_KEYS == 0) {
+        TEST_ASSERT_EQUAL_UINT32(0, hits);
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_listed_are_blocked);
+    RUN_TEST(test_false_positive_rate);
+    return UNITY_END();
+}
@@ -0,0 +1,270 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the binary console framing, on the bytes the host client sends
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <string.h>
+#include <initializer_list>
+#include <string>
+
+#include "console.h"
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// (data, encoding), the same values as tools/test_badge_console.py
+struct CobsVector {
+    std::string data;
+    std::string encoded;
+};
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static HardwareSerial port;
+static Console* host;
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+static std::string bytes(std::initializer_list<uint8_t> b) {
+    return std::string(b.begin(), b.end());
+}
+
+// a request as tools/badge_console.py frames it
+static std::string request(uint8_t seq, uint8_t cmd, const std::string& payload) {
+    uint8_t frame[CONSOLE_MAX_FRAME];
+    uint8_t out[CONSOLE_MAX_ENCODED];
+    frame[0] = seq;
+    frame[1] = cmd;
+    memcpy(frame + 2, payload.data(), payload.size());
+    uint16_t crc = Console::crc16(frame, payload.size() + 2);
+    frame[payload.size() + 2] = crc & 0xFF;
+    frame[payload.size() + 3] = crc >> 8;
+    size_t len = Console::cobsEncode(frame, payload.size() + 4, out);
+    return std::string(1, '\0') + std::string((const char*) out, len) + std::string(1, '\0');
+}
+
+static std::string exchange(const std::string& rx) {
+    port.rx = rx;
+    port.tx.clear();
+    host->poll();
+    TEST_ASSERT_EQUAL(0, port.rx.size());
+    return port.tx;
+}
+
+void setUp() {
+    port = HardwareSerial();
+    port.capture = true;
+    host = new Console(port);
+    host->begin();
+}
+
+void tearDown() {
+    delete host;
+}
+
+// ----------------------------------------------------------------------------
+// CRC-16/CCITT-FALSE check value, and chaining
+// ----------------------------------------------------------------------------
+static void test_crc16() {
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, Console::crc16(check, 9));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, Console::crc16(check, 0));
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, Console::crc16(check + 4, 5, Console::crc16(check, 4)));
+}
+
+// ----------------------------------------------------------------------------
+// COBS vectors, a full 254 byte block and round trips with many zeros
+// ----------------------------------------------------------------------------
+static void test_cobs() {
+    const CobsVector vectors[] = {
+        { "",                                    bytes({ 0x01 }) },
+        { bytes({ 0x00 }),                       bytes({ 0x01, 0x01 }) },
+        { bytes({ 0x00, 0x00 }),                 bytes({ 0x01, 0x01, 0x01 }) },
+        { bytes({ 0x00, 0x11, 0x00 }),           bytes({ 0x01, 0x02, 0x11, 0x01 }) },
+        { bytes({ 0x11, 0x22, 0x00, 0x33 }),     bytes({ 0x03, 0x11, 0x22, 0x02, 0x33 }) },
+        { bytes({ 0x11, 0x22, 0x33, 0x44 }),     bytes({ 0x05, 0x11, 0x22, 0x33, 0x44 }) },
+        { bytes({ 0x11, 0x00, 0x00, 0x00 }),     bytes({ 0x02, 0x11, 0x01, 0x01, 0x01 }) },
+    };
+    uint8_t out[600];
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        const CobsVector& v = vectors[i];
+        size_t len = Console::cobsEncode((const uint8_t*) v.data.data(), v.data.size(), out);
+        TEST_ASSERT_EQUAL(v.encoded.size(), len);
+        TEST_ASSERT_EQUAL_MEMORY(v.encoded.data(), out, len);
+        if (!v.data.empty()) {
+            TEST_ASSERT_EQUAL(v.data.size(), Console::cobsDecode((const uint8_t*) v.encoded.data(), len, out));
+            TEST_ASSERT_EQUAL_MEMORY(v.data.data(), out, v.data.size());
+        }
+    }
+
+    // a full block is closed with an extra 0x01, both forms decode
+    uint8_t run[254], encoded[256];
+    for (uint8_t i = 0; i < sizeof(run); i++) {
+        run[i] = i + 1;
+    }
+    TEST_ASSERT_EQUAL(256, Console::cobsEncode(run, sizeof(run), encoded));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, encoded[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, encoded[255]);
+    TEST_ASSERT_EQUAL(254, Console::cobsDecode(encoded, 256, out));
+    TEST_ASSERT_EQUAL_MEMORY(run, out, 254);
+    TEST_ASSERT_EQUAL(254, Console::cobsDecode(encoded, 255, out));
+
+    srand(5);
+    for (size_t n = 1; n < 520; n += 3) {
+        uint8_t data[520];
+        for (size_t i = 0; i < n; i++) {
+            data[i] = rand() % 4 ? rand() % 256 : 0;
+        }
+        size_t len = Console::cobsEncode(data, n, out);
+        TEST_ASSERT_TRUE(len <= n + n / 254 + 2);
+        TEST_ASSERT_NULL(memchr(out, 0, len));
+        uint8_t back[600];
+        TEST_ASSERT_EQUAL(n, Console::cobsDecode(out, len, back));
+        TEST_ASSERT_EQUAL_MEMORY(data, back, n);
+    }
+    const uint8_t truncated[] = { 0x05, 0x11, 0x22 };
+    TEST_ASSERT_EQUAL(0, Console::cobsDecode(truncated, sizeof(truncated), out));
+}
+
+// ----------------------------------------------------------------------------
+// The exact bytes tools/badge_console.py sends for a ping and the exact
+// answer it expects, pipelined with an unknown command
+// ----------------------------------------------------------------------------
+static void test_client_bytes() {
+    std::string ping = bytes({ 0x00, 0x03, 0x01, 0x01, 0x03, 0x68, 0x69, 0x03, 0x99, 0x62, 0x00 });
+    std::string pong = bytes({ 0x00, 0x03, 0x01, 0x81, 0x01, 0x03, 0x68, 0x69, 0x03, 0x57, 0x5B, 0x00 });
+    std::string unknown = bytes({ 0x00, 0x05, 0x02, 0x1F, 0xB3, 0x98, 0x00 });
+    std::string refused = bytes({ 0x00, 0x06, 0x02, 0x9F, 0x01, 0x08, 0xBA, 0x00 });
+
+    TEST_ASSERT_TRUE(request(1, CONSOLE_CMD_PING, bytes({ 0x00, 'h', 'i', 0x00 })) == ping);
+    TEST_ASSERT_TRUE(exchange(ping) == pong);
+    TEST_ASSERT_TRUE(exchange(unknown) == refused);
+    TEST_ASSERT_TRUE(exchange(ping + unknown + ping) == pong + refused + pong);
+}
+
+// ----------------------------------------------------------------------------
+// Bad CRCs, debug text, malformed and oversized frames are dropped, the
+// next good frame is answered
+// ----------------------------------------------------------------------------
+static void test_junk_is_dropped() {
+    std::string ping = request(7, CONSOLE_CMD_PING, "ok");
+    std::string bad = ping;
+    bad[bad.size() - 2] ^= 0x40;
+
+    std::string good = exchange(ping);
+    TEST_ASSERT_TRUE(good.size() > 0);
+    TEST_ASSERT_EQUAL(0, exchange(bad).size());
+    TEST_ASSERT_EQUAL(0, exchange(std::string("debug text\r\n") + bytes({ 0x00 })).size());
+    TEST_ASSERT_EQUAL(0, exchange(bytes({ 0x00, 0x05, 0x11, 0x22, 0x00 })).size());
+    TEST_ASSERT_EQUAL(0, exchange(std::string(CONSOLE_MAX_ENCODED + 10, 'x') + bytes({ 0x00 })).size());
+    TEST_ASSERT_TRUE(exchange(bad + ping) == good);
+
+    // a frame split over two polls
+    TEST_ASSERT_EQUAL(0, exchange(ping.substr(0, 4)).size());
+    TEST_ASSERT_TRUE(exchange(ping.substr(4)) == good);
+}
+
+// ----------------------------------------------------------------------------
+// A payload as big as a response can hold echoes, one byte more is refused
+// ----------------------------------------------------------------------------
+static void test_payload_limit() {
+    std::string payload;
+    for (uint16_t i = 0; i < CONSOLE_MAX_PAYLOAD; i++) {
+        payload += (char) (i % 3 ? i : 0);
+    }
+    std::string answer = exchange(request(9, CONSOLE_CMD_PING, payload));
+    uint8_t frame[CONSOLE_MAX_ENCODED];
+    size_t len = Console::cobsDecode((const uint8_t*) answer.data() + 1, answer.size() - 2, frame);
+    TEST_ASSERT_EQUAL(CONSOLE_MAX_PAYLOAD + 5, len);
+    TEST_ASSERT_EQUAL_HEX8(CONSOLE_OK, frame[2]);
+    TEST_ASSERT_EQUAL_MEMORY(payload.data(), frame + 3, CONSOLE_MAX_PAYLOAD);
+}
+
+// ----------------------------------------------------------------------------
+// SET_BAUD answers at the old rate, switches, and falls back when the host
+// doesn't confirm at the new one in time
+// ----------------------------------------------------------------------------
+static void test_set_baud() {
+    uint32_t rate = 921600;
+    std::string set = request(3, CONSOLE_CMD_SET_BAUD, std::string((const char*) &rate, 4));
+    TEST_ASSERT_TRUE(exchange(set).size() > 0);
+    TEST_ASSERT_EQUAL_UINT32(921600, port.baud);
+
+    stubAdvance(CONSOLE_BAUD_CONFIRM_MS + 1);
+    exchange("");
+    TEST_ASSERT_EQUAL_UINT32(CONSOLE_DEFAULT_BAUD, port.baud);
+
+    exchange(set);
+    TEST_ASSERT_TRUE(exchange(request(4, CONSOLE_CMD_PING, "baud")).size() > 0);
+    stubAdvance(CONSOLE_BAUD_CONFIRM_MS + 1);
+    exchange("");
+    TEST_ASSERT_EQUAL_UINT32(921600, port.baud);
+
+    rate = 12345;
+    std::string odd = request(5, CONSOLE_CMD_SET_BAUD, std::string((const char*) &rate, 4));
+    std::string answer = exchange(odd);
+    uint8_t frame[CONSOLE_MAX_ENCODED];
+    TEST_ASSERT_EQUAL(5, Console::cobsDecode((const uint8_t*) answer.data() + 1, answer.size() - 2, frame));
+    TEST_ASSERT_EQUAL_HEX8(CONSOLE_ERR_ARGS, frame[2]);
+    TEST_ASSERT_EQUAL_UINT32(921600, port.baud);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16);
+    RUN_TEST(test_cobs);
+    RUN_TEST(test_client_bytes);
+    RUN_TEST(test_junk_is_dropped);
+    RUN_TEST(test_payload_limit);
+    RUN_TEST(test_set_baud);
+    return UNITY_END();
+}
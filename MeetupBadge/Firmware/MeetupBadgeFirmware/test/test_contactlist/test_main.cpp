@@ -0,0 +1,251 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the contact list view
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "contactlist.h"
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Flash in RAM that counts the reads, a scroll must not get dearer with the
+// size of the log
+// ----------------------------------------------------------------------------
+class MemFlash : public FlashDevice {
+  public:
+    std::vector<uint8_t> image;
+    uint32_t reads = 0;
+
+    explicit MemFlash(uint32_t len) : image(len, FLASH_ERASED) {}
+
+    bool read(uint32_t offset, void* buf, size_t len) override {
+        reads++;
+        if (offset + len > image.size()) {
+            return false;
+        }
+        memcpy(buf, &image[offset], len);
+        return true;
+    }
+    bool write(uint32_t offset, const void* buf, size_t len) override {
+        for (size_t i = 0; i < len; i++) {
+            image[offset + i] &= ((const uint8_t*) buf)[i];
+        }
+        return true;
+    }
+    bool erase(uint32_t offset, size_t len) override {
+        memset(&image[offset], FLASH_ERASED, len);
+        return true;
+    }
+    uint32_t size() const override { return image.size(); }
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : fill
+// DESCRIPTION : Append count distinct contacts, record i has uid 04 i 010203
+// ----------------------------------------------------------------------------
+static void fill(ContactStore& store, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t uid[CONTACT_UID_MAX] = { 0x04, (uint8_t) (i >> 16), (uint8_t) (i >> 8), (uint8_t) i, 0x01, 0x02, 0x03 };
+        TEST_ASSERT_TRUE(store.append(uid, sizeof(uid), i));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : assertRows
+// DESCRIPTION : The view shows list positions top.. of a fill()ed store
+// ----------------------------------------------------------------------------
+static void assertRows(Adafruit_SSD1306& display, uint32_t count, uint32_t top) {
+    char title[32];
+    snprintf(title, sizeof(title), "CONTACTS %lu/%lu", (unsigned long) top + 1, (unsigned long) count);
+    TEST_ASSERT_EQUAL_STRING(title, display.line(0).c_str());
+    for (uint8_t line = 0; line < LIST_ROWS; line++) {
+        char expected[32] = "";
+        if (top + line < count) {
+            uint32_t index = count - 1 - top - line;
+            snprintf(expected, sizeof(expected), "%5lu 04%02X%02X%02X010203", (unsigned long) index + 1,
+                     (unsigned) (index >> 16) & 0xFF, (unsigned) (index >> 8) & 0xFF, (unsigned) index & 0xFF);
+        }
+        TEST_ASSERT_EQUAL_STRING(expected, display.line(line + 1).c_str());
+    }
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// Tests
+// ----------------------------------------------------------------------------
+static void test_empty() {
+    MemFlash flash(0x80000);
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash));
+    Adafruit_SSD1306 display;
+    ContactList list(display, store);
+    list.open();
+    TEST_ASSERT_EQUAL_STRING("CONTACTS none yet", display.line(0).c_str());
+    TEST_ASSERT_EQUAL_STRING("", display.line(1).c_str());
+}
+
+static void test_open_newest() {
+    MemFlash flash(0x80000);
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash));
+    fill(store, 10);
+    Adafruit_SSD1306 display;
+    ContactList list(display, store);
+    list.open();
+    assertRows(display, 10, 0);
+}
+
+// a list reopened after a restart starts at the saved position, clamped so
+// the last screen is full
+static void test_open_at_position() {
+    MemFlash flash(0x80000);
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash));
+    fill(store, 1000);
+    Adafruit_SSD1306 display;
+    ContactList list(display, store);
+
+    list.open(500);
+    TEST_ASSERT_EQUAL_UINT32(500, list.position());
+    assertRows(display, 1000, 500);
+
+    list.open(5000);
+    TEST_ASSERT_EQUAL_UINT32(1000 - LIST_ROWS, list.position());
+    assertRows(display, 1000, 1000 - LIST_ROWS);
+}
+
+static void test_scroll() {
+    const uint32_t count = 10000;
+    MemFlash flash(0x80000);
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash));
+    fill(store, count);
+    Adafruit_SSD1306 display;
+    ContactList list(display, store);
+    list.open();
+
+    uint32_t most = 0;
+    for (uint8_t i = 0; i < 40; i++) {
+        flash.reads = 0;
+        list.scroll(1);
+        most = flash.reads > most ? flash.reads : most;
+    }
+    for (uint8_t i = 0; i < 15; i++) {
+        flash.reads = 0;
+        list.scroll(-1);
+        most = flash.reads > most ? flash.reads : most;
+    }
+    assertRows(display, count, 25);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(3, most);
+
+    // the ends stop the view
+    for (uint8_t i = 0; i < 30; i++) {
+        list.scroll(-1);
+    }
+    assertRows(display, count, 0);
+}
+
+// compaction renumbers the records under an open list, the next scroll
+// draws the new log instead of cached rows of the old one
+static void test_compaction_under_open_list() {
+    MemFlash flash(0x20000);
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash));
+
+    // 40 people tapping over and over, until a compaction is due
+    uint32_t taps = 0;
+    while (!store.compact(0)) {
+        uint8_t who = taps % 40;
+        uint8_t uid[CONTACT_UID_MAX] = { 0x04, 0x00, 0x00, who, 0x01, 0x02, 0x03 };
+        TEST_ASSERT_TRUE(store.append(uid, sizeof(uid), taps++));
+    }
+
+    Adafruit_SSD1306 display;
+    ContactList list(display, store);
+    list.open();
+    list.scroll(1);
+    TEST_ASSERT_EQUAL_UINT32(taps, store.count());
+
+    while (store.compact(1000000)) {
+    }
+    TEST_ASSERT_EQUAL_UINT32(40, store.count());
+
+    list.scroll(1);
+    TEST_ASSERT_EQUAL_STRING("CONTACTS 2/40", display.line(0).c_str());
+    for (uint8_t line = 0; line < LIST_ROWS; line++) {
+        uint32_t index = 40 - 1 - 1 - line;
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%5lu 040000%02X010203", (unsigned long) index + 1, (unsigned) index);
+        TEST_ASSERT_EQUAL_STRING(expected, display.line(line + 1).c_str());
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty);
+    RUN_TEST(test_open_newest);
+    RUN_TEST(test_open_at_position);
+    RUN_TEST(test_scroll);
+    RUN_TEST(test_compaction_under_open_list);
+    return UNITY_END();
+}
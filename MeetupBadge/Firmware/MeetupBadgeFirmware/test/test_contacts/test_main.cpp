@@ -0,0 +1,311 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the contact log on a file backed flash image
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <set>
+#include <vector>
+
+#include "contacts.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define IMAGE       ".pio/test_contacts.img"
+#define IMAGE_BYTES 0x80000           // the badge partition
+
+// ============================================================================
+// TYPES
+// ============================================================================
+struct Tap {
+    uint8_t uid[CONTACT_UID_MAX];
+    uint32_t seconds;
+    uint8_t flags;
+};
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static uint8_t masterA[CONTACT_MASTER_BYTES];
+static uint8_t masterB[CONTACT_MASTER_BYTES];
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : makeTap
+// DESCRIPTION : A 7 byte uid of person who, sharing the first 3 bytes
+// ----------------------------------------------------------------------------
+static Tap makeTap(uint16_t who, uint32_t seconds, uint8_t flags = CONTACT_FLAGS) {
+    Tap t;
+    const uint8_t uid[CONTACT_UID_MAX] = { 0x04, 0x11, 0x22, (uint8_t) (who >> 8), (uint8_t) who, 0x80, 0x01 };
+    memcpy(t.uid, uid, sizeof(uid));
+    t.seconds = seconds;
+    t.flags = flags;
+    return t;
+}
+
+static void assertRecord(ContactStore& store, uint32_t index, const Tap& tap) {
+    ContactRecord rec;
+    TEST_ASSERT_TRUE(store.read(index, rec));
+    TEST_ASSERT_EQUAL(CONTACT_UID_MAX, rec.uidLength);
+    TEST_ASSERT_EQUAL_MEMORY(tap.uid, rec.uid, CONTACT_UID_MAX);
+    TEST_ASSERT_EQUAL_UINT32(tap.seconds, rec.seconds);
+    TEST_ASSERT_EQUAL_UINT8(tap.flags, rec.flags);
+}
+
+void setUp() {
+    memset(masterA, 0xA5, sizeof(masterA));
+    memset(masterB, 0x5A, sizeof(masterB));
+    remove(IMAGE);
+}
+
+void tearDown() {
+    remove(IMAGE);
+}
+
+// ----------------------------------------------------------------------------
+// Records come back in order and survive a reboot
+// ----------------------------------------------------------------------------
+static void test_append_read_reboot() {
+    FileFlash flash;
+    TEST_ASSERT_TRUE(flash.begin(IMAGE, IMAGE_BYTES));
+    std::vector<Tap> taps;
+    {
+        ContactStore store;
+        TEST_ASSERT_TRUE(store.begin(flash, masterA));
+        TEST_ASSERT_TRUE(store.encrypted());
+        for (uint16_t i = 0; i < 500; i++) {
+            Tap t = makeTap(i % 97, 100 + i * 7, i % 13 ? CONTACT_FLAGS : 0xFE);
+            TEST_ASSERT_TRUE(store.append(t.uid, CONTACT_UID_MAX, t.seconds, t.flags));
+            taps.push_back(t);
+        }
+
+        // the same uid twice in a row is one contact
+        const Tap& t = taps.back();
+        TEST_ASSERT_FALSE(store.append(t.uid, CONTACT_UID_MAX, t.seconds + 1));
+    }
+
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash, masterA));
+    TEST_ASSERT_EQUAL_UINT32(taps.size(), store.count());
+    TEST_ASSERT_EQUAL_UINT32(97, store.unique());
+    for (uint32_t i = 0; i < taps.size(); i++) {
+        assertRecord(store, i, taps[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// A begin() that fails must leave the log alone. It used to keep the flash
+// attached with an empty tail, the first idle compact() then activated the
+// other, empty half and the log was gone.
+// ----------------------------------------------------------------------------
+static void assertLocked(ContactStore& store) {
+    uint8_t uid[CONTACT_UID_MAX] = { 1, 2, 3, 4, 5, 6, 7 };
+    ContactRecord rec;
+    TEST_ASSERT_FALSE(store.compact(1000000));
+    TEST_ASSERT_FALSE(store.compacting());
+    TEST_ASSERT_FALSE(store.snapshotDue());
+    TEST_ASSERT_FALSE(store.snapshot());
+    TEST_ASSERT_FALSE(store.append(uid, sizeof(uid), 1));
+    TEST_ASSERT_FALSE(store.read(0, rec));
+}
+
+static void test_failed_begin_keeps_log() {
+    FileFlash flash;
+    TEST_ASSERT_TRUE(flash.begin(IMAGE, IMAGE_BYTES));
+    std::vector<Tap> taps;
+    {
+        ContactStore store;
+        TEST_ASSERT_TRUE(store.begin(flash, masterA));
+        for (uint16_t i = 0; i < 300; i++) {
+            Tap t = makeTap(i % 40, 10 + i);
+            TEST_ASSERT_TRUE(store.append(t.uid, CONTACT_UID_MAX, t.seconds, t.flags));
+            taps.push_back(t);
+        }
+    }
+
+    // a different master, then none at all, as after a lost NVS key
+    {
+        ContactStore store;
+        TEST_ASSERT_FALSE(store.begin(flash, masterB));
+        TEST_ASSERT_EQUAL(CONTACT_WRONG_KEY, store.status());
+        TEST_ASSERT_TRUE(store.locked());
+        assertLocked(store);
+    }
+    {
+        ContactStore store;
+        TEST_ASSERT_FALSE(store.begin(flash));
+        TEST_ASSERT_EQUAL(CONTACT_NO_KEY, store.status());
+        TEST_ASSERT_TRUE(store.locked());
+        assertLocked(store);
+    }
+
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash, masterA));
+    TEST_ASSERT_EQUAL_UINT32(taps.size(), store.count());
+    for (uint32_t i = 0; i < taps.size(); i++) {
+        assertRecord(store, i, taps[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// A locked log is only replaced by an explicit erase(), which starts a new
+// log under the new master
+// ----------------------------------------------------------------------------
+static void test_erase_locked_log() {
+    FileFlash flash;
+    TEST_ASSERT_TRUE(flash.begin(IMAGE, IMAGE_BYTES));
+    {
+        ContactStore store;
+        TEST_ASSERT_FALSE(store.erase(masterA));
+        TEST_ASSERT_EQUAL(CONTACT_NO_FLASH, store.status());
+        TEST_ASSERT_TRUE(store.begin(flash, masterA));
+        TEST_ASSERT_EQUAL(CONTACT_OK, store.status());
+        for (uint16_t i = 0; i < 50; i++) {
+            Tap t = makeTap(i, 10 + i);
+            TEST_ASSERT_TRUE(store.append(t.uid, CONTACT_UID_MAX, t.seconds, t.flags));
+        }
+    }
+
+    ContactStore store;
+    TEST_ASSERT_FALSE(store.begin(flash, masterB));
+    TEST_ASSERT_TRUE(store.locked());
+    TEST_ASSERT_TRUE(store.erase(masterB));
+    TEST_ASSERT_EQUAL(CONTACT_OK, store.status());
+    TEST_ASSERT_FALSE(store.locked());
+    TEST_ASSERT_TRUE(store.encrypted());
+    TEST_ASSERT_EQUAL_UINT32(0, store.count());
+    Tap t = makeTap(7, 1000);
+    TEST_ASSERT_TRUE(store.append(t.uid, CONTACT_UID_MAX, t.seconds, t.flags));
+
+    ContactStore reopened;
+    TEST_ASSERT_FALSE(reopened.begin(flash, masterA));
+    TEST_ASSERT_TRUE(reopened.begin(flash, masterB));
+    TEST_ASSERT_EQUAL_UINT32(1, reopened.count());
+    assertRecord(reopened, 0, t);
+}
+
+// ----------------------------------------------------------------------------
+// Compaction in slices of a few steps with reboots in between keeps the first
+// visible record of every uid, in order
+// ----------------------------------------------------------------------------
+static void test_compaction() {
+    FileFlash flash;
+    TEST_ASSERT_TRUE(flash.begin(IMAGE, IMAGE_BYTES));
+    std::vector<Tap> expected;
+    ContactStore* store = new ContactStore;
+    TEST_ASSERT_TRUE(store->begin(flash, masterA));
+
+    srand(5);
+    uint32_t seconds = 100;
+    uint8_t compactions = 0;
+    uint32_t aborted = 0;
+    for (uint32_t step = 0; step < 200000 && compactions < 3; step++) {
+        seconds += 5 + rand() % 300;
+        Tap t = makeTap(rand() % 300, seconds, rand() % 40 ? CONTACT_FLAGS : 0xFE);
+        if (store->append(t.uid, CONTACT_UID_MAX, t.seconds, t.flags)) {
+            expected.push_back(t);
+        }
+
+        if (rand() % 3 == 0) {
+            bool was = store->compacting();
+            if (!store->compactSteps(16) && was) {
+                compactions++;
+                std::vector<Tap> kept;
+                std::set<uint32_t> uids;
+                for (size_t i = 0; i < expected.size(); i++) {
+                    uint32_t who = expected[i].uid[3] << 8 | expected[i].uid[4];
+                    if ((expected[i].flags & CONTACT_FLAG_HIDDEN) && uids.insert(who).second) {
+                        kept.push_back(expected[i]);
+                    }
+                }
+                expected.swap(kept);
+                TEST_ASSERT_EQUAL_UINT32(expected.size(), store->count());
+            }
+        }
+        if (store->snapshotDue() && rand() % 2) {
+            store->snapshot();
+        }
+        if (rand() % 5000 == 0) {
+            aborted += store->compacting();
+            delete store;
+            store = new ContactStore;
+            TEST_ASSERT_TRUE(store->begin(flash, masterA));
+            TEST_ASSERT_EQUAL_UINT32(expected.size(), store->count());
+        }
+    }
+    TEST_ASSERT_EQUAL(3, compactions);
+    delete store;
+
+    ContactStore reopened;
+    TEST_ASSERT_TRUE(reopened.begin(flash, masterA));
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), reopened.count());
+    for (uint32_t i = 0; i < expected.size(); i++) {
+        assertRecord(reopened, i, expected[i]);
+    }
+    // format made generation 1, every erase pass took the next one, also
+    // those of the runs a reboot aborted
+    const ContactWear& wear = reopened.wear();
+    TEST_ASSERT_GREATER_THAN_UINT32(0, aborted);
+    TEST_ASSERT_EQUAL_UINT32(1 + wear.erases[0] + wear.erases[1], wear.generation);
+    TEST_ASSERT_TRUE(wear.generation >= 4);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_append_read_reboot);
+    RUN_TEST(test_failed_begin_keeps_log);
+    RUN_TEST(test_erase_locked_log);
+    RUN_TEST(test_compaction);
+    return UNITY_END();
+}
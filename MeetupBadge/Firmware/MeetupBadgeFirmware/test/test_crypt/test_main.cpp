@@ -0,0 +1,228 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests and throughput of the contact log with and without encryption
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "contacts.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define IMAGE       ".pio/test_crypt.img"
+#define IMAGE_BYTES 0x80000           // the badge partition
+#define RECORDS     8000              // appended per run, all different uids
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NOR flash in RAM, so the benchmark measures the store and not the disk
+// ----------------------------------------------------------------------------
+class MemFlash : public FlashDevice {
+  public:
+    std::vector<uint8_t> image;
+
+    explicit MemFlash(uint32_t len) : image(len, FLASH_ERASED) {}
+
+    bool read(uint32_t offset, void* buf, size_t len) override {
+        if (offset + len > image.size()) {
+            return false;
+        }
+        memcpy(buf, &image[offset], len);
+        return true;
+    }
+    bool write(uint32_t offset, const void* buf, size_t len) override {
+        for (size_t i = 0; i < len; i++) {
+            image[offset + i] &= ((const uint8_t*) buf)[i];
+        }
+        return true;
+    }
+    bool erase(uint32_t offset, size_t len) override {
+        memset(&image[offset], FLASH_ERASED, len);
+        return true;
+    }
+    uint32_t size() const override { return image.size(); }
+};
+
+// what one run measured, records per second
+struct Throughput {
+    double append;
+    double scan;
+    double boot;                      // ms
+};
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static uint8_t master[CONTACT_MASTER_BYTES];
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// the odd multiplier keeps the uids apart and their tails unlike the zero
+// padded header fields
+static void makeUid(uint32_t i, uint8_t* uid) {
+    uint32_t tail = (i + 1) * 2654435761u;
+    const uint8_t bytes[CONTACT_UID_MAX] = { 0x04, 0x5C, 0x3A, (uint8_t) (tail >> 24), (uint8_t) (tail >> 16), (uint8_t) (tail >> 8), (uint8_t) tail };
+    memcpy(uid, bytes, sizeof(bytes));
+}
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : run
+// DESCRIPTION : Append RECORDS, boot, read them all back in order
+// ----------------------------------------------------------------------------
+static Throughput run(FlashDevice& flash, const uint8_t* key) {
+    Throughput result;
+    {
+        ContactStore store;
+        TEST_ASSERT_TRUE(store.begin(flash, key));
+        TEST_ASSERT_EQUAL(key != nullptr, store.encrypted());
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < RECORDS; i++) {
+            uint8_t uid[CONTACT_UID_MAX];
+            makeUid(i, uid);
+            TEST_ASSERT_TRUE(store.append(uid, CONTACT_UID_MAX, 1000 + i));
+        }
+        result.append = RECORDS / seconds(start);
+    }
+
+    ContactStore store;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    TEST_ASSERT_TRUE(store.begin(flash, key));
+    result.boot = seconds(start) * 1e3;
+    TEST_ASSERT_EQUAL_UINT32(RECORDS, store.count());
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < RECORDS; i++) {
+        ContactRecord rec;
+        uint8_t uid[CONTACT_UID_MAX];
+        makeUid(i, uid);
+        TEST_ASSERT_TRUE(store.read(i, rec));
+        TEST_ASSERT_EQUAL_MEMORY(uid, rec.uid, CONTACT_UID_MAX);
+        TEST_ASSERT_EQUAL_UINT32(1000 + i, rec.seconds);
+    }
+    result.scan = RECORDS / seconds(start);
+    return result;
+}
+
+// true if the last 4 bytes of any uid are in the image as tapped, a plain
+// log keeps them even in dictionary form
+static bool uidsInClear(const MemFlash& flash) {
+    for (uint32_t i = 0; i < RECORDS; i += 97) {
+        uint8_t uid[CONTACT_UID_MAX];
+        makeUid(i, uid);
+        for (size_t at = 0; at + sizeof(uid) <= flash.image.size(); at++) {
+            if (!memcmp(&flash.image[at], uid + 3, 4)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void setUp() {
+    memset(master, 0x6B, sizeof(master));
+}
+
+void tearDown() {
+    remove(IMAGE);
+}
+
+// ----------------------------------------------------------------------------
+// A plain log shows the uids on flash, an encrypted one doesn't
+// ----------------------------------------------------------------------------
+static void test_nothing_in_clear() {
+    MemFlash plain(IMAGE_BYTES);
+    run(plain, nullptr);
+    TEST_ASSERT_TRUE(uidsInClear(plain));
+
+    MemFlash encrypted(IMAGE_BYTES);
+    run(encrypted, master);
+    TEST_ASSERT_FALSE(uidsInClear(encrypted));
+}
+
+// ----------------------------------------------------------------------------
+// Append, boot and scan with encryption off and on, in RAM and on a file
+// image. Printed only, the host has no AES peripheral.
+// ----------------------------------------------------------------------------
+static void test_throughput() {
+    for (uint8_t file = 0; file < 2; file++) {
+        for (uint8_t encrypted = 0; encrypted < 2; encrypted++) {
+            MemFlash mem(IMAGE_BYTES);
+            FileFlash disk;
+            if (file) {
+                remove(IMAGE);
+                TEST_ASSERT_TRUE(disk.begin(IMAGE, IMAGE_BYTES));
+            }
+            Throughput t = run(file ? (FlashDevice&) disk : (FlashDevice&) mem, encrypted ? master : nullptr);
+
+            char message[128];
+            snprintf(message, sizeof(message), "%-4s %-9s: append %6.0fk rec/s, scan %6.0fk rec/s, boot %6.2f ms",
+                     file ? "file" : "RAM", encrypted ? "encrypted" : "plain", t.append / 1e3, t.scan / 1e3, t.boot);
+            TEST_MESSAGE(message);
+        }
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_nothing_in_clear);
+    RUN_TEST(test_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,179 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the Effect cross-fade and its hardware backends
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_PWMServoDriver.h>
+#include <Noiasca_led.h>
+#include <utility/Noiasca_PCA9685.h>
+#include <utility/Noiasca_HT16K33.h>
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// A colored output that counts its writes
+// ----------------------------------------------------------------------------
+class CountPin {
+  public:
+    uint32_t writes = 0;              // digWrite() and pwmWrite()
+    uint32_t colors = 0;              // setOnColor() and setOffColor()
+    uint16_t level = 0;
+    uint32_t onColor = 0;
+
+    void begin() {}
+    void digWrite(uint8_t val) {
+        writes++;
+        level = val ? 255 : 0;
+    }
+    void pwmWrite(uint16_t val) {
+        writes++;
+        level = val;
+    }
+    void setOnColor(uint32_t color) {
+        colors++;
+        onColor = color;
+    }
+    void setOffColor(uint32_t) { colors++; }
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+void setUp() {
+    stubMillis() = 0;
+    Wire.sent.clear();
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// During the cross-fade each update() writes the level at most once, the
+// colors at most once each, at the end the output shows the new effect
+// ----------------------------------------------------------------------------
+static void test_crossfade_one_write_per_frame() {
+    CountPin pin;
+    Effect<CountPin> effect(pin);
+    effect.setModeBlink();
+    effect.setOnColor(0xFF0000);
+    effect.on();
+    for (uint32_t t = 0; t < 700; t += 10) {
+        stubAdvance(10);
+        effect.update();
+    }
+
+    Effect<CountPin>::Config config = effect.getConfig(Effect<CountPin>::HEARTBEAT);
+    config.onColor = 0x0000FF;
+    pin.writes = 0;
+    pin.colors = 0;
+    effect.reconfigure(config, 400);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.writes);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.colors);
+
+    uint32_t frames = 0;
+    uint32_t end = millis() + 400;
+    while (millis() < end) {
+        stubAdvance(5);
+        uint32_t writes = pin.writes;
+        uint32_t colors = pin.colors;
+        effect.update();
+        TEST_ASSERT_TRUE(pin.writes - writes <= 1);
+        TEST_ASSERT_TRUE(pin.colors - colors <= 2);
+        frames++;
+    }
+    TEST_ASSERT_TRUE(pin.writes <= frames);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, pin.writes);
+
+    // the end of the fade hands over to the effect
+    stubAdvance(5);
+    effect.update();
+    TEST_ASSERT_EQUAL_HEX32(0x0000FF, pin.onColor);
+    TEST_ASSERT_EQUAL(Effect<CountPin>::HEARTBEAT, effect.getConfig().mode);
+}
+
+// ----------------------------------------------------------------------------
+// Outputs without color take part in reconfigure() and the cross-fade
+// ----------------------------------------------------------------------------
+static void test_mono_backends() {
+    Adafruit_PWMServoDriver pwm;
+    EffectPCA9685 pca(pwm, 3);
+    HT16K33expander ic(0x70);
+    ic.begin();
+    EffectHT16K33 ht(ic, 5);
+
+    pca.setModeBlink();
+    ht.setModeBlink();
+    pca.setOnColor(0x00FF00);
+    ht.setOffColor(0x000000);
+    pca.on();
+    ht.on();
+    pca.reconfigure(pca.getConfig(EffectPCA9685::SMOOTH), 200);
+    ht.reconfigure(ht.getConfig(EffectHT16K33::SMOOTH), 200);
+    Wire.sent.clear();
+    for (uint32_t t = 0; t < 1000; t += 10) {
+        stubAdvance(10);
+        pca.update();
+        ht.update();
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(0, Wire.sent.size());
+    TEST_ASSERT_EQUAL(EffectPCA9685::SMOOTH, pca.getConfig().mode);
+    TEST_ASSERT_EQUAL(EffectHT16K33::SMOOTH, ht.getConfig().mode);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crossfade_one_write_per_frame);
+    RUN_TEST(test_mono_backends);
+    return UNITY_END();
+}
@@ -0,0 +1,219 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the hardware fade path of Smooth and Heartbeat
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// An output that fades on its own like the ESP32 LEDC. A write while a fade
+// runs would wait for its end, it's counted as blocked instead.
+// ----------------------------------------------------------------------------
+class FadePin {
+  public:
+    uint16_t level = 0;               // duty written or at the end of the fade
+    uint32_t fadeEnd = 0;             // millis() the running fade ends
+    uint32_t fades = 0;
+    uint32_t blocked = 0;             // writes that would have waited
+
+    void begin() {}
+    void digWrite(uint8_t val) { pwmWrite(val ? 255 : 0); }
+    void pwmWrite(int pwm) {
+        if (millis() < fadeEnd) {
+            blocked++;
+        }
+        level = pwm;
+    }
+    bool fadeTo(uint16_t target, uint32_t duration) {
+        if (millis() < fadeEnd) {
+            blocked++;
+        }
+        level = target;
+        fadeEnd = millis() + duration;
+        fades++;
+        return true;
+    }
+    void setOnColor(uint32_t) {}
+    void setOffColor(uint32_t) {}
+};
+
+template<>
+struct OutputTraits<FadePin> : OutputTraitsBase<FadePin> {
+    static constexpr bool hardwareFade = true;
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// runs update() every 5 ms up to the time given
+template<class Effect>
+static void runUntil(Effect& effect, uint32_t until) {
+    while (millis() < until) {
+        stubAdvance(5);
+        effect.update();
+    }
+}
+
+void setUp() {
+    stubMillis() = 0;
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// The ramps go to the hardware in segments, no write lands inside one
+// ----------------------------------------------------------------------------
+static void test_heartbeat_segments() {
+    FadePin pin;
+    Heartbeat<FadePin> beat(pin);
+    runUntil(beat, 3000);
+    TEST_ASSERT_GREATER_THAN_UINT32(5, pin.fades);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+}
+
+// ----------------------------------------------------------------------------
+// off() within a segment doesn't wait for it, the output goes dark at its end
+// ----------------------------------------------------------------------------
+static void test_heartbeat_off_in_fade() {
+    FadePin pin;
+    Heartbeat<FadePin> beat(pin);
+    runUntil(beat, 100);
+    TEST_ASSERT_TRUE(millis() < pin.fadeEnd);
+    uint32_t end = pin.fadeEnd;
+
+    beat.off();
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+    TEST_ASSERT_EQUAL(0, beat.getState());
+    runUntil(beat, end + 10);
+    TEST_ASSERT_EQUAL_UINT16(0, pin.level);
+    runUntil(beat, 2000);
+    TEST_ASSERT_EQUAL_UINT16(0, pin.level);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+
+    beat.on();
+    runUntil(beat, 3000);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, pin.level);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+}
+
+// ----------------------------------------------------------------------------
+// off() again before the segment ends, then on(), nothing is lost
+// ----------------------------------------------------------------------------
+static void test_heartbeat_off_on_in_fade() {
+    FadePin pin;
+    Heartbeat<FadePin> beat(pin);
+    runUntil(beat, 100);
+    beat.off();
+    beat.on();
+    runUntil(beat, 3000);
+    TEST_ASSERT_EQUAL(1, beat.getState());
+    TEST_ASSERT_GREATER_THAN_UINT32(0, pin.level);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+}
+
+// ----------------------------------------------------------------------------
+// Forced off and a new brightness within a segment are written at its end
+// ----------------------------------------------------------------------------
+static void test_smooth_in_fade() {
+    FadePin pin;
+    Smooth<FadePin> smooth(pin);
+    runUntil(smooth, 100);
+    TEST_ASSERT_TRUE(millis() < pin.fadeEnd);
+    uint32_t end = pin.fadeEnd;
+
+    smooth.offForced();
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+    TEST_ASSERT_EQUAL_UINT16(0, smooth.getCurrentLevel());
+    runUntil(smooth, end + 10);
+    TEST_ASSERT_EQUAL_UINT16(0, pin.level);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+
+    smooth.on();
+    runUntil(smooth, millis() + 50);
+    TEST_ASSERT_TRUE(millis() < pin.fadeEnd);
+    end = pin.fadeEnd;
+    smooth.getCurrentBrightness(10);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+    runUntil(smooth, end + 10);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+    runUntil(smooth, 20000);
+    TEST_ASSERT_EQUAL_UINT16(255, pin.level);
+    TEST_ASSERT_EQUAL_UINT32(0, pin.blocked);
+}
+
+// ----------------------------------------------------------------------------
+// Without a running fade the write goes out at once as before
+// ----------------------------------------------------------------------------
+static void test_smooth_idle_write() {
+    FadePin pin;
+    Smooth<FadePin> smooth(pin);
+    runUntil(smooth, 20000);
+    TEST_ASSERT_EQUAL_UINT16(255, pin.level);
+    smooth.offForced();
+    TEST_ASSERT_EQUAL_UINT16(0, pin.level);
+    smooth.getCurrentBrightness(128);
+    TEST_ASSERT_EQUAL_UINT16(128, pin.level);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_heartbeat_segments);
+    RUN_TEST(test_heartbeat_off_in_fade);
+    RUN_TEST(test_heartbeat_off_on_in_fade);
+    RUN_TEST(test_smooth_in_fade);
+    RUN_TEST(test_smooth_idle_write);
+    return UNITY_END();
+}
@@ -0,0 +1,197 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests and conversions per second of the fixed point HSV colors
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define ERROR_MAX 2                   // counts per channel against floating point
+#define BENCH     (400 * 65536UL)     // conversions per benchmark
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static volatile uint32_t sink;        // keeps the benchmark loops alive
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : referenceHSV
+// DESCRIPTION : The textbook floating point conversion, rounded
+// ----------------------------------------------------------------------------
+static uint32_t referenceHSV(uint16_t hue, uint8_t sat, uint8_t val) {
+    double h = hue / 65536.0 * 6;
+    int sector = (int) h;
+    double f = h - sector;
+    double v = val / 255.0, s = sat / 255.0;
+    double p = v * (1 - s), q = v * (1 - s * f), t = v * (1 - s * (1 - f));
+    double r, g, b;
+    switch (sector) {
+        case 0:  r = v; g = t; b = p; break;
+        case 1:  r = q; g = v; b = p; break;
+        case 2:  r = p; g = v; b = t; break;
+        case 3:  r = p; g = q; b = v; break;
+        case 4:  r = t; g = p; b = v; break;
+        default: r = v; g = p; b = q; break;
+    }
+    return (uint32_t) (r * 255 + 0.5) << 16 | (uint32_t) (g * 255 + 0.5) << 8 | (uint32_t) (b * 255 + 0.5);
+}
+
+static int channelError(uint32_t a, uint32_t b) {
+    int worst = 0;
+    for (uint8_t shift = 0; shift < 24; shift += 8) {
+        int e = abs((int) ((a >> shift) & 0xFF) - (int) ((b >> shift) & 0xFF));
+        worst = e > worst ? e : worst;
+    }
+    return worst;
+}
+
+template<class Convert>
+static double perSecond(Convert convert) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < BENCH; i++) {
+        sum += convert((uint16_t) i, (uint8_t) (i >> 3), 200);
+    }
+    sink = sum;
+    return BENCH / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// The six sector starts are the primaries and secondaries
+// ----------------------------------------------------------------------------
+static void test_primaries() {
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000, colorHSV(0));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFF00, colorHSV(65536 / 6 + 1));
+    TEST_ASSERT_EQUAL_HEX32(0x00FF00, colorHSV(65536 / 3 + 1));
+    TEST_ASSERT_EQUAL_HEX32(0x00FFFF, colorHSV(32768));
+    TEST_ASSERT_EQUAL_HEX32(0x0000FF, colorHSV(65536 * 2 / 3 + 1));
+    TEST_ASSERT_EQUAL_HEX32(0xFF00FF, colorHSV(65536 * 5 / 6 + 1));
+}
+
+// ----------------------------------------------------------------------------
+// No saturation is grey at the value, no value is black, for every hue
+// ----------------------------------------------------------------------------
+static void test_grey_and_black() {
+    for (uint32_t hue = 0; hue < 65536; hue += 97) {
+        for (uint16_t v = 0; v < 256; v += 51) {
+            TEST_ASSERT_EQUAL_HEX32(v * 0x010101UL, colorHSV(hue, 0, v));
+        }
+        TEST_ASSERT_EQUAL_HEX32(0, colorHSV(hue, 255, 0));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// At most ERROR_MAX counts per channel from the floating point conversion
+// ----------------------------------------------------------------------------
+static void test_error() {
+    int worst = 0;
+    for (uint32_t hue = 0; hue < 65536; hue += 37) {
+        for (uint16_t s = 0; s < 256; s += 15) {
+            for (uint16_t v = 0; v < 256; v += 17) {
+                int e = channelError(colorHSV(hue, s, v), referenceHSV(hue, s, v));
+                worst = e > worst ? e : worst;
+            }
+        }
+    }
+    char message[48];
+    snprintf(message, sizeof(message), "max error %d counts", worst);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_OR_EQUAL(ERROR_MAX, worst);
+}
+
+// ----------------------------------------------------------------------------
+// A hue rotation has no jumps, also where the hue overflows
+// ----------------------------------------------------------------------------
+static void test_no_jumps() {
+    uint16_t hue = 0xFF00;
+    uint32_t last = colorHSV(hue);
+    for (uint32_t i = 0; i < 65536 + 512; i++) {
+        uint32_t next = colorHSV(++hue);
+        TEST_ASSERT_LESS_OR_EQUAL(1, channelError(last, next));
+        last = next;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Conversions per second against the floating point reference, printed
+// only
+// ----------------------------------------------------------------------------
+static void test_conversions_per_second() {
+    double fixed = perSecond([](uint16_t h, uint8_t s, uint8_t v) { return colorHSV(h, s, v); });
+    double floating = perSecond(referenceHSV);
+    char message[96];
+    snprintf(message, sizeof(message), "colorHSV %.1f M/s, floating point %.1f M/s", fixed / 1e6, floating / 1e6);
+    TEST_MESSAGE(message);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_primaries);
+    RUN_TEST(test_grey_and_black);
+    RUN_TEST(test_error);
+    RUN_TEST(test_no_jumps);
+    RUN_TEST(test_conversions_per_second);
+    return UNITY_END();
+}
@@ -0,0 +1,194 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the HT16K33 hardware blink through the Blink interface
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Noiasca_led.h>
+#include <utility/Noiasca_HT16K33.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define DISPLAY_SOFTWARE 0x81         // display on, no blink
+#define DISPLAY_2HZ      0x83
+#define DISPLAY_1HZ      0x85
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// the last display setup command on the bus, 0 if none
+static uint8_t displaySetup() {
+    for (size_t i = Wire.sent.size(); i > 0; i--) {
+        const std::string& frame = Wire.sent[i - 1];
+        if (frame.size() == 1 && (frame[0] & 0xF0) == 0x80) {
+            return (uint8_t) frame[0];
+        }
+    }
+    return 0;
+}
+
+// runs update() of both effects every 10 ms for the time given
+static void run(Blink<HT16K33>& a, Blink<HT16K33>& b, uint32_t ms) {
+    for (uint32_t end = millis() + ms; millis() < end;) {
+        stubAdvance(10);
+        a.update();
+        b.update();
+    }
+}
+
+void setUp() {
+    stubMillis() = 0;
+    Wire.sent.clear();
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// Two blinkers at 500/500 go to the IC at 1 Hz, then the bus is quiet
+// ----------------------------------------------------------------------------
+static void test_shared_rate_in_hardware() {
+    HT16K33expander ic(0x70);
+    ic.begin();
+    BlinkHT16K33 a(ic, 0);
+    BlinkHT16K33 b(ic, 17);
+    run(a, b, 20);
+    TEST_ASSERT_TRUE(ic.isHardwareBlink());
+    TEST_ASSERT_EQUAL_HEX8(DISPLAY_1HZ, displaySetup());
+
+    size_t sent = Wire.sent.size();
+    run(a, b, 5000);
+    TEST_ASSERT_EQUAL_UINT32(sent, Wire.sent.size());
+}
+
+// ----------------------------------------------------------------------------
+// Intervals set through the Blink interface reach the IC, there is no
+// setter in BlinkHT16K33 to bypass
+// ----------------------------------------------------------------------------
+static void test_intervals_through_base() {
+    HT16K33expander ic(0x70);
+    ic.begin();
+    BlinkHT16K33 a(ic, 0);
+    BlinkHT16K33 b(ic, 1);
+    Blink<HT16K33>& baseA = a;
+    Blink<HT16K33>& baseB = b;
+    run(a, b, 20);
+    TEST_ASSERT_EQUAL_HEX8(DISPLAY_1HZ, displaySetup());
+
+    baseA.setOnInterval(250);
+    baseA.setOffInterval(250);
+    run(a, b, 20);
+    TEST_ASSERT_FALSE(ic.isHardwareBlink());
+    TEST_ASSERT_EQUAL_HEX8(DISPLAY_SOFTWARE, displaySetup());
+
+    size_t sent = Wire.sent.size();
+    run(a, b, 1000);
+    TEST_ASSERT_GREATER_THAN_UINT32(sent + 4, Wire.sent.size());
+
+    baseB.setOnInterval(250);
+    baseB.setOffInterval(250);
+    run(a, b, 20);
+    TEST_ASSERT_TRUE(ic.isHardwareBlink());
+    TEST_ASSERT_EQUAL_HEX8(DISPLAY_2HZ, displaySetup());
+}
+
+// ----------------------------------------------------------------------------
+// off() through LedBase ends the hardware blink of the last blinker
+// ----------------------------------------------------------------------------
+static void test_off_through_base() {
+    HT16K33expander ic(0x70);
+    ic.begin();
+    BlinkHT16K33 a(ic, 0);
+    BlinkHT16K33 b(ic, 1);
+    run(a, b, 20);
+    TEST_ASSERT_TRUE(ic.isHardwareBlink());
+
+    LedBase<HT16K33>& baseA = a;
+    LedBase<HT16K33>& baseB = b;
+    baseA.off();
+    run(a, b, 20);
+    TEST_ASSERT_TRUE(ic.isHardwareBlink());
+    baseB.off();
+    run(a, b, 20);
+    TEST_ASSERT_FALSE(ic.isHardwareBlink());
+    TEST_ASSERT_EQUAL_HEX8(DISPLAY_SOFTWARE, displaySetup());
+
+    a.on();
+    run(a, b, 20);
+    TEST_ASSERT_TRUE(ic.isHardwareBlink());
+}
+
+// ----------------------------------------------------------------------------
+// A steady LED on the chip would blink too, software takes over
+// ----------------------------------------------------------------------------
+static void test_steady_led_falls_back() {
+    HT16K33expander ic(0x70);
+    ic.begin();
+    BlinkHT16K33 a(ic, 0);
+    BlinkHT16K33 b(ic, 1);
+    run(a, b, 20);
+    TEST_ASSERT_TRUE(ic.isHardwareBlink());
+
+    ic.digitalWrite(40, HIGH);
+    TEST_ASSERT_FALSE(ic.isHardwareBlink());
+    ic.digitalWrite(40, LOW);
+    TEST_ASSERT_TRUE(ic.isHardwareBlink());
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_shared_rate_in_hardware);
+    RUN_TEST(test_intervals_through_base);
+    RUN_TEST(test_off_through_base);
+    RUN_TEST(test_steady_led_falls_back);
+    return UNITY_END();
+}
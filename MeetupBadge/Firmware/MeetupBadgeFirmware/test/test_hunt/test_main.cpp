@@ -0,0 +1,296 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the scavenger hunt tag verification
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#include "hmac.h"
+#include "hunt.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+// made with tools/hunt_tag.py 000102..1f 0x2A 04A1B2C3D4E5F6
+#define TAG_URL   "https://burbsec.com/hunt/2A/94B285D89D59B4A69B360E50F95627D1"
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static const uint8_t TAG_UID[7] = { 0x04, 0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6 };
+static uint8_t eventKey[HUNT_KEY_BYTES];
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// hex digits into bytes, returns the number of bytes
+static size_t fromHex(const char* hex, uint8_t* out) {
+    size_t n = 0;
+    for (; hex[0] && hex[1]; hex += 2) {
+        unsigned int b;
+        sscanf(hex, "%2x", &b);
+        out[n++] = b;
+    }
+    return n;
+}
+
+// a hunt with the event key, as after the console provisioned it
+static void provision(Hunt& h) {
+    TEST_ASSERT_TRUE(h.setKey(eventKey, sizeof(eventKey)));
+}
+
+static HuntVerdict check(Hunt& h, const uint8_t* uid, const char* url, uint8_t* checkpoint) {
+    return h.verify(uid, sizeof(TAG_UID), String(url), checkpoint);
+}
+
+void setUp() {
+    stubPreferences().clear();
+    for (uint8_t i = 0; i < HUNT_KEY_BYTES; i++) {
+        eventKey[i] = i;
+    }
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// RFC 4231 test cases 1 to 4, 6 and 7 (5 is a truncated mac)
+// ----------------------------------------------------------------------------
+static void test_rfc4231() {
+    struct Vector {
+        const char* key;
+        const char* data;
+        const char* mac;
+    };
+    static const Vector vectors[] = {
+        { "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b", "4869205468657265",
+          "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7" },
+        { "4a656665", "7768617420646f2079612077616e7420666f72206e6f7468696e673f",
+          "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843" },
+        { "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+          "dddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddd",
+          "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe" },
+        { "0102030405060708090a0b0c0d0e0f10111213141516171819",
+          "cdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcd",
+          "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b" },
+        { NULL, "54657374205573696e67204c6172676572205468616e20426c6f636b2d53697a65204b6579202d2048617368204b6579204669727374",
+          "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54" },
+        { NULL, "5468697320697320612074657374207573696e672061206c6172676572207468616e20626c6f636b2d73697a65206b657920616e642061206c6172676572207468616e20626c6f636b2d73697a6520646174612e20546865206b6579206e6565647320746f20626520686173686564206265666f7265206265696e6720757365642062792074686520484d414320616c676f726974686d2e",
+          "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2" },
+    };
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        uint8_t key[131];
+        uint8_t data[160];
+        uint8_t expected[SHA256_BYTES];
+        uint8_t mac[SHA256_BYTES];
+        size_t keyLen = sizeof(key);
+        memset(key, 0xAA, sizeof(key));              // 6 and 7: 131 bytes of 0xaa
+        if (vectors[i].key) {
+            keyLen = fromHex(vectors[i].key, key);
+        }
+        size_t len = fromHex(vectors[i].data, data);
+        fromHex(vectors[i].mac, expected);
+
+        hmacSha256Soft(key, keyLen, data, len, mac);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, mac, SHA256_BYTES);
+        hmacSha256(key, keyLen, data, len, mac);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, mac, SHA256_BYTES);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// A url from tools/hunt_tag.py is valid for its uid and checkpoint
+// ----------------------------------------------------------------------------
+static void test_tool_tag() {
+    Hunt h;
+    provision(h);
+    uint8_t checkpoint = 0;
+    TEST_ASSERT_EQUAL(HUNT_VALID, check(h, TAG_UID, TAG_URL, &checkpoint));
+    TEST_ASSERT_EQUAL_HEX8(0x2A, checkpoint);
+
+    // the phone may add a slash or a query
+    Hunt other;
+    provision(other);
+    TEST_ASSERT_EQUAL(HUNT_VALID, check(other, TAG_UID, TAG_URL "/", &checkpoint));
+    TEST_ASSERT_EQUAL(HUNT_VALID, check(other, TAG_UID, TAG_URL "?src=nfc", &checkpoint));
+    TEST_ASSERT_EQUAL(HUNT_VALID, check(other, TAG_UID,
+        "https://example.org/hunt/2a/94b285d89d59b4a69b360e50f95627d1", &checkpoint));
+}
+
+// ----------------------------------------------------------------------------
+// A wrong mac, a copied url and a changed checkpoint are forged, without a
+// key nothing is valid
+// ----------------------------------------------------------------------------
+static void test_forged() {
+    Hunt h;
+    uint8_t checkpoint = 0;
+    TEST_ASSERT_EQUAL(HUNT_NO_KEY, check(h, TAG_UID, TAG_URL, &checkpoint));
+    provision(h);
+
+    TEST_ASSERT_EQUAL(HUNT_FORGED, check(h, TAG_UID,
+        "https://burbsec.com/hunt/2A/94B285D89D59B4A69B360E50F95627D0", &checkpoint));
+    TEST_ASSERT_EQUAL_HEX8(0x2A, checkpoint);
+
+    uint8_t copy[7];
+    memcpy(copy, TAG_UID, sizeof(copy));
+    copy[6] ^= 0x01;
+    TEST_ASSERT_EQUAL(HUNT_FORGED, check(h, copy, TAG_URL, &checkpoint));
+
+    TEST_ASSERT_EQUAL(HUNT_FORGED, check(h, TAG_UID,
+        "https://burbsec.com/hunt/2B/94B285D89D59B4A69B360E50F95627D1", &checkpoint));
+    TEST_ASSERT_EQUAL_HEX8(0x2B, checkpoint);
+
+    // out of range, the mac isn't even computed
+    uint8_t mac[HUNT_MAC_BYTES] = { 0 };
+    TEST_ASSERT_EQUAL(HUNT_FORGED, h.verifyMac(TAG_UID, sizeof(TAG_UID), HUNT_CHECKPOINTS, mac));
+    TEST_ASSERT_EQUAL(HUNT_FORGED, h.verifyMac(TAG_UID, 8, 0x2A, mac));
+}
+
+// ----------------------------------------------------------------------------
+// Truncated and malformed urls aren't hunt urls
+// ----------------------------------------------------------------------------
+static void test_parse_url() {
+    uint8_t checkpoint = 0;
+    uint8_t mac[HUNT_MAC_BYTES];
+    TEST_ASSERT_TRUE(Hunt::parseUrl(TAG_URL, &checkpoint, mac));
+    uint8_t expected[HUNT_MAC_BYTES];
+    fromHex("94B285D89D59B4A69B360E50F95627D1", expected);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, mac, HUNT_MAC_BYTES);
+
+    static const char* const bad[] = {
+        "https://burbsec.com/hunt/2A/94B285D89D59B4A69B360E50F95627D",      // 31 digits
+        "https://burbsec.com/hunt/2A/94B285D89D59B4A69B360E50F95627",
+        "https://burbsec.com/hunt/2A/",
+        "https://burbsec.com/hunt/2A",
+        "https://burbsec.com/hunt/",
+        "https://burbsec.com/hunt/2A/94B285D89D59B4A69B360E50F95627D1F",    // 33 digits
+        "https://burbsec.com/hunt/2A/94B285D89D59B4A69B360E50F95627DX",
+        "https://burbsec.com/hunt/2A-94B285D89D59B4A69B360E50F95627D1",
+        "https://burbsec.com/hunt/G0/94B285D89D59B4A69B360E50F95627D1",
+        "https://burbsec.com/hunts/2A/94B285D89D59B4A69B360E50F95627D1",
+        "https://burbsec.com/",
+        "",
+    };
+    Hunt h;
+    provision(h);
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        TEST_ASSERT_FALSE_MESSAGE(Hunt::parseUrl(bad[i], &checkpoint, mac), bad[i]);
+        TEST_ASSERT_EQUAL_MESSAGE(HUNT_NONE, check(h, TAG_UID, bad[i], &checkpoint), bad[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// The cache answers for the same uid and payload only, and a new key
+// drops it
+// ----------------------------------------------------------------------------
+static void test_cached_verdict() {
+    Hunt h;
+    provision(h);
+    uint8_t checkpoint = 0;
+    uint8_t copy[7];
+    memcpy(copy, TAG_UID, sizeof(copy));
+    copy[0] ^= 0x80;
+
+    TEST_ASSERT_EQUAL(HUNT_VALID, check(h, TAG_UID, TAG_URL, &checkpoint));
+    TEST_ASSERT_EQUAL(HUNT_VALID, check(h, TAG_UID, TAG_URL, &checkpoint));
+    TEST_ASSERT_EQUAL(HUNT_FORGED, check(h, copy, TAG_URL, &checkpoint));
+    TEST_ASSERT_EQUAL(HUNT_FORGED, check(h, copy, TAG_URL, &checkpoint));
+    TEST_ASSERT_EQUAL(HUNT_FORGED, check(h, TAG_UID,
+        "https://burbsec.com/hunt/2A/94B285D89D59B4A69B360E50F95627D2", &checkpoint));
+    TEST_ASSERT_EQUAL(HUNT_VALID, check(h, TAG_UID, TAG_URL, &checkpoint));
+
+    // more tags than the cache holds, the verdicts stay right
+    for (uint8_t i = 0; i < 3 * HUNT_CACHE; i++) {
+        copy[1] = i;
+        TEST_ASSERT_EQUAL(HUNT_FORGED, check(h, copy, TAG_URL, &checkpoint));
+        TEST_ASSERT_EQUAL(HUNT_VALID, check(h, TAG_UID, TAG_URL, &checkpoint));
+    }
+
+    // the cached valid verdict doesn't outlive the key
+    eventKey[0] ^= 0xFF;
+    provision(h);
+    TEST_ASSERT_EQUAL(HUNT_FORGED, check(h, TAG_UID, TAG_URL, &checkpoint));
+    eventKey[0] ^= 0xFF;
+    provision(h);
+    TEST_ASSERT_EQUAL(HUNT_VALID, check(h, TAG_UID, TAG_URL, &checkpoint));
+}
+
+// ----------------------------------------------------------------------------
+// Progress counts each checkpoint once, survives a reboot and ignores ids
+// out of range
+// ----------------------------------------------------------------------------
+static void test_mark_found() {
+    Hunt h;
+    h.begin();
+    TEST_ASSERT_EQUAL_UINT8(0, h.foundCount());
+    TEST_ASSERT_TRUE(h.markFound(0x2A));
+    TEST_ASSERT_FALSE(h.markFound(0x2A));
+    TEST_ASSERT_TRUE(h.markFound(HUNT_CHECKPOINTS - 1));
+    TEST_ASSERT_FALSE(h.markFound(HUNT_CHECKPOINTS));
+    TEST_ASSERT_FALSE(h.markFound(0xFF));
+    TEST_ASSERT_EQUAL_UINT8(2, h.foundCount());
+
+    Hunt rebooted;
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT8(2, rebooted.foundCount());
+    TEST_ASSERT_FALSE(rebooted.markFound(0x2A));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rfc4231);
+    RUN_TEST(test_tool_tag);
+    RUN_TEST(test_forged);
+    RUN_TEST(test_parse_url);
+    RUN_TEST(test_cached_verdict);
+    RUN_TEST(test_mark_found);
+    return UNITY_END();
+}
@@ -0,0 +1,228 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the ramps in native output resolution
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+#include <vector>
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// An output of 8 + extra bits that keeps every level written and when
+// ----------------------------------------------------------------------------
+template<uint8_t extra>
+class LevelPin {
+  public:
+    std::vector<uint16_t> levels;
+    std::vector<uint32_t> times;
+
+    void begin() {}
+    void digWrite(uint8_t val) { pwmWrite(val ? 255 : 0); }
+    void pwmWrite(uint16_t level) {
+        levels.push_back(level);
+        times.push_back(millis());
+    }
+    void setOnColor(uint32_t) {}
+    void setOffColor(uint32_t) {}
+};
+
+template<>
+struct OutputTraits<LevelPin<4>> : OutputTraitsBase<LevelPin<4>> {
+    static constexpr uint8_t extraBits = 4;       // 12 bit like a PCA9685
+};
+
+template<>
+struct OutputTraits<LevelPin<5>> : OutputTraitsBase<LevelPin<5>> {
+    static constexpr uint8_t extraBits = 5;       // 13 bit like the LEDC default
+};
+
+// ----------------------------------------------------------------------------
+// One ramp of an effect: the writes up to the first turn
+// ----------------------------------------------------------------------------
+struct Ramp {
+    uint32_t writes;
+    uint32_t largestStep;             // biggest change between two writes
+    bool increasing;                  // every write above the one before
+    uint16_t top;
+    uint32_t duration;                // ms from on() to the top
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+template<class Pin>
+static Ramp rampOf(const Pin& pin) {
+    Ramp ramp = { 0, 0, true, 0, 0 };
+    for (size_t i = 0; i < pin.levels.size(); i++) {
+        if (i > 0 && pin.levels[i] < pin.levels[i - 1]) {
+            break;                                   // turned downwards
+        }
+        if (i > 0 && pin.levels[i] == pin.levels[i - 1]) {
+            ramp.increasing = false;
+        }
+        if (i > 0 && (uint32_t) (pin.levels[i] - pin.levels[i - 1]) > ramp.largestStep) {
+            ramp.largestStep = pin.levels[i] - pin.levels[i - 1];
+        }
+        ramp.writes++;
+        ramp.top = pin.levels[i];
+        ramp.duration = pin.times[i];
+    }
+    return ramp;
+}
+
+// switches the effect on and runs update() every ms up to the time given
+template<class Effect>
+static void run(Effect& effect, uint32_t until) {
+    effect.on();
+    while (millis() < until) {
+        stubAdvance(1);
+        effect.update();
+    }
+}
+
+template<uint8_t extra>
+static Ramp smoothRamp(bool gamma) {
+    stubMillis() = 0;
+    LevelPin<extra> pin;
+    Smooth<LevelPin<extra>> smooth(pin);
+    smooth.setGamma(gamma);
+    run(smooth, 8000);
+    return rampOf(pin);
+}
+
+template<uint8_t extra>
+static Ramp heartbeatRamp() {
+    stubMillis() = 0;
+    LevelPin<extra> pin;
+    Heartbeat<LevelPin<extra>> beat(pin);
+    run(beat, 10000);
+    Ramp ramp = rampOf(pin);
+    ramp.increasing = ramp.increasing && ramp.writes < pin.levels.size();   // and it turned
+    return ramp;
+}
+
+void setUp() {
+    stubMillis() = 0;
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// Smooth goes up level by level in 12 and 13 bit, in the time it takes in
+// 8 bit
+// ----------------------------------------------------------------------------
+static void test_smooth() {
+    Ramp base = smoothRamp<0>(false);
+    TEST_ASSERT_TRUE(base.increasing);
+    TEST_ASSERT_EQUAL_UINT16(255, base.top);
+
+    Ramp r12 = smoothRamp<4>(false);
+    Ramp r13 = smoothRamp<5>(false);
+    TEST_ASSERT_TRUE(r12.increasing);
+    TEST_ASSERT_TRUE(r13.increasing);
+    TEST_ASSERT_EQUAL_UINT16(4095, r12.top);
+    TEST_ASSERT_EQUAL_UINT16(8191, r13.top);
+
+    // an update every ms sees each level, not steps of 16 or 32
+    TEST_ASSERT_GREATER_THAN_UINT32(2048, r12.writes);
+    TEST_ASSERT_GREATER_THAN_UINT32(4096, r13.writes);
+    TEST_ASSERT_TRUE(r12.largestStep <= 2);
+    TEST_ASSERT_TRUE(r13.largestStep <= 2);
+
+    // one 8 bit step is 26 ms
+    TEST_ASSERT_UINT32_WITHIN(26, base.duration, r12.duration);
+    TEST_ASSERT_UINT32_WITHIN(26, base.duration, r13.duration);
+}
+
+// ----------------------------------------------------------------------------
+// Gamma corrected levels repeat at the dark end of the table but never go
+// back, they end at the top of the range
+// ----------------------------------------------------------------------------
+static void test_smooth_gamma() {
+    Ramp r12 = smoothRamp<4>(true);
+    Ramp r13 = smoothRamp<5>(true);
+    TEST_ASSERT_EQUAL_UINT16(4095, r12.top);
+    TEST_ASSERT_EQUAL_UINT16(8191, r13.top);
+}
+
+// ----------------------------------------------------------------------------
+// Heartbeat climbs two levels per step up to the turn, in the 8 bit time
+// ----------------------------------------------------------------------------
+static void test_heartbeat() {
+    Ramp base = heartbeatRamp<0>();
+    Ramp r12 = heartbeatRamp<4>();
+    Ramp r13 = heartbeatRamp<5>();
+    TEST_ASSERT_TRUE(base.increasing);
+    TEST_ASSERT_TRUE(r12.increasing);
+    TEST_ASSERT_TRUE(r13.increasing);
+    TEST_ASSERT_TRUE(r12.top >= 4094 - 1);
+    TEST_ASSERT_TRUE(r13.top >= 8190 - 1);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(1024, r12.writes);
+    TEST_ASSERT_GREATER_THAN_UINT32(2048, r13.writes);
+    TEST_ASSERT_TRUE(r12.largestStep <= 4);
+    TEST_ASSERT_TRUE(r13.largestStep <= 4);
+
+    TEST_ASSERT_UINT32_WITHIN(26, base.duration, r12.duration);
+    TEST_ASSERT_UINT32_WITHIN(26, base.duration, r13.duration);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_smooth);
+    RUN_TEST(test_smooth_gamma);
+    RUN_TEST(test_heartbeat);
+    return UNITY_END();
+}
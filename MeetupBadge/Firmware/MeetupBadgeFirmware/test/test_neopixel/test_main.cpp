@@ -0,0 +1,136 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the color shadow of NeoPixel and NeoPixelGroup
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+#include <utility/Noiasca_neopixel.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define RED   0xFF0000
+#define GREEN 0x00FF00
+#define BLUE  0x0000FF
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// A pixel that was never written reads LOW, whatever off color it is given
+// ----------------------------------------------------------------------------
+static void test_off_color_before_write() {
+    Adafruit_NeoPixel strip(4);
+    NeoPixel pixel(strip, 1);
+    TEST_ASSERT_EQUAL(LOW, pixel.digRead());
+    pixel.setOffColor(BLUE);
+    TEST_ASSERT_EQUAL(LOW, pixel.digRead());
+    pixel.setOffColor(0);
+    TEST_ASSERT_EQUAL(LOW, pixel.digRead());
+    TEST_ASSERT_EQUAL_UINT32(0, strip.sets);
+
+    pixel.digWrite(LOW);
+    TEST_ASSERT_EQUAL(LOW, pixel.digRead());
+    TEST_ASSERT_EQUAL_HEX32(0, strip.getPixelColor(1));
+}
+
+// ----------------------------------------------------------------------------
+// Once written, a new off color moves the level with the color shown
+// ----------------------------------------------------------------------------
+static void test_off_color_after_write() {
+    Adafruit_NeoPixel strip(4);
+    NeoPixel pixel(strip, 1);
+    pixel.setOnColor(RED);
+    pixel.digWrite(HIGH);
+    TEST_ASSERT_EQUAL(HIGH, pixel.digRead());
+    pixel.setOffColor(RED);
+    TEST_ASSERT_EQUAL(LOW, pixel.digRead());
+    pixel.setOffColor(GREEN);
+    TEST_ASSERT_EQUAL(HIGH, pixel.digRead());
+
+    pixel.digWrite(LOW);
+    TEST_ASSERT_EQUAL(LOW, pixel.digRead());
+    TEST_ASSERT_EQUAL_HEX32(GREEN, strip.getPixelColor(1));
+}
+
+// ----------------------------------------------------------------------------
+// The shadow skips writes of the color already shown
+// ----------------------------------------------------------------------------
+static void test_same_color_skipped() {
+    Adafruit_NeoPixel strip(4);
+    NeoPixel pixel(strip, 2);
+    pixel.digWrite(HIGH);
+    pixel.digWrite(HIGH);
+    TEST_ASSERT_EQUAL_UINT32(1, strip.sets);
+    TEST_ASSERT_EQUAL_UINT32(1, strip.shows);
+    pixel.digWrite(LOW);
+    pixel.digWrite(LOW);
+    TEST_ASSERT_EQUAL_UINT32(2, strip.sets);
+
+    NeoPixelGroup<3> group(strip, 0, 1, 3);
+    group.digWrite(1, HIGH);
+    group.digWrite(1, HIGH);
+    TEST_ASSERT_EQUAL_UINT32(3, strip.sets);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_off_color_before_write);
+    RUN_TEST(test_off_color_after_write);
+    RUN_TEST(test_same_color_skipped);
+    return UNITY_END();
+}
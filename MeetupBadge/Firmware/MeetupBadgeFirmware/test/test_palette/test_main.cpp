@@ -0,0 +1,179 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the palette indexed frame and its pixels
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+#include <utility/Noiasca_neopixel.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define ORANGE 0xFF8040
+#define BLUE   0x0000FF
+
+// ============================================================================
+// TYPES
+// ============================================================================
+typedef NeoPaletteStrip<4, 10> Frame;
+typedef NeoPalettePixel<Frame> Pixel;
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+void setUp() {
+    stubMillis() = 0;
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// Two pixels share a byte, a show() expands the dirty pixels only
+// ----------------------------------------------------------------------------
+static void test_index_frame() {
+    Adafruit_NeoPixel strip(10);
+    Frame frame(strip);
+    frame.setPaletteColor(1, ORANGE);
+    frame.setPaletteColor(2, BLUE);
+    frame.show();
+    TEST_ASSERT_EQUAL_UINT32(10, strip.sets);
+
+    frame.setPixel(4, 1);
+    frame.setPixel(5, 2);
+    TEST_ASSERT_EQUAL_UINT8(1, frame.getPixel(4));
+    TEST_ASSERT_EQUAL_UINT8(2, frame.getPixel(5));
+    frame.show();
+    TEST_ASSERT_EQUAL_UINT32(12, strip.sets);
+    TEST_ASSERT_EQUAL_UINT32(2, strip.shows);
+    TEST_ASSERT_EQUAL_HEX32(ORANGE, strip.getPixelColor(4));
+    TEST_ASSERT_EQUAL_HEX32(BLUE, strip.getPixelColor(5));
+
+    frame.setPixel(4, 1);
+    frame.show();
+    TEST_ASSERT_EQUAL_UINT32(2, strip.shows);
+}
+
+// ----------------------------------------------------------------------------
+// pwmWrite scales the on entry by the level, there is no step at 50 %
+// ----------------------------------------------------------------------------
+static void test_pwm_scales_entry() {
+    Adafruit_NeoPixel strip(10);
+    Frame frame(strip);
+    frame.setPaletteColor(1, ORANGE);
+    Pixel pixel(frame, 3);
+
+    pixel.pwmWrite(128);
+    frame.show();
+    TEST_ASSERT_EQUAL_HEX32(0x804020, strip.getPixelColor(3));
+    pixel.pwmWrite(64);
+    frame.show();
+    TEST_ASSERT_EQUAL_HEX32(0x402010, strip.getPixelColor(3));
+
+    uint8_t previous = 0;
+    for (int pwm = 1; pwm < 255; pwm++) {
+        pixel.pwmWrite(pwm);
+        frame.show();
+        uint8_t red = strip.getPixelColor(3) >> 16;
+        TEST_ASSERT_EQUAL_UINT8(pwm, red);
+        TEST_ASSERT_TRUE(red > previous);
+        previous = red;
+    }
+
+    // full on and off bring back the palette
+    pixel.pwmWrite(255);
+    frame.show();
+    TEST_ASSERT_EQUAL_HEX32(ORANGE, frame.getPaletteColor(1));
+    TEST_ASSERT_EQUAL_HEX32(ORANGE, strip.getPixelColor(3));
+    pixel.pwmWrite(0);
+    frame.show();
+    TEST_ASSERT_EQUAL_HEX32(0, strip.getPixelColor(3));
+    TEST_ASSERT_EQUAL(LOW, pixel.digRead());
+
+    pixel.pwmWrite(10);
+    pixel.digWrite(HIGH);
+    frame.show();
+    TEST_ASSERT_EQUAL_HEX32(ORANGE, strip.getPixelColor(3));
+}
+
+// ----------------------------------------------------------------------------
+// A Smooth effect on a palette pixel ramps through the levels
+// ----------------------------------------------------------------------------
+static void test_smooth_ramp() {
+    Adafruit_NeoPixel strip(10);
+    Frame frame(strip);
+    frame.setPaletteColor(1, ORANGE);
+    Pixel pixel(frame, 0);
+    Smooth<Pixel> smooth(pixel);
+    smooth.on();
+
+    uint8_t previous = 0;
+    uint16_t levels = 0;
+    for (uint32_t ms = 0; ms < 10000; ms += 5) {
+        stubAdvance(5);
+        smooth.update();
+        frame.show();
+        uint8_t red = strip.getPixelColor(0) >> 16;
+        TEST_ASSERT_TRUE(red >= previous);
+        levels += red != previous;
+        previous = red;
+    }
+    TEST_ASSERT_EQUAL_UINT8(0xFF, previous);
+    TEST_ASSERT_GREATER_THAN_UINT32(100, levels);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_index_frame);
+    RUN_TEST(test_pwm_scales_entry);
+    RUN_TEST(test_smooth_ramp);
+    return UNITY_END();
+}
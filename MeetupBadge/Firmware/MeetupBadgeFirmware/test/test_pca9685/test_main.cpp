@@ -0,0 +1,184 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the PCA9685 register writes
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_PWMServoDriver.h>
+#include <Noiasca_led.h>
+#include <utility/Noiasca_PCA9685.h>
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// the transmission setPWM() makes for a register block
+static std::string block(uint8_t reg, uint16_t on, uint16_t off) {
+    std::string frame;
+    frame += (char) reg;
+    frame += (char) (on & 0xFF);
+    frame += (char) (on >> 8);
+    frame += (char) (off & 0xFF);
+    frame += (char) (off >> 8);
+    return frame;
+}
+
+static std::string channel(uint8_t n, uint16_t on, uint16_t off) {
+    return block(PCA9685_LED0_ON_L + 4 * n, on, off);
+}
+
+static void assertSent(size_t i, const std::string& expected) {
+    TEST_ASSERT_TRUE(i < Wire.sent.size());
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), Wire.sent[i].size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), Wire.sent[i].data(), expected.size());
+}
+
+void setUp() {
+    Wire.sent.clear();
+    PCA9685::setPhaseStagger(0);
+}
+
+void tearDown() {
+    PCA9685::setPhaseStagger(0);
+}
+
+// ----------------------------------------------------------------------------
+// A group of all 16 channels switches with one write to ALL_LED (0xFA)
+// ----------------------------------------------------------------------------
+static void test_all_led() {
+    Adafruit_PWMServoDriver pwm;
+    const uint16_t all[16] = { 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+    PCA9685Group<16> group(pwm, all);
+
+    group.digWrite(HIGH);
+    TEST_ASSERT_EQUAL_UINT32(1, Wire.sent.size());
+    assertSent(0, block(PCA9685_ALLLED_ON_L, 4096, 0));
+    group.digWrite(LOW);
+    assertSent(1, block(PCA9685_ALLLED_ON_L, 0, 4096));
+    group.pwmWrite(128);
+    TEST_ASSERT_EQUAL_UINT32(3, Wire.sent.size());
+    assertSent(2, block(PCA9685_ALLLED_ON_L, 0, 2048));
+
+    Wire.sent.clear();
+    PCA9685::allWrite(pwm, HIGH);
+    assertSent(0, block(PCA9685_ALLLED_ON_L, 4096, 0));
+}
+
+// ----------------------------------------------------------------------------
+// A group short of one channel writes each channel
+// ----------------------------------------------------------------------------
+static void test_partial_group() {
+    Adafruit_PWMServoDriver pwm;
+    uint16_t channels[16];
+    for (uint8_t i = 0; i < 16; i++) {
+        channels[i] = i;
+    }
+    channels[15] = 14;                           // 14 twice, 15 missing
+    PCA9685Group<16> group(pwm, channels);
+    group.digWrite(HIGH);
+    TEST_ASSERT_EQUAL_UINT32(16, Wire.sent.size());
+    assertSent(0, channel(0, 4096, 0));
+    assertSent(15, channel(14, 4096, 0));
+
+    Wire.sent.clear();
+    PCA9685Group<3> three(pwm, 2, 7, 9);
+    three.pwmWrite(16);
+    TEST_ASSERT_EQUAL_UINT32(3, Wire.sent.size());
+    assertSent(0, channel(2, 0, 256));
+    assertSent(1, channel(7, 0, 256));
+    assertSent(2, channel(9, 0, 256));
+}
+
+// ----------------------------------------------------------------------------
+// With a phase stagger channel n switches on at n * step, the OFF time
+// wraps around the cycle, ALL_LED is no longer used for a duty
+// ----------------------------------------------------------------------------
+static void test_phase_offsets() {
+    Adafruit_PWMServoDriver pwm;
+    PCA9685::setPhaseStagger(256);
+
+    PCA9685 three(pwm, 3);
+    three.levelWrite(1000);
+    assertSent(0, channel(3, 768, 1768));
+    PCA9685 last(pwm, 15);
+    last.levelWrite(1000);
+    assertSent(1, channel(15, 3840, (3840 + 1000) & 0x0FFF));
+    last.levelWrite(0);
+    assertSent(2, channel(15, 0, 4096));
+    three.pwmWrite(255);
+    assertSent(3, channel(3, 768, (768 + 4080) & 0x0FFF));
+
+    Wire.sent.clear();
+    TEST_ASSERT_FALSE(PCA9685::allPwmWrite(pwm, 128));
+    TEST_ASSERT_EQUAL_UINT32(0, Wire.sent.size());
+
+    const uint16_t all[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    PCA9685Group<16> group(pwm, all);
+    group.pwmWrite(128);
+    TEST_ASSERT_EQUAL_UINT32(16, Wire.sent.size());
+    for (uint8_t n = 0; n < 16; n++) {
+        uint16_t on = n * 256;
+        assertSent(n, channel(n, on, (on + 2048) & 0x0FFF));
+    }
+
+    // on and off stay one write
+    Wire.sent.clear();
+    group.digWrite(LOW);
+    TEST_ASSERT_EQUAL_UINT32(1, Wire.sent.size());
+    assertSent(0, block(PCA9685_ALLLED_ON_L, 0, 4096));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_all_led);
+    RUN_TEST(test_partial_group);
+    RUN_TEST(test_phase_offsets);
+    return UNITY_END();
+}
@@ -0,0 +1,141 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the PCF8574 inputs read on the INT line
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Noiasca_led.h>
+#include <utility/Noiasca_PCF8574.h>
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static uint8_t changes;
+static uint8_t lastPin;
+static uint8_t lastValue;
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+static void onInput(uint8_t pin, uint8_t value) {
+    changes++;
+    lastPin = pin;
+    lastValue = value;
+}
+
+void setUp() {
+    Wire.sent.clear();
+    Wire.reply.clear();
+    Wire.requests = 0;
+    changes = 0;
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// Outputs on a chip with inputs don't cause reads, only the INT line does
+// ----------------------------------------------------------------------------
+static void test_writes_dont_read() {
+    PCF8574expander pcf(0x20);
+    pcf.setOnInputChange(onInput);
+    pcf.pinMode(7, INPUT);
+    Wire.reply = std::string(1, (char) 0xFF);
+    pcf.updateInputs();
+    TEST_ASSERT_EQUAL_UINT32(1, Wire.requests);
+    TEST_ASSERT_EQUAL(HIGH, pcf.digitalRead(7));
+    TEST_ASSERT_EQUAL(1, changes);                 // the first read reports the pullup
+    changes = 0;
+
+    for (uint8_t i = 0; i < 100; i++) {
+        pcf.digitalWrite(0, i & 1);
+        TEST_ASSERT_EQUAL_UINT8(0, pcf.updateInputs());
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, Wire.requests);
+    TEST_ASSERT_EQUAL_HEX8(0x81, (uint8_t) Wire.sent.back()[0]);    // the input stays HIGH
+
+    Wire.reply = std::string(1, (char) 0x7F);
+    pcf.inputInterrupt();
+    TEST_ASSERT_EQUAL_HEX8(0x80, pcf.updateInputs());
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.requests);
+    TEST_ASSERT_EQUAL(1, changes);
+    TEST_ASSERT_EQUAL(7, lastPin);
+    TEST_ASSERT_EQUAL(LOW, lastValue);
+    TEST_ASSERT_EQUAL(LOW, pcf.digitalRead(7));
+}
+
+// ----------------------------------------------------------------------------
+// A new input is read once, a forced update reads without INT
+// ----------------------------------------------------------------------------
+static void test_new_input_and_force() {
+    PCF8574expander pcf(0x20);
+    pcf.digitalWrite(1, HIGH);
+    TEST_ASSERT_EQUAL_UINT8(0, pcf.updateInputs());
+    TEST_ASSERT_EQUAL_UINT32(0, Wire.requests);
+
+    pcf.pinMode(4, INPUT);
+    Wire.reply = std::string(1, (char) 0x12);
+    TEST_ASSERT_EQUAL_HEX8(0x10, pcf.updateInputs());
+    TEST_ASSERT_EQUAL_UINT32(1, Wire.requests);
+    TEST_ASSERT_EQUAL_UINT8(0, pcf.updateInputs());
+    TEST_ASSERT_EQUAL_UINT32(1, Wire.requests);
+
+    Wire.reply = std::string(1, (char) 0x02);
+    TEST_ASSERT_EQUAL_HEX8(0x10, pcf.updateInputs(true));
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.requests);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_writes_dont_read);
+    RUN_TEST(test_new_input_and_force);
+    return UNITY_END();
+}
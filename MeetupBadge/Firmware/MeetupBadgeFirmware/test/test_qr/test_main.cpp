@@ -0,0 +1,408 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the QR encoder, every symbol is read back by an independent decoder
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <string.h>
+#include <string>
+
+#include "qr.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define OLED_WIDTH  128
+#define OLED_HEIGHT 64
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// Block structure of ISO 18004 table 9, kept apart from the encoder's own
+struct Layout {
+    uint8_t blocks;
+    uint8_t dataPerBlock;
+    uint8_t eccPerBlock;
+};
+
+// [version - 1][0 = M, 1 = L]
+static const Layout layouts[QR_MAX_VERSION][2] = {
+    { { 1, 16, 10 }, { 1,  19,  7 } },
+    { { 1, 28, 16 }, { 1,  34, 10 } },
+    { { 1, 44, 26 }, { 1,  55, 15 } },
+    { { 2, 32, 18 }, { 1,  80, 20 } },
+    { { 2, 43, 24 }, { 1, 108, 26 } },
+    { { 4, 27, 16 }, { 2,  68, 18 } },
+};
+
+// byte mode capacity per version, the same order
+static const uint8_t capacity[QR_MAX_VERSION][2] = {
+    { 14, 17 }, { 26, 32 }, { 42, 53 }, { 62, 78 }, { 84, 106 }, { 106, 134 },
+};
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static uint8_t gfExp[512];
+static uint8_t gfLog[256];
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+static uint8_t gfMul(uint8_t a, uint8_t b) {
+    return a && b ? gfExp[gfLog[a] + gfLog[b]] : 0;
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : formatBits
+// DESCRIPTION : 15 bit format info, BCH(15,5) with 0x537 and the 0x5412 mask
+// ----------------------------------------------------------------------------
+static uint16_t formatBits(uint8_t ecc, uint8_t mask) {
+    uint16_t data = (ecc == QR_ECC_L ? 1 : 0) << 3 | mask;
+    uint16_t rem = data << 10;
+    for (int8_t i = 14; i >= 10; i--) {
+        if (rem & (1 << i)) {
+            rem ^= 0x537 << (i - 10);
+        }
+    }
+    return ((data << 10) | rem) ^ 0x5412;
+}
+
+static bool maskBit(uint8_t mask, int x, int y) {
+    switch (mask) {
+        case 0: return (x + y) % 2 == 0;
+        case 1: return y % 2 == 0;
+        case 2: return x % 3 == 0;
+        case 3: return (x + y) % 3 == 0;
+        case 4: return (x / 3 + y / 2) % 2 == 0;
+        case 5: return x * y % 2 + x * y % 3 == 0;
+        case 6: return (x * y % 2 + x * y % 3) % 2 == 0;
+        default: return ((x + y) % 2 + x * y % 3) % 2 == 0;
+    }
+}
+
+// finders with separators and format areas, timing, the one alignment
+// pattern of versions 2 to 6
+static bool isFunction(uint8_t version, int x, int y) {
+    int size = 17 + 4 * version;
+    int align = version > 1 ? 4 * version + 10 : 0;
+    return (x <= 8 && y <= 8) || (x >= size - 8 && y <= 8) || (x <= 8 && y >= size - 8)
+        || x == 6 || y == 6
+        || (align && x >= align - 2 && x <= align + 2 && y >= align - 2 && y <= align + 2);
+}
+
+static void assertFinder(const QrCode& qr, int cx, int cy) {
+    for (int dy = -4; dy <= 4; dy++) {
+        for (int dx = -4; dx <= 4; dx++) {
+            int x = cx + dx, y = cy + dy;
+            if (x < 0 || y < 0 || x >= qr.getSize() || y >= qr.getSize()) {
+                continue;
+            }
+            int ring = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+            TEST_ASSERT_EQUAL_MESSAGE(ring != 2 && ring != 4, qr.getModule(x, y), "finder");
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// NAME        : decode
+// DESCRIPTION : Read a symbol back like a scanner would after locating it:
+//               format info, unmask, zigzag, deinterleave, RS syndromes,
+//               byte mode segment and padding. Fails the test on anything
+//               a decoder would reject.
+// ----------------------------------------------------------------------------
+static std::string decode(const QrCode& qr, uint8_t* eccOut = nullptr) {
+    uint8_t version = qr.getVersion();
+    int size = qr.getSize();
+    TEST_ASSERT_TRUE(version >= 1 && version <= QR_MAX_VERSION);
+    TEST_ASSERT_EQUAL(17 + 4 * version, size);
+
+    assertFinder(qr, 3, 3);
+    assertFinder(qr, size - 4, 3);
+    assertFinder(qr, 3, size - 4);
+    for (int i = 8; i < size - 8; i++) {
+        TEST_ASSERT_EQUAL_MESSAGE(i % 2 == 0, qr.getModule(i, 6), "timing");
+        TEST_ASSERT_EQUAL_MESSAGE(i % 2 == 0, qr.getModule(6, i), "timing");
+    }
+    TEST_ASSERT_TRUE_MESSAGE(qr.getModule(8, size - 8), "dark module");
+
+    // both copies of the format info
+    uint16_t first = 0, second = 0;
+    for (int i = 0; i <= 5; i++) first |= qr.getModule(8, i) << i;
+    first |= qr.getModule(8, 7) << 6 | qr.getModule(8, 8) << 7 | qr.getModule(7, 8) << 8;
+    for (int i = 9; i < 15; i++) first |= qr.getModule(14 - i, 8) << i;
+    for (int i = 0; i < 8; i++) second |= qr.getModule(size - 1 - i, 8) << i;
+    for (int i = 8; i < 15; i++) second |= qr.getModule(8, size - 15 + i) << i;
+    TEST_ASSERT_EQUAL_HEX16(first, second);
+    int ecc = -1, mask = -1;
+    for (uint8_t e = 0; e < 2; e++) {
+        for (uint8_t m = 0; m < 8; m++) {
+            if (formatBits(e ? QR_ECC_L : QR_ECC_M, m) == first) {
+                ecc = e;
+                mask = m;
+            }
+        }
+    }
+    TEST_ASSERT_TRUE_MESSAGE(ecc >= 0, "format info");
+    if (eccOut) {
+        *eccOut = ecc ? QR_ECC_L : QR_ECC_M;
+    }
+
+    // codewords in the zigzag order, unmasked
+    const Layout& layout = layouts[version - 1][ecc];
+    int total = layout.blocks * (layout.dataPerBlock + layout.eccPerBlock);
+    uint8_t raw[QR_MAX_CODEWORDS] = { 0 };
+    int bit = 0;
+    int remainder = 0;
+    for (int right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) {
+            right = 5;
+        }
+        bool upward = ((right + 1) & 2) == 0;
+        for (int vert = 0; vert < size; vert++) {
+            int y = upward ? size - 1 - vert : vert;
+            for (int j = 0; j < 2; j++) {
+                int x = right - j;
+                if (isFunction(version, x, y)) {
+                    continue;
+                }
+                bool dark = qr.getModule(x, y) ^ maskBit(mask, x, y);
+                if (bit < total * 8) {
+                    raw[bit >> 3] |= dark << (7 - (bit & 7));
+                    bit++;
+                } else {
+                    TEST_ASSERT_FALSE_MESSAGE(dark, "remainder bit");
+                    remainder++;
+                }
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(total * 8, bit);
+    TEST_ASSERT_EQUAL(version > 1 ? 7 : 0, remainder);
+
+    // deinterleave and check every block's syndromes
+    uint8_t stream[QR_MAX_CODEWORDS];
+    int dataLen = layout.blocks * layout.dataPerBlock;
+    for (int b = 0; b < layout.blocks; b++) {
+        uint8_t block[QR_MAX_CODEWORDS];
+        int n = 0;
+        for (int i = 0; i < layout.dataPerBlock; i++) {
+            block[n++] = stream[b * layout.dataPerBlock + i] = raw[i * layout.blocks + b];
+        }
+        for (int i = 0; i < layout.eccPerBlock; i++) {
+            block[n++] = raw[dataLen + i * layout.blocks + b];
+        }
+        for (int s = 0; s < layout.eccPerBlock; s++) {
+            uint8_t syndrome = 0;
+            for (int i = 0; i < n; i++) {
+                syndrome = gfMul(syndrome, gfExp[s]) ^ block[i];
+            }
+            TEST_ASSERT_EQUAL_HEX8_MESSAGE(0, syndrome, "syndrome");
+        }
+    }
+
+    // one byte mode segment, terminator, pad codewords
+    bit = 0;
+    auto get = [&](int n) {
+        int value = 0;
+        while (n--) {
+            value = value << 1 | ((stream[bit >> 3] >> (7 - (bit & 7))) & 1);
+            bit++;
+        }
+        return value;
+    };
+    TEST_ASSERT_EQUAL_HEX8(0x4, get(4));
+    int len = get(8);
+    TEST_ASSERT_TRUE(4 + 8 + 8 * len <= dataLen * 8);
+    std::string text;
+    for (int i = 0; i < len; i++) {
+        text += (char) get(8);
+    }
+    while (bit < dataLen * 8 && (bit & 7)) {
+        TEST_ASSERT_EQUAL(0, get(1));
+    }
+    for (uint8_t pad = 0xEC; bit < dataLen * 8; pad ^= 0xEC ^ 0x11) {
+        TEST_ASSERT_EQUAL_HEX8(pad, get(8));
+    }
+    return text;
+}
+
+static std::string makeText(size_t len, uint32_t seed) {
+    static const char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789/:._-";
+    std::string s;
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        s += chars[(seed >> 16) % (sizeof(chars) - 1)];
+    }
+    return s;
+}
+
+void setUp() {
+    uint16_t x = 1;
+    for (int i = 0; i < 255; i++) {
+        gfExp[i] = gfExp[i + 255] = x;
+        gfLog[x] = i;
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x11D;
+        }
+    }
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// The smallest version that holds the text is used, at both levels, and
+// every length up to the limit reads back
+// ----------------------------------------------------------------------------
+static void test_every_length() {
+    for (uint8_t e = 0; e < 2; e++) {
+        uint8_t ecc = e ? QR_ECC_L : QR_ECC_M;
+        uint8_t version = 1;
+        for (size_t len = 0; len <= capacity[QR_MAX_VERSION - 1][e]; len++) {
+            while (len > capacity[version - 1][e]) {
+                version++;
+            }
+            std::string text = makeText(len, len * 7 + e);
+            TEST_ASSERT_TRUE(qrCode.encode((const uint8_t*) text.data(), text.size(), ecc));
+            TEST_ASSERT_EQUAL(version, qrCode.getVersion());
+            uint8_t decodedEcc;
+            TEST_ASSERT_EQUAL_STRING(text.c_str(), decode(qrCode, &decodedEcc).c_str());
+            TEST_ASSERT_EQUAL(ecc, decodedEcc);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Too long for version 6 is refused and leaves nothing to draw
+// ----------------------------------------------------------------------------
+static void test_too_long() {
+    std::string text = makeText(capacity[QR_MAX_VERSION - 1][1] + 1, 3);
+    TEST_ASSERT_FALSE(qrCode.encode((const uint8_t*) text.data(), text.size(), QR_ECC_L));
+    TEST_ASSERT_EQUAL(0, qrCode.getVersion());
+    uint8_t buffer[OLED_WIDTH * OLED_HEIGHT / 8] = { 0 };
+    TEST_ASSERT_EQUAL(0, qrCode.render(buffer, OLED_WIDTH, OLED_HEIGHT));
+
+    text.resize(capacity[QR_MAX_VERSION - 1][0] + 1);
+    TEST_ASSERT_FALSE(qrCode.encode((const uint8_t*) text.data(), text.size(), QR_ECC_M));
+}
+
+// ----------------------------------------------------------------------------
+// All bytes, not just text, and the urls the badge shows
+// ----------------------------------------------------------------------------
+static void test_binary_and_urls() {
+    uint8_t bytes[100];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = i * 37 + 11;
+    }
+    TEST_ASSERT_TRUE(qrCode.encode(bytes, sizeof(bytes), QR_ECC_L));
+    std::string text = decode(qrCode);
+    TEST_ASSERT_EQUAL(sizeof(bytes), text.size());
+    TEST_ASSERT_EQUAL_MEMORY(bytes, text.data(), sizeof(bytes));
+
+    const char* urls[] = {
+        "https://burbsec.com",
+        "https://burbsec.com/bzImage/uid/0x4a3b2c1d",
+        "/bzImage/uid/0x4a3b2c1d",
+    };
+    for (size_t i = 0; i < sizeof(urls) / sizeof(urls[0]); i++) {
+        TEST_ASSERT_TRUE(qrCode.encode(urls[i]));
+        TEST_ASSERT_EQUAL_STRING(urls[i], decode(qrCode).c_str());
+    }
+}
+
+// ----------------------------------------------------------------------------
+// render() puts every module where the display shows it, light modules lit,
+// with a lit quiet zone, and leaves the rest of the buffer alone
+// ----------------------------------------------------------------------------
+static void test_render() {
+    const char* texts[] = { "hi", "https://burbsec.com/bzImage/uid/0x4a3b2c1d", "" };
+    for (size_t t = 0; t < sizeof(texts) / sizeof(texts[0]); t++) {
+        std::string text = texts[t][0] ? std::string(texts[t]) : makeText(capacity[QR_MAX_VERSION - 1][1], 9);
+        TEST_ASSERT_TRUE(qrCode.encode((const uint8_t*) text.data(), text.size(), QR_ECC_L));
+        int size = qrCode.getSize();
+        int scale = (size + 2) * 2 <= OLED_HEIGHT ? 2 : 1;
+
+        for (uint8_t fill = 0; fill < 2; fill++) {
+            uint8_t buffer[OLED_WIDTH * OLED_HEIGHT / 8];
+            memset(buffer, fill ? 0xFF : 0x00, sizeof(buffer));
+            int side = qrCode.render(buffer, OLED_WIDTH, OLED_HEIGHT);
+            TEST_ASSERT_TRUE(side > 0 && side <= OLED_HEIGHT);
+            TEST_ASSERT_EQUAL(0, side % scale);
+            int quiet = (side / scale - size) / 2;
+            TEST_ASSERT_TRUE(quiet >= 1 && quiet <= QR_MAX_QUIET);
+            int x0 = OLED_WIDTH - side;
+            int y0 = (OLED_HEIGHT - side) / 2;
+
+            for (int y = 0; y < OLED_HEIGHT; y++) {
+                for (int x = 0; x < OLED_WIDTH; x++) {
+                    bool lit = buffer[x + (y / 8) * OLED_WIDTH] & (1 << (y & 7));
+                    if (x < x0 || y < y0 || y >= y0 + side) {
+                        TEST_ASSERT_EQUAL(fill, lit);
+                        continue;
+                    }
+                    int mx = (x - x0) / scale - quiet;
+                    int my = (y - y0) / scale - quiet;
+                    bool inside = mx >= 0 && my >= 0 && mx < size && my < size;
+                    TEST_ASSERT_EQUAL(!inside || !qrCode.getModule(mx, my), lit);
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_length);
+    RUN_TEST(test_too_long);
+    RUN_TEST(test_binary_and_urls);
+    RUN_TEST(test_render);
+    return UNITY_END();
+}
@@ -0,0 +1,214 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests and draws per second of the effect random generator
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define BUCKETS  16
+#define DRAWS    (BUCKETS * 10000)
+#define CHI2_MAX 37.70                // 15 degrees of freedom, p = 0.001
+#define BENCH    20000000UL           // draws per generator
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static volatile uint32_t sink;        // keeps the benchmark loops alive
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+template<class Draw>
+static double drawsPerSecond(Draw draw) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < BENCH; i++) {
+        sum += draw();
+    }
+    sink = sum;
+    return BENCH / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// random(n) stays in [0, n), random(a, b) in [a, b)
+// ----------------------------------------------------------------------------
+static void test_range() {
+    FastRandom rng;
+    const uint32_t limits[] = { 1, 2, 3, 7, 100, 255, 256, 1000, 65536, 0xFFFFFFFFUL };
+    for (size_t l = 0; l < sizeof(limits) / sizeof(limits[0]); l++) {
+        for (uint32_t i = 0; i < 10000; i++) {
+            TEST_ASSERT_LESS_THAN_UINT32(limits[l], rng.random(limits[l]));
+        }
+    }
+    for (uint32_t i = 0; i < 10000; i++) {
+        int32_t v = rng.random(-50, 50);
+        TEST_ASSERT_TRUE(v >= -50 && v < 50);
+    }
+    TEST_ASSERT_EQUAL(7, rng.random(7, 7));
+    TEST_ASSERT_EQUAL(7, rng.random(7, 3));
+}
+
+// ----------------------------------------------------------------------------
+// A seed gives the same sequence, instances start on different ones, 0 is
+// not a stuck state
+// ----------------------------------------------------------------------------
+static void test_seed() {
+    FastRandom a, b;
+    bool differ = false;
+    for (uint8_t i = 0; i < 8; i++) {
+        differ |= a.next() != b.next();
+    }
+    TEST_ASSERT_TRUE(differ);
+
+    a.setSeed(1234);
+    b.setSeed(1234);
+    for (uint32_t i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQUAL_HEX32(a.next(), b.next());
+    }
+
+    a.setSeed(0);
+    uint32_t first = a.next();
+    TEST_ASSERT_NOT_EQUAL(0, first);
+    TEST_ASSERT_NOT_EQUAL(first, a.next());
+}
+
+// ----------------------------------------------------------------------------
+// Draws spread evenly over the buckets, chi-square at p = 0.001
+// ----------------------------------------------------------------------------
+static void test_uniform() {
+    FastRandom rng;
+    rng.setSeed(42);
+    uint32_t count[BUCKETS] = { 0 };
+    for (uint32_t i = 0; i < DRAWS; i++) {
+        count[rng.random(BUCKETS)]++;
+    }
+    double expected = (double) DRAWS / BUCKETS;
+    double chi2 = 0;
+    for (uint8_t i = 0; i < BUCKETS; i++) {
+        chi2 += (count[i] - expected) * (count[i] - expected) / expected;
+    }
+    TEST_ASSERT_TRUE(chi2 < CHI2_MAX);
+}
+
+// ----------------------------------------------------------------------------
+// A pool hands out its generator's values in order, the consumer takes
+// over when it runs empty
+// ----------------------------------------------------------------------------
+static void test_pool() {
+    RandomPool<16> pool;
+    pool.setSeed(99);
+    FastRandom reference;
+    reference.setSeed(99);
+
+    FastRandom rng;
+    rng.setSeed(7);
+    rng.setBuffer(&pool);
+    TEST_ASSERT_EQUAL(15, pool.fill());             // one slot stays free
+    TEST_ASSERT_EQUAL(0, pool.fill());
+    for (uint8_t i = 0; i < 15; i++) {
+        TEST_ASSERT_EQUAL_HEX32(reference.next(), rng.next());
+    }
+
+    FastRandom own;
+    own.setSeed(7);
+    TEST_ASSERT_EQUAL_HEX32(own.next(), rng.next());
+    TEST_ASSERT_EQUAL(15, pool.fill());
+    TEST_ASSERT_EQUAL_HEX32(reference.next(), rng.next());
+}
+
+// ----------------------------------------------------------------------------
+// Draws in [0, 256) per second: FastRandom, FastRandom fed by a pool that
+// is refilled every 64 draws, and Arduino random(). Printed only, the host
+// is not the badge. On the badge random() reads the hardware RNG.
+// ----------------------------------------------------------------------------
+static void test_draws_per_second() {
+    FastRandom rng;
+    double fast = drawsPerSecond([&]() { return rng.random(256); });
+
+    RandomPool<128> pool;
+    FastRandom pooled;
+    pooled.setBuffer(&pool);
+    uint8_t drawn = 0;
+    double withPool = drawsPerSecond([&]() {
+        if (!(drawn++ & 63)) {
+            pool.fill();
+        }
+        return pooled.random(256);
+    });
+
+    double arduino = drawsPerSecond([]() { return (uint32_t) random(256); });
+
+    char message[128];
+    snprintf(message, sizeof(message), "FastRandom %.1f M/s, with pool %.1f M/s, random() %.1f M/s",
+             fast / 1e6, withPool / 1e6, arduino / 1e6);
+    TEST_MESSAGE(message);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_range);
+    RUN_TEST(test_seed);
+    RUN_TEST(test_uniform);
+    RUN_TEST(test_pool);
+    RUN_TEST(test_draws_per_second);
+    return UNITY_END();
+}
@@ -0,0 +1,242 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests and timing of the contact index replay at boot
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#include "contacts.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define IMAGE       ".pio/test_replay.img"
+#define IMAGE_BYTES 0x80000           // the badge partition
+#define PEOPLE      600               // distinct badges met
+#define BOOTS       5                 // the fastest of these is reported
+
+// ============================================================================
+// TYPES
+// ============================================================================
+struct Tap {
+    uint8_t uid[CONTACT_UID_MAX];
+    uint32_t seconds;
+};
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static uint8_t master[CONTACT_MASTER_BYTES];
+static std::vector<Tap> taps;
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : fill
+// DESCRIPTION : A fresh log of n taps, snapshots taken when due or not at
+//               all. Returns the unique uid count.
+// ----------------------------------------------------------------------------
+static uint32_t fill(FileFlash& flash, size_t n, bool snapshots) {
+    remove(IMAGE);
+    TEST_ASSERT_TRUE(flash.begin(IMAGE, IMAGE_BYTES));
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash, master));
+    for (size_t i = 0; i < n; i++) {
+        store.append(taps[i].uid, CONTACT_UID_MAX, taps[i].seconds);
+        if (snapshots && store.snapshotDue()) {
+            TEST_ASSERT_TRUE(store.snapshot());
+        }
+    }
+    return store.unique();
+}
+
+// every uid of the first n taps is seen, one never tapped is not
+static void assertSeen(const ContactStore& store, size_t n, uint32_t unique) {
+    TEST_ASSERT_EQUAL_UINT32(unique, store.unique());
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_TRUE(store.seen(taps[i].uid, CONTACT_UID_MAX));
+    }
+    const uint8_t stranger[CONTACT_UID_MAX] = { 0x04, 0x1A, 0x2B, 0xFF, 0xFF, 0x07, 0x00 };
+    TEST_ASSERT_FALSE(store.seen(stranger, CONTACT_UID_MAX));
+}
+
+// offset of a snapshot slot, they sit at the end of the region
+static uint32_t slotOffset(uint8_t slot) {
+    return IMAGE_BYTES - (CONTACT_SNAP_SLOTS - slot) * CONTACT_SNAP_BYTES;
+}
+
+void setUp() {
+    memset(master, 0x3C, sizeof(master));
+    if (taps.empty()) {
+        srand(3);
+        uint32_t seconds = 100;
+        for (size_t i = 0; i < 20000; i++) {
+            uint16_t who = rand() % PEOPLE;
+            seconds += 5 + rand() % 600;
+            Tap t = { { 0x04, 0x1A, 0x2B, (uint8_t) (who >> 8), (uint8_t) who, 0x07, (uint8_t) (i & 1) }, seconds };
+            taps.push_back(t);
+        }
+    }
+}
+
+void tearDown() {
+    remove(IMAGE);
+}
+
+// ----------------------------------------------------------------------------
+// With snapshots a boot replays less than CONTACT_SNAP_EVERY records,
+// without it replays them all, the seen set is the same
+// ----------------------------------------------------------------------------
+static void test_replay_tail_only() {
+    for (uint8_t snapshots = 0; snapshots < 2; snapshots++) {
+        FileFlash flash;
+        uint32_t unique = fill(flash, 1000, snapshots);
+        ContactStore store;
+        TEST_ASSERT_TRUE(store.begin(flash, master));
+        if (snapshots) {
+            TEST_ASSERT_LESS_THAN_UINT32(CONTACT_SNAP_EVERY, store.replayed());
+        } else {
+            TEST_ASSERT_EQUAL_UINT32(store.count(), store.replayed());
+        }
+        assertSeen(store, 1000, unique);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// A damaged newest snapshot falls back to the other slot, two damaged ones
+// to a full replay. A torn one (reset before its header was written) has
+// no header at all.
+// ----------------------------------------------------------------------------
+static void test_damaged_snapshots() {
+    FileFlash flash;
+    uint32_t unique = fill(flash, 1000, true);
+    uint32_t tail;
+    {
+        ContactStore store;
+        TEST_ASSERT_TRUE(store.begin(flash, master));
+        tail = store.replayed();
+    }
+
+    // clear one byte of slot 0's fingerprints
+    uint8_t bytes[64];
+    uint32_t payload = slotOffset(0) + sizeof(ContactSnapshot);
+    TEST_ASSERT_TRUE(flash.read(payload, bytes, sizeof(bytes)));
+    uint8_t i = 0;
+    while (i < sizeof(bytes) && !bytes[i]) {
+        i++;
+    }
+    TEST_ASSERT_TRUE(i < sizeof(bytes));
+    const uint8_t zero = 0;
+    TEST_ASSERT_TRUE(flash.write(payload + i, &zero, 1));
+    {
+        ContactStore store;
+        TEST_ASSERT_TRUE(store.begin(flash, master));
+        TEST_ASSERT_TRUE(store.replayed() == tail || store.replayed() == tail + CONTACT_SNAP_EVERY);
+        assertSeen(store, 1000, unique);
+    }
+
+    // slot 1 torn
+    TEST_ASSERT_TRUE(flash.erase(slotOffset(1), FLASH_SECTOR_SIZE));
+    ContactStore store;
+    TEST_ASSERT_TRUE(store.begin(flash, master));
+    TEST_ASSERT_EQUAL_UINT32(store.count(), store.replayed());
+    assertSeen(store, 1000, unique);
+
+    // and the next snapshot is good again
+    TEST_ASSERT_TRUE(store.snapshot());
+    ContactStore reopened;
+    TEST_ASSERT_TRUE(reopened.begin(flash, master));
+    TEST_ASSERT_EQUAL_UINT32(0, reopened.replayed());
+    assertSeen(reopened, 1000, unique);
+}
+
+// ----------------------------------------------------------------------------
+// Boot time with and without snapshots, printed for the record. Only the
+// replay counts are asserted, host timings are too noisy to gate on.
+// ----------------------------------------------------------------------------
+static void test_boot_time() {
+    const size_t sizes[] = { 1000, 5000, 20000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (uint8_t snapshots = 0; snapshots < 2; snapshots++) {
+            FileFlash flash;
+            uint32_t unique = fill(flash, sizes[s], snapshots);
+            double best = 1e9;
+            uint32_t count = 0, replayed = 0;
+            for (uint8_t boot = 0; boot < BOOTS; boot++) {
+                ContactStore store;
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                TEST_ASSERT_TRUE(store.begin(flash, master));
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                best = ms < best ? ms : best;
+                TEST_ASSERT_EQUAL_UINT32(unique, store.unique());
+                count = store.count();
+                replayed = store.replayed();
+            }
+            TEST_ASSERT_TRUE(snapshots ? replayed < CONTACT_SNAP_EVERY : replayed == count);
+
+            char message[128];
+            snprintf(message, sizeof(message), "%5u records, %3u unique, %-11s: boot %7.3f ms, replayed %u",
+                     count, unique, snapshots ? "snapshots" : "no snapshot", best, replayed);
+            TEST_MESSAGE(message);
+        }
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_replay_tail_only);
+    RUN_TEST(test_damaged_snapshots);
+    RUN_TEST(test_boot_time);
+    return UNITY_END();
+}
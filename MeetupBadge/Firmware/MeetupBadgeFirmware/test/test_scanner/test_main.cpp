@@ -0,0 +1,202 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the Scanner writes per step
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// A group of N outputs that keeps the levels and counts the writes, also
+// those which don't change a level
+// ----------------------------------------------------------------------------
+template<uint8_t N>
+class Lamps {
+  public:
+    uint8_t level[N] = { 0 };
+    uint32_t writes = 0;
+    uint32_t unchanged = 0;           // writes of the level already shown
+
+    void begin() {}
+    void digWrite(size_t i, uint8_t val) { set(i, val ? 255 : 0); }
+    void pwmWrite(size_t i, uint8_t val) { set(i, val); }
+    void setOnColor(uint32_t) {}
+
+  private:
+    void set(size_t i, uint8_t val) {
+        TEST_ASSERT_TRUE(i < N);
+        writes++;
+        unchanged += level[i] == val;
+        level[i] = val;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// What a run of steps cost
+// ----------------------------------------------------------------------------
+struct ScanCost {
+    uint32_t maxWrites;               // most writes of one step
+    uint32_t unchanged;
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// the LED of the head after step k
+static uint8_t headOf(uint32_t k, uint8_t n, ScanPattern pattern) {
+    if (pattern == SCAN_WRAP) {
+        return k % n;
+    }
+    uint32_t s = k % (2 * n - 2);
+    return s < n ? s : 2 * n - 2 - s;
+}
+
+// runs three rounds and checks the head and the tail after each step
+template<uint8_t N, ScanPattern pattern, uint8_t tail>
+static ScanCost run() {
+    Lamps<N> lamps;
+    Scanner<Lamps<N>, N, pattern, tail> scanner(lamps);
+    ScanCost cost = { 0, 0 };
+    uint32_t steps = 3 * 2 * N;
+    for (uint32_t k = 0; k < steps; k++) {
+        uint32_t writes = lamps.writes;
+        stubAdvance(200);
+        scanner.update();
+        if (lamps.writes - writes > cost.maxWrites) {
+            cost.maxWrites = lamps.writes - writes;
+        }
+
+        uint8_t head = headOf(k, N, pattern);
+        TEST_ASSERT_EQUAL_UINT8(255, lamps.level[head]);
+        uint8_t lit = 0;
+        for (uint8_t i = 0; i < N; i++) {
+            lit += lamps.level[i] != 0;
+        }
+        TEST_ASSERT_TRUE(lit >= 1 && lit <= tail + 1);
+    }
+    cost.unchanged = lamps.unchanged;
+    return cost;
+}
+
+void setUp() {
+    stubMillis() = 0;
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// A step moves the head: the old LED off, the new one on, whatever N is
+// ----------------------------------------------------------------------------
+static void test_bounce() {
+    ScanCost small = run<5, SCAN_BOUNCE, 0>();
+    ScanCost large = run<120, SCAN_BOUNCE, 0>();
+    TEST_ASSERT_EQUAL_UINT32(2, small.maxWrites);
+    TEST_ASSERT_EQUAL_UINT32(small.maxWrites, large.maxWrites);
+    TEST_ASSERT_EQUAL_UINT32(0, small.unchanged);
+    TEST_ASSERT_EQUAL_UINT32(0, large.unchanged);
+}
+
+static void test_wrap() {
+    ScanCost small = run<5, SCAN_WRAP, 0>();
+    ScanCost large = run<120, SCAN_WRAP, 0>();
+    TEST_ASSERT_EQUAL_UINT32(2, small.maxWrites);
+    TEST_ASSERT_EQUAL_UINT32(small.maxWrites, large.maxWrites);
+    TEST_ASSERT_EQUAL_UINT32(0, small.unchanged);
+    TEST_ASSERT_EQUAL_UINT32(0, large.unchanged);
+}
+
+// ----------------------------------------------------------------------------
+// With a tail a step touches the tail only
+// ----------------------------------------------------------------------------
+static void test_tail() {
+    ScanCost bounceSmall = run<5, SCAN_BOUNCE, 2>();
+    ScanCost bounceLarge = run<120, SCAN_BOUNCE, 2>();
+    ScanCost wrapSmall = run<5, SCAN_WRAP, 2>();
+    ScanCost wrapLarge = run<120, SCAN_WRAP, 2>();
+    TEST_ASSERT_TRUE(bounceSmall.maxWrites <= 2 * (2 + 1));
+    TEST_ASSERT_EQUAL_UINT32(bounceSmall.maxWrites, bounceLarge.maxWrites);
+    TEST_ASSERT_TRUE(wrapSmall.maxWrites <= 2 * (2 + 1));
+    TEST_ASSERT_EQUAL_UINT32(wrapSmall.maxWrites, wrapLarge.maxWrites);
+    TEST_ASSERT_EQUAL_UINT32(0, bounceSmall.unchanged + bounceLarge.unchanged);
+    TEST_ASSERT_EQUAL_UINT32(0, wrapSmall.unchanged + wrapLarge.unchanged);
+}
+
+// ----------------------------------------------------------------------------
+// off() writes the LEDs which are on, nothing else
+// ----------------------------------------------------------------------------
+static void test_off() {
+    Lamps<60> lamps;
+    Scanner<Lamps<60>, 60, SCAN_WRAP, 3> scanner(lamps);
+    for (uint8_t k = 0; k < 10; k++) {
+        stubAdvance(200);
+        scanner.update();
+    }
+    uint32_t writes = lamps.writes;
+    scanner.off();
+    TEST_ASSERT_EQUAL_UINT32(4, lamps.writes - writes);
+    for (uint8_t i = 0; i < 60; i++) {
+        TEST_ASSERT_EQUAL_UINT8(0, lamps.level[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, lamps.unchanged);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bounce);
+    RUN_TEST(test_wrap);
+    RUN_TEST(test_tail);
+    RUN_TEST(test_off);
+    return UNITY_END();
+}
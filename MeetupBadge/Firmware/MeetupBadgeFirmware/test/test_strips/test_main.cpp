@@ -0,0 +1,176 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the NeoStripManager frame and timing model
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+#include <utility/Noiasca_neopixel.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define RED   0xFF0000
+#define GREEN 0x00FF00
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+void setUp() {
+    stubMillis() = 0;
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// Only the chains with a changed pixel are sent
+// ----------------------------------------------------------------------------
+static void test_clean_chains_skipped() {
+    Adafruit_NeoPixel a(8);
+    Adafruit_NeoPixel b(30);
+    Adafruit_NeoPixel c(60);
+    NeoStripManager manager(a, b, c);
+    NeoPixel first(manager, 0, 3);
+    NeoPixel last(manager, 2, 59);
+
+    manager.show();
+    TEST_ASSERT_EQUAL_UINT32(0, a.shows + b.shows + c.shows);
+
+    first.setOnColor(RED);
+    first.digWrite(HIGH);
+    TEST_ASSERT_TRUE(manager.isDirty(0));
+    TEST_ASSERT_FALSE(manager.isDirty(1));
+    manager.show();
+    TEST_ASSERT_EQUAL_UINT32(1, a.shows);
+    TEST_ASSERT_EQUAL_UINT32(0, b.shows);
+    TEST_ASSERT_EQUAL_UINT32(0, c.shows);
+    TEST_ASSERT_EQUAL_HEX32(RED, a.getPixelColor(3));
+
+    // the same color again changes nothing
+    first.digWrite(HIGH);
+    last.digWrite(LOW);
+    manager.show();
+    TEST_ASSERT_EQUAL_UINT32(1, a.shows);
+    TEST_ASSERT_EQUAL_UINT32(1, c.shows);
+}
+
+// ----------------------------------------------------------------------------
+// Any number of writes within a frame send a dirty chain once, frames
+// without a change send nothing
+// ----------------------------------------------------------------------------
+static void test_dirty_once_per_frame() {
+    Adafruit_NeoPixel a(16);
+    Adafruit_NeoPixel b(16);
+    NeoStripManager manager(a, b);
+    manager.setFrameInterval(20);
+    NeoPixel pixel(manager, 0, 0);
+    NeoPixel other(manager, 0, 7);
+    pixel.setOnColor(GREEN);
+
+    for (uint32_t ms = 1; ms <= 200; ms++) {
+        stubMillis() = ms;
+        pixel.pwmWrite(ms % 256);
+        other.digWrite(ms & 1);
+        manager.update();
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, a.shows);
+    TEST_ASSERT_EQUAL_UINT32(0, b.shows);
+
+    for (uint32_t ms = 201; ms <= 400; ms++) {
+        stubMillis() = ms;
+        other.digWrite(LOW);
+        manager.update();
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, a.shows);
+}
+
+// ----------------------------------------------------------------------------
+// The estimate counts the dirty chains: the slowest one in parallel, the
+// sum of all one after the other
+// ----------------------------------------------------------------------------
+static void test_estimate() {
+    TEST_ASSERT_EQUAL_UINT32(60 * 3 * 10 + 300, NeoStripManager::transmitMicros(60));
+    TEST_ASSERT_EQUAL_UINT32(10 * 4 * 10 + 300, NeoStripManager::transmitMicros(10, 4));
+
+    Adafruit_NeoPixel a(8);
+    Adafruit_NeoPixel b(30);
+    Adafruit_NeoPixel c(60);
+    NeoStripManager manager(a, b, c);
+    NeoPixel onA(manager, 0, 0);
+    NeoPixel onB(manager, 1, 0);
+    NeoPixel onC(manager, 2, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, manager.estimateShowMicros(true));
+    TEST_ASSERT_EQUAL_UINT32(0, manager.estimateShowMicros(false));
+
+    onA.digWrite(HIGH);
+    onC.digWrite(HIGH);
+    uint32_t ta = NeoStripManager::transmitMicros(8);
+    uint32_t tc = NeoStripManager::transmitMicros(60);
+    TEST_ASSERT_EQUAL_UINT32(tc, manager.estimateShowMicros(true));
+    TEST_ASSERT_EQUAL_UINT32(ta + tc, manager.estimateShowMicros(false));
+
+    onB.digWrite(HIGH);
+    uint32_t tb = NeoStripManager::transmitMicros(30);
+    TEST_ASSERT_EQUAL_UINT32(tc, manager.estimateShowMicros(true));
+    TEST_ASSERT_EQUAL_UINT32(ta + tb + tc, manager.estimateShowMicros(false));
+
+    manager.show();
+    TEST_ASSERT_EQUAL_UINT32(0, manager.estimateShowMicros(true));
+    TEST_ASSERT_EQUAL_UINT32(0, manager.estimateShowMicros(false));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_chains_skipped);
+    RUN_TEST(test_dirty_once_per_frame);
+    RUN_TEST(test_estimate);
+    return UNITY_END();
+}
@@ -0,0 +1,214 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the event tag lookup against tags.csv
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "tags.h"
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define TAGS_CSV   "tags.csv"
+#define NEGATIVES  1000000
+
+// ============================================================================
+// TYPES
+// ============================================================================
+struct Row {
+    std::string uid;
+    TagAction action;
+    uint8_t arg;
+};
+
+// the same values as tools/test_gen_tags.py, the generator and the firmware
+// must pack and hash alike
+struct Vector {
+    uint8_t uid[7];
+    uint8_t uidLength;
+    uint32_t seed;
+    uint32_t hi;
+    uint32_t lo;
+    uint32_t hash;
+};
+
+static const Vector vectors[] = {
+    { { 0xDE, 0xAD, 0xBE, 0xEF },                   4, 0x00000000, 0x04DEADBE, 0xEF000000, 0x1F8234F0 },
+    { { 0x04, 0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6 }, 7, 0x00005EED, 0x0704A1B2, 0xC3D4E5F6, 0x25623C64 },
+    { { 0xDE, 0xAD, 0xBE, 0xEF, 0x00, 0x00, 0x00 }, 7, 0xDAEB8EBD, 0x07DEADBE, 0xEF000000, 0x3B5507B5 },
+    { { 0x00, 0x00, 0x00, 0x00 },                   4, 0xFFFFFFFF, 0x04000000, 0x00000000, 0x37653EDE },
+};
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : readCsv
+// DESCRIPTION : The rows of tags.csv, the way tools/gen_tags.py reads them
+// ----------------------------------------------------------------------------
+static std::vector<Row> readCsv() {
+    std::vector<Row> rows;
+    FILE* f = fopen(TAGS_CSV, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char hex[32], action[32];
+        unsigned arg = 0;
+        if (line[0] == '#' || sscanf(line, " %31[^,],%31[^,],%u", hex, action, &arg) < 2
+            || !strcmp(hex, "uid")) {
+            continue;
+        }
+        Row row;
+        for (size_t i = 0; i + 1 < strlen(hex); i += 2) {
+            unsigned byte;
+            sscanf(hex + i, "%2x", &byte);
+            row.uid += (char) byte;
+        }
+        row.action = !strcmp(action, "sponsor") ? TAG_SPONSOR
+                   : !strcmp(action, "room") ? TAG_ROOM
+                   : !strcmp(action, "organiser") ? TAG_ORGANISER : TAG_NONE;
+        TEST_ASSERT_NOT_EQUAL(TAG_NONE, row.action);
+        row.arg = arg;
+        rows.push_back(row);
+    }
+    fclose(f);
+    return rows;
+}
+
+void setUp() {
+    srand(7);
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// uidKey() and uidHash() agree with tools/uidkey.py
+// ----------------------------------------------------------------------------
+static void test_uid_hash_vectors() {
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        const Vector& v = vectors[i];
+        UidKey key = uidKey(v.uid, v.uidLength);
+        TEST_ASSERT_EQUAL_HEX32(v.hi, key.hi);
+        TEST_ASSERT_EQUAL_HEX32(v.lo, key.lo);
+        TEST_ASSERT_EQUAL_HEX32(v.hash, uidHash(key.hi, key.lo, v.seed));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Every tag of tags.csv is found with its action and arg
+// ----------------------------------------------------------------------------
+static void test_every_tag() {
+    std::vector<Row> rows = readCsv();
+    TEST_ASSERT_TRUE(rows.size() > 0);
+    for (size_t i = 0; i < rows.size(); i++) {
+        const uint8_t* uid = (const uint8_t*) rows[i].uid.data();
+        uint8_t arg = 0xFF;
+        TEST_ASSERT_EQUAL(rows[i].action, tagLookup(uid, rows[i].uid.size(), &arg));
+        TEST_ASSERT_EQUAL(rows[i].arg, arg);
+        TEST_ASSERT_EQUAL(rows[i].action, tagLookup(uid, rows[i].uid.size(), nullptr));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Nothing else matches: random uids, a tag read with another length, and a
+// one bit change of each tag
+// ----------------------------------------------------------------------------
+static void test_no_false_matches() {
+    std::vector<Row> rows = readCsv();
+    std::set<std::string> known;
+    for (size_t i = 0; i < rows.size(); i++) {
+        known.insert(rows[i].uid);
+    }
+
+    uint32_t matches = 0;
+    for (uint32_t i = 0; i < NEGATIVES; i++) {
+        uint8_t uid[7];
+        uint8_t len = rand() & 1 ? 4 : 7;
+        for (uint8_t j = 0; j < len; j++) {
+            uid[j] = rand();
+        }
+        if (!known.count(std::string((const char*) uid, len))) {
+            matches += tagLookup(uid, len, nullptr) != TAG_NONE;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, matches);
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        uint8_t uid[10] = { 0 };
+        uint8_t len = rows[i].uid.size();
+        memcpy(uid, rows[i].uid.data(), len);
+        for (uint8_t other = 0; other <= sizeof(uid); other++) {
+            if (other != len && !known.count(std::string((const char*) uid, other))) {
+                TEST_ASSERT_EQUAL(TAG_NONE, tagLookup(uid, other, nullptr));
+            }
+        }
+        for (uint8_t bit = 0; bit < len * 8; bit++) {
+            uid[bit / 8] ^= 1 << (bit % 8);
+            if (!known.count(std::string((const char*) uid, len))) {
+                TEST_ASSERT_EQUAL(TAG_NONE, tagLookup(uid, len, nullptr));
+            }
+            uid[bit / 8] ^= 1 << (bit % 8);
+        }
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_uid_hash_vectors);
+    RUN_TEST(test_every_tag);
+    RUN_TEST(test_no_false_matches);
+    return UNITY_END();
+}
@@ -0,0 +1,177 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the Trafficlight preset on the Sequencer
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Noiasca_led.h>
+
+// ============================================================================
+// DEFINES
+// ============================================================================
+#define LAMP_RED    0
+#define LAMP_YELLOW 1
+#define LAMP_GREEN  2
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Three lamps, keeps the level of each and counts the writes
+// ----------------------------------------------------------------------------
+class Lamps {
+  public:
+    uint8_t level[3] = {LOW, LOW, LOW};
+    uint32_t writes = 0;
+
+    void begin() {}
+    void digWrite(uint8_t index, uint8_t val) {
+        level[index] = val;
+        writes++;
+    }
+    void setOnColor(uint16_t, uint32_t) {}
+    void setOffColor(uint32_t) {}
+
+    bool shows(uint8_t red, uint8_t yellow, uint8_t green) const {
+        return level[LAMP_RED] == red && level[LAMP_YELLOW] == yellow && level[LAMP_GREEN] == green;
+    }
+};
+
+// ============================================================================
+// Global variables
+// ============================================================================
+static uint8_t lastState;
+static uint8_t stateChanges;
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+static void onState(uint8_t state) {
+    lastState = state;
+    stateChanges++;
+}
+
+// runs update() every 10 ms up to the time given
+static void runUntil(Trafficlight<Lamps>& light, uint32_t until) {
+    while (millis() < until) {
+        stubAdvance(10);
+        light.update();
+    }
+}
+
+void setUp() {
+    stubMillis()  = 0;
+    lastState     = 0xFF;
+    stateChanges  = 0;
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// A new light blinks yellow for the time of the first sequence, then goes on
+// with the second one, RED only comes round after the last
+// ----------------------------------------------------------------------------
+static void test_starts_yellow_blink() {
+    Lamps lamps;
+    Trafficlight<Lamps> light(lamps);
+    light.setOnStateChange(onState);
+    light.update();
+    TEST_ASSERT_EQUAL_UINT32(0, lamps.writes);
+
+    runUntil(light, 500);
+    TEST_ASSERT_TRUE(lamps.shows(LOW, HIGH, LOW));
+    runUntil(light, 1000);
+    TEST_ASSERT_TRUE(lamps.shows(LOW, LOW, LOW));
+    runUntil(light, 4990);
+    TEST_ASSERT_EQUAL(0, stateChanges);
+    TEST_ASSERT_EQUAL_UINT32(9, lamps.writes);
+
+    runUntil(light, 5000);
+    TEST_ASSERT_EQUAL(Trafficlight<Lamps>::State::REDYELLOW, lastState);
+    TEST_ASSERT_TRUE(lamps.shows(HIGH, HIGH, LOW));
+    runUntil(light, 8000);
+    TEST_ASSERT_EQUAL(Trafficlight<Lamps>::State::GREEN, lastState);
+    runUntil(light, 10500);
+    TEST_ASSERT_EQUAL(Trafficlight<Lamps>::State::YELLOW, lastState);
+    runUntil(light, 13500);
+    TEST_ASSERT_EQUAL(Trafficlight<Lamps>::State::RED, lastState);
+    TEST_ASSERT_TRUE(lamps.shows(HIGH, LOW, LOW));
+    TEST_ASSERT_EQUAL(4, stateChanges);
+}
+
+// ----------------------------------------------------------------------------
+// In manual mode the yellow blink stays until a state is set
+// ----------------------------------------------------------------------------
+static void test_manual_keeps_blinking() {
+    Lamps lamps;
+    Trafficlight<Lamps> light(lamps);
+    light.setMode(Trafficlight<Lamps>::Mode::MANUAL);
+    light.setOnStateChange(onState);
+    runUntil(light, 20000);
+    TEST_ASSERT_EQUAL(0, stateChanges);
+    TEST_ASSERT_EQUAL_UINT32(40, lamps.writes);
+    TEST_ASSERT_EQUAL(LOW, lamps.level[LAMP_RED]);
+    TEST_ASSERT_EQUAL(LOW, lamps.level[LAMP_GREEN]);
+
+    light.green();
+    TEST_ASSERT_EQUAL(Trafficlight<Lamps>::State::GREEN, lastState);
+    TEST_ASSERT_TRUE(lamps.shows(LOW, LOW, HIGH));
+    runUntil(light, 30000);
+    TEST_ASSERT_TRUE(lamps.shows(LOW, LOW, HIGH));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_starts_yellow_blink);
+    RUN_TEST(test_manual_keeps_blinking);
+    return UNITY_END();
+}
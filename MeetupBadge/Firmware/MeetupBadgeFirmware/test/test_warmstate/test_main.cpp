@@ -0,0 +1,205 @@
+// ============================================================================
+//
+// BurbSec MeetupBadge Firmware
+//
+// test_main.cpp
+//
+// Host tests of the warm restart state
+//
+// Darren Young [youngd24@gmail.com]
+//
+// ============================================================================
+// LICENSE
+// ============================================================================
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2024, Darren Young
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ============================================================================
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <unity.h>
+#include <esp_system.h>
+
+#include "warmstate.h"
+
+// ============================================================================
+// FUNCTIONS
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// NAME        : reset
+// DESCRIPTION : What the next boot sees, the RTC copy stays where it is
+// ----------------------------------------------------------------------------
+static bool reset(WarmState& warm, esp_reset_reason_t reason) {
+    stubResetReason() = reason;
+    warm = WarmState();
+    return warm.begin();
+}
+
+void setUp() {
+    WarmState warm;
+    reset(warm, ESP_RST_POWERON);
+}
+
+void tearDown() {
+}
+
+// ----------------------------------------------------------------------------
+// Tests
+// ----------------------------------------------------------------------------
+static void test_power_on_is_cold() {
+    WarmState warm;
+    TEST_ASSERT_FALSE(reset(warm, ESP_RST_POWERON));
+    TEST_ASSERT_EQUAL(WARM_SCREEN_WAITING, warm.data().screen);
+    TEST_ASSERT_EQUAL_UINT32(0, warm.data().taps);
+}
+
+static void test_watchdog_restores() {
+    WarmState warm;
+    reset(warm, ESP_RST_POWERON);
+    uint8_t uid[7] = { 4, 1, 2, 3, 4, 5, 6 };
+    warm.addTap(uid, sizeof(uid));
+    warm.setUrl("https://burbsec.com/");
+    warm.setPhase(3, 2, 120);
+    stubAdvance(5000);
+    warm.save();
+
+    TEST_ASSERT_TRUE(reset(warm, ESP_RST_TASK_WDT));
+    TEST_ASSERT_FALSE(warm.safe());
+    TEST_ASSERT_EQUAL(WARM_SCREEN_URL, warm.data().screen);
+    TEST_ASSERT_EQUAL_STRING("https://burbsec.com/", warm.data().url);
+    TEST_ASSERT_EQUAL_UINT32(1, warm.data().taps);
+    TEST_ASSERT_EQUAL(7, warm.lastTap().uidLength);
+    TEST_ASSERT_EQUAL_MEMORY(uid, warm.lastTap().uid, sizeof(uid));
+    TEST_ASSERT_EQUAL(2, warm.data().phases[3].state);
+    TEST_ASSERT_EQUAL_UINT32(120, warm.data().phases[3].elapsed);
+    TEST_ASSERT_EQUAL(1, warm.data().watchdogs);
+
+    // badge time carries on from the seconds before the reset
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(5, warm.seconds());
+}
+
+static void test_reset_pin_is_cold() {
+    WarmState warm;
+    reset(warm, ESP_RST_POWERON);
+    warm.setList(40);
+    TEST_ASSERT_FALSE(reset(warm, ESP_RST_EXT));
+    TEST_ASSERT_EQUAL(WARM_SCREEN_WAITING, warm.data().screen);
+}
+
+static void test_deep_sleep_and_brownout_are_warm() {
+    WarmState warm;
+    reset(warm, ESP_RST_POWERON);
+    warm.setList(40);
+    TEST_ASSERT_TRUE(reset(warm, ESP_RST_DEEPSLEEP));
+    warm.save();
+    TEST_ASSERT_TRUE(reset(warm, ESP_RST_BROWNOUT));
+    TEST_ASSERT_EQUAL(WARM_SCREEN_LIST, warm.data().screen);
+    TEST_ASSERT_EQUAL_UINT32(40, warm.data().listPosition);
+    TEST_ASSERT_EQUAL(1, warm.data().sleeps);
+    TEST_ASSERT_EQUAL(1, warm.data().brownouts);
+}
+
+// a brown-out in the middle of a write leaves a copy that doesn't check out
+static void test_damaged_copy_is_cold() {
+    WarmState warm;
+    reset(warm, ESP_RST_POWERON);
+    warm.setList(40);
+    WarmData& data = const_cast<WarmData&>(warm.data());
+    data.listPosition ^= 1;
+    TEST_ASSERT_FALSE(reset(warm, ESP_RST_BROWNOUT));
+    TEST_ASSERT_EQUAL(WARM_SCREEN_WAITING, warm.data().screen);
+}
+
+// the screen that was up may be what crashed
+static void test_panic_drops_screen() {
+    WarmState warm;
+    reset(warm, ESP_RST_POWERON);
+    uint8_t uid[4] = { 1, 2, 3, 4 };
+    warm.addTap(uid, sizeof(uid));
+    warm.setScreen(WARM_SCREEN_CARD);
+    TEST_ASSERT_TRUE(reset(warm, ESP_RST_PANIC));
+    TEST_ASSERT_TRUE(warm.safe());
+    TEST_ASSERT_EQUAL(WARM_SCREEN_WAITING, warm.data().screen);
+    TEST_ASSERT_EQUAL_UINT32(1, warm.data().taps);
+}
+
+// watchdog resets that never get through loop() stop restoring the screen
+static void test_reset_loop_drops_screen() {
+    WarmState warm;
+    reset(warm, ESP_RST_POWERON);
+    warm.setList(40);
+    for (uint8_t i = 0; i < WARM_RESTORE_MAX; i++) {
+        TEST_ASSERT_TRUE(reset(warm, ESP_RST_TASK_WDT));
+        TEST_ASSERT_FALSE(warm.safe());
+        TEST_ASSERT_EQUAL(WARM_SCREEN_LIST, warm.data().screen);
+    }
+    TEST_ASSERT_TRUE(reset(warm, ESP_RST_TASK_WDT));
+    TEST_ASSERT_TRUE(warm.safe());
+    TEST_ASSERT_EQUAL(WARM_SCREEN_WAITING, warm.data().screen);
+
+    // a clean loop() arms it again
+    warm.setList(7);
+    warm.save();
+    TEST_ASSERT_TRUE(reset(warm, ESP_RST_TASK_WDT));
+    TEST_ASSERT_FALSE(warm.safe());
+    TEST_ASSERT_EQUAL(WARM_SCREEN_LIST, warm.data().screen);
+}
+
+// a blink keeps the time into the state it had when it toggled
+static void test_phase_only_on_change() {
+    WarmState warm;
+    reset(warm, ESP_RST_POWERON);
+    warm.setPhase(0, 2, 10);
+    warm.setPhase(0, 2, 99);
+    warm.save();
+    TEST_ASSERT_EQUAL_UINT32(10, warm.data().phases[0].elapsed);
+    warm.setPhase(0, 1, 3);
+    warm.save();
+    TEST_ASSERT_TRUE(reset(warm, ESP_RST_SW));
+    TEST_ASSERT_EQUAL(1, warm.data().phases[0].state);
+    TEST_ASSERT_EQUAL_UINT32(3, warm.data().phases[0].elapsed);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_power_on_is_cold);
+    RUN_TEST(test_watchdog_restores);
+    RUN_TEST(test_reset_pin_is_cold);
+    RUN_TEST(test_deep_sleep_and_brownout_are_warm);
+    RUN_TEST(test_damaged_copy_is_cold);
+    RUN_TEST(test_panic_drops_screen);
+    RUN_TEST(test_reset_loop_drops_screen);
+    RUN_TEST(test_phase_only_on_change);
+    return UNITY_END();
+}
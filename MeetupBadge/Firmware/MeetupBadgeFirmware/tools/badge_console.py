@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# badge_console.py
+#
+# Host side client for the badge binary console (see include/console.h)
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import struct
+import sys
+import time
+
+import serial  # pyserial
+
+# ============================================================================
+# DEFINES
+# ============================================================================
+DEFAULT_BAUD = 115200
+
+CMD_PING = 0x01
+CMD_INFO = 0x02
+CMD_SET_BAUD = 0x03
+CMD_HUNT_SET_KEY = 0x10
+CMD_HUNT_BENCH = 0x11
+RESPONSE = 0x80
+
+STATUS = {
+    0x00: "OK",
+    0x01: "unknown command",
+    0x02: "bad arguments",
+    0x03: "busy",
+    0x04: "failed",
+}
+
+
+# ============================================================================
+# FUNCTIONS
+# ============================================================================
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, same as Console::crc16()"""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_idx = 0
+    code = 1
+    for b in data:
+        if b == 0:
+            out[code_idx] = code
+            code = 1
+            code_idx = len(out)
+            out.append(0)
+        else:
+            out.append(b)
+            code += 1
+            if code == 0xFF:
+                out[code_idx] = code
+                code = 1
+                code_idx = len(out)
+                out.append(0)
+    out[code_idx] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("malformed COBS frame")
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i != len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class ConsoleError(Exception):
+    pass
+
+
+class BadgeConsole:
+    """Request/response client. send() returns a sequence number right away,
+    so several requests can be in flight, wait() collects the answer."""
+
+    def __init__(self, port, baud=DEFAULT_BAUD, timeout=1.0):
+        self.ser = serial.Serial(port, baud, timeout=0.05)
+        self.timeout = timeout
+        self.seq = 0
+        self.rx = bytearray()
+        self.done = {}
+
+    def close(self):
+        self.ser.close()
+
+    def send(self, cmd, payload=b""):
+        self.seq = (self.seq + 1) & 0xFF
+        body = bytes([self.seq, cmd]) + payload
+        frame = body + struct.pack("<H", crc16(body))
+        self.ser.write(b"\x00" + cobs_encode(frame) + b"\x00")
+        return self.seq
+
+    def _read_frames(self):
+        self.rx += self.ser.read(self.ser.in_waiting or 1)
+        while b"\x00" in self.rx:
+            raw, _, self.rx = self.rx.partition(b"\x00")
+            if not raw:
+                continue
+            try:
+                frame = cobs_decode(raw)
+            except ValueError:
+                continue               # debug text or line noise
+            if len(frame) < 5 or crc16(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+                continue
+            self.done[frame[0]] = (frame[1] & ~RESPONSE, frame[2], frame[3:-2])
+
+    def wait(self, seq):
+        deadline = time.monotonic() + self.timeout
+        while seq not in self.done:
+            if time.monotonic() > deadline:
+                raise ConsoleError("timeout waiting for seq %d" % seq)
+            self._read_frames()
+        _, status, payload = self.done.pop(seq)
+        if status != 0:
+            raise ConsoleError(STATUS.get(status, "status 0x%02x" % status))
+        return payload
+
+    def request(self, cmd, payload=b""):
+        return self.wait(self.send(cmd, payload))
+
+    def pipeline(self, requests):
+        """Send all (cmd, payload) pairs, then collect the responses in order"""
+        seqs = [self.send(cmd, payload) for cmd, payload in requests]
+        return [self.wait(s) for s in seqs]
+
+    def ping(self, data=b""):
+        return self.request(CMD_PING, data)
+
+    def info(self):
+        uptime, heap, baud, max_payload = struct.unpack("<IIIH", self.request(CMD_INFO))
+        return {"uptime_ms": uptime, "free_heap": heap, "baud": baud, "max_payload": max_payload}
+
+    def set_baud(self, baud):
+        """Negotiate a faster rate. The badge reverts on its own if the
+        confirming ping at the new rate never arrives."""
+        self.request(CMD_SET_BAUD, struct.pack("<I", baud))
+        self.ser.baudrate = baud
+        self.rx.clear()
+        self.ping(b"baud")
+
+    def hunt_set_key(self, key):
+        """Provision the 32 byte scavenger hunt key, see tools/hunt_tag.py"""
+        self.request(CMD_HUNT_SET_KEY, bytes(key))
+
+    def hunt_bench(self):
+        """Checkpoint verifications per second on the SHA accelerator and in software"""
+        hardware, software = struct.unpack("<II", self.request(CMD_HUNT_BENCH))
+        return {"hardware": hardware, "software": software}
+
+
+# ============================================================================
+# Main
+# ============================================================================
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: badge_console.py PORT [BAUD]")
+        sys.exit(1)
+    console = BadgeConsole(sys.argv[1])
+    if len(sys.argv) > 2:
+        console.set_baud(int(sys.argv[2]))
+    print(console.info())
+    console.close()
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# gen_blocklist.py
+#
+# Build the Bloom filter of blocked tags (include/blocklist_table.h) from
+# blocklist.txt
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import math
+import os
+import random
+import sys
+
+from uidkey import UID_LENGTHS, parse_uid, uid_hash, uid_key
+
+# ============================================================================
+# DEFINES
+# ============================================================================
+DEFAULT_FP_RATE = 0.001
+MAX_HASHES = 16
+SEED1 = 0x0B10C4ED
+SEED2 = 0x5EED0B10
+NEGATIVES = 200000          # random uids used to measure the false positive rate
+
+
+class BlocklistError(Exception):
+    pass
+
+
+# ============================================================================
+# FUNCTIONS
+# ============================================================================
+
+def read_list(path):
+    """uids of the list, one hex uid per line, '#' starts a comment"""
+    uids = []
+    with open(path) as f:
+        for n, line in enumerate(f, 1):
+            text = line.split("#", 1)[0].strip()
+            if not text:
+                continue
+            try:
+                uids.append(parse_uid(text))
+            except ValueError:
+                raise BlocklistError("%s: line %d: '%s' is not 4 or 7 bytes of hex" % (path, n, text))
+    return sorted(set(uids))
+
+
+def dimension(n, fp_rate):
+    """(bits, hashes) for n keys at fp_rate, bits is a multiple of 32"""
+    if not 0 < fp_rate < 1:
+        raise BlocklistError("false positive rate must be between 0 and 1")
+    if n == 0:
+        return 32, 1
+    bits = int(math.ceil(-n * math.log(fp_rate) / (math.log(2) ** 2)))
+    bits = (bits + 31) // 32 * 32
+    hashes = int(round(bits / n * math.log(2)))
+    return bits, min(max(hashes, 1), MAX_HASHES)
+
+
+def probes(key, bits, hashes):
+    """Bit numbers of a key, same as blocklistContains(): double hashing and
+    a multiply instead of a modulo to map a hash onto the filter"""
+    h = uid_hash(key, SEED1)
+    step = uid_hash(key, SEED2) | 1
+    for _ in range(hashes):
+        yield (h * bits) >> 32
+        h = (h + step) & 0xFFFFFFFF
+
+
+def build(uids, bits, hashes):
+    words = [0] * (bits // 32)
+    for uid in uids:
+        for bit in probes(uid_key(uid), bits, hashes):
+            words[bit >> 5] |= 1 << (bit & 31)
+    return words
+
+
+def contains(words, bits, hashes, uid):
+    return all(words[b >> 5] >> (b & 31) & 1 for b in probes(uid_key(uid), bits, hashes))
+
+
+def measure(words, bits, hashes, uids):
+    """False positive rate over random uids that are not on the list"""
+    for uid in uids:
+        if not contains(words, bits, hashes, uid):
+            raise BlocklistError("self check: uid %s not blocked" % uid.hex())
+    if not uids:
+        return 0.0
+    rng = random.Random(0xBAD)
+    listed = set(uids)
+    tried = hits = 0
+    while tried < NEGATIVES:
+        uid = bytes(rng.getrandbits(8) for _ in range(rng.choice(UID_LENGTHS)))
+        if uid in listed:
+            continue
+        tried += 1
+        hits += contains(words, bits, hashes, uid)
+    return hits / tried
+
+
+def render(uids, bits, hashes, words, fp_rate, measured, source):
+    out = []
+    out.append("// ============================================================================")
+    out.append("// GENERATED by tools/gen_blocklist.py from %s, do not edit" % source)
+    out.append("// ============================================================================")
+    out.append("")
+    out.append("#pragma once")
+    out.append("")
+    out.append("// %d uids, %d bytes, target false positive rate %g, measured %.6f"
+               % (len(uids), bits // 8, fp_rate, measured))
+    out.append("#define BLOCK_KEYS    %d" % len(uids))
+    out.append("#define BLOCK_BITS    %dUL" % bits)
+    out.append("#define BLOCK_HASHES  %d" % hashes)
+    out.append("#define BLOCK_SEED1   0x%08XUL" % SEED1)
+    out.append("#define BLOCK_SEED2   0x%08XUL" % SEED2)
+    out.append("")
+    out.append("static constexpr uint32_t blockFilter[BLOCK_BITS / 32] = {")
+    for i in range(0, len(words), 6):
+        out.append("    " + " ".join("0x%08XUL," % w for w in words[i:i + 6]))
+    out.append("};")
+    out.append("")
+    return "\n".join(out)
+
+
+def generate(list_path, out_path, fp_rate=DEFAULT_FP_RATE):
+    """Write out_path from list_path, only touches the file if it changed.
+    Returns (changed, keys, bytes, measured false positive rate)."""
+    uids = read_list(list_path)
+    bits, hashes = dimension(len(uids), fp_rate)
+    words = build(uids, bits, hashes)
+    measured = measure(words, bits, hashes, uids)
+    text = render(uids, bits, hashes, words, fp_rate, measured, os.path.basename(list_path))
+    changed = True
+    if os.path.exists(out_path):
+        with open(out_path) as f:
+            changed = f.read() != text
+    if changed:
+        with open(out_path, "w") as f:
+            f.write(text)
+    return changed, len(uids), bits // 8, measured
+
+
+# ============================================================================
+# Main
+# ============================================================================
+if __name__ == "__main__":
+    if len(sys.argv) not in (3, 4):
+        print("usage: gen_blocklist.py BLOCKLIST_TXT OUT_H [FP_RATE]")
+        sys.exit(1)
+    try:
+        fp_rate = float(sys.argv[3]) if len(sys.argv) > 3 else DEFAULT_FP_RATE
+        changed, keys, size, measured = generate(sys.argv[1], sys.argv[2], fp_rate)
+    except (BlocklistError, ValueError) as e:
+        print("gen_blocklist.py: %s" % e)
+        sys.exit(1)
+    print("gen_blocklist.py: %s %s, %d uids in %d bytes, false positive rate %.6f (target %g)"
+          % (sys.argv[2], "written" if changed else "up to date", keys, size, measured, fp_rate))
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# gen_tags.py
+#
+# Build the event tag table (include/tags_table.h) from tags.csv
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import csv
+import os
+import random
+import re
+import sys
+
+from uidkey import UID_LENGTHS, parse_uid, uid_hash, uid_key
+
+# ============================================================================
+# DEFINES
+# ============================================================================
+MAX_SEEDS = 100000          # seeds tried before giving up
+NEGATIVES = 100000          # random uids checked against the finished table
+
+
+class TagError(Exception):
+    pass
+
+
+# ============================================================================
+# FUNCTIONS
+# ============================================================================
+
+def read_actions(header):
+    """TAG_* names of the TagAction enum, so typos fail here and not in the compiler"""
+    with open(header) as f:
+        text = f.read()
+    enum = re.search(r"enum TagAction[^{]*\{([^}]*)\}", text)
+    if not enum:
+        raise TagError("%s: no TagAction enum" % header)
+    return set(re.findall(r"\bTAG_([A-Z0-9_]+)\b", enum.group(1))) - {"NONE"}
+
+
+def read_csv(path, actions):
+    """[(uid bytes, action, arg, note)] from the csv, '#' starts a comment line"""
+    tags = []
+    seen = set()
+    with open(path, newline="") as f:
+        rows = csv.reader(line for line in f if line.strip() and not line.lstrip().startswith("#"))
+        for n, row in enumerate(rows, 1):
+            row = [c.strip() for c in row]
+            if n == 1 and row[0].lower() == "uid":
+                continue
+            if len(row) < 2:
+                raise TagError("%s: row %d: need at least uid,action" % (path, n))
+            try:
+                uid = parse_uid(row[0])
+            except ValueError:
+                raise TagError("%s: row %d: uid '%s' is not 4 or 7 bytes of hex" % (path, n, row[0]))
+            if uid in seen:
+                raise TagError("%s: row %d: uid %s listed twice" % (path, n, row[0]))
+            action = row[1].upper()
+            if action not in actions:
+                raise TagError("%s: row %d: unknown action '%s', one of %s"
+                               % (path, n, row[1], ", ".join(sorted(actions))))
+            arg = int(row[2], 0) if len(row) > 2 and row[2] else 0
+            if not 0 <= arg <= 255:
+                raise TagError("%s: row %d: arg must fit in a byte" % (path, n))
+            note = row[3] if len(row) > 3 else ""
+            seen.add(uid)
+            tags.append((uid, action, arg, note))
+    return tags
+
+
+def build(keys):
+    """Hash and displace: bucket = (h >> 16) % buckets, slot = ((h & 0xFFFF) +
+    displace[bucket]) % size. Buckets are placed biggest first, each one gets
+    the first displacement that lands all its keys in free slots.
+    Returns (seed, displace, slots) with slots[i] the key index in slot i."""
+    size = max(len(keys), 1)
+    buckets = max((len(keys) + 1) // 2, 1)
+    rng = random.Random(0x5EED)
+    for _ in range(MAX_SEEDS):
+        seed = rng.getrandbits(32)
+        groups = [[] for _ in range(buckets)]
+        for i, key in enumerate(keys):
+            h = uid_hash(key, seed)
+            groups[(h >> 16) % buckets].append((i, h & 0xFFFF))
+
+        # keys of one bucket move together, they must not share a slot already
+        if any(len({p % size for _, p in g}) != len(g) for g in groups):
+            continue
+
+        displace = [0] * buckets
+        slots = [None] * size
+        placed = True
+        for b in sorted(range(buckets), key=lambda b: -len(groups[b])):
+            if not placed or not groups[b]:
+                break
+            placed = False
+            for d in range(size):
+                want = [(p + d) % size for _, p in groups[b]]
+                if all(slots[s] is None for s in want):
+                    displace[b] = d
+                    for (i, _), s in zip(groups[b], want):
+                        slots[s] = i
+                    placed = True
+                    break
+        if placed:
+            return seed, displace, slots
+    raise TagError("no perfect hash found in %d seeds" % MAX_SEEDS)
+
+
+def lookup(key, seed, displace, table):
+    """Same as tagLookup() in src/tags.cpp, table holds the slot keys"""
+    h = uid_hash(key, seed)
+    slot = ((h & 0xFFFF) + displace[(h >> 16) % len(displace)]) % len(table)
+    return slot if table[slot] == key else None
+
+
+def verify(tags, seed, displace, slots):
+    keys = [uid_key(t[0]) for t in tags]
+    table = [keys[i] if i is not None else None for i in slots]
+    for i, key in enumerate(keys):
+        if lookup(key, seed, displace, table) is None or slots[lookup(key, seed, displace, table)] != i:
+            raise TagError("self check: uid %s not found" % tags[i][0].hex())
+    rng = random.Random(0xBAD)
+    known = set(keys)
+    for _ in range(NEGATIVES):
+        uid = bytes(rng.getrandbits(8) for _ in range(rng.choice(UID_LENGTHS)))
+        key = uid_key(uid)
+        if key not in known and lookup(key, seed, displace, table) is not None:
+            raise TagError("self check: unknown uid %s matched" % uid.hex())
+
+
+def render(tags, seed, displace, slots, source):
+    out = []
+    out.append("// ============================================================================")
+    out.append("// GENERATED by tools/gen_tags.py from %s, do not edit" % source)
+    out.append("// ============================================================================")
+    out.append("")
+    out.append("#pragma once")
+    out.append("")
+    out.append('#include "tags.h"')
+    out.append("")
+    out.append("#define TAG_TABLE_SEED     0x%08XUL" % seed)
+    out.append("#define TAG_TABLE_SIZE     %d" % len(slots))
+    out.append("#define TAG_TABLE_BUCKETS  %d" % len(displace))
+    out.append("#define TAG_TABLE_KEYS     %d" % len(tags))
+    out.append("")
+    out.append("static constexpr uint16_t tagDisplace[TAG_TABLE_BUCKETS] = {")
+    for i in range(0, len(displace), 12):
+        out.append("    " + " ".join("%5d," % d for d in displace[i:i + 12]))
+    out.append("};")
+    out.append("")
+    out.append("static constexpr TagEntry tagTable[TAG_TABLE_SIZE] = {")
+    for i in slots:
+        if i is None:
+            out.append("    { 0x00000000UL, 0x00000000UL, TAG_NONE, 0 },              // empty table")
+            continue
+        uid, action, arg, note = tags[i]
+        hi, lo = uid_key(uid)
+        line = "    { 0x%08XUL, 0x%08XUL, TAG_%s, %d }," % (hi, lo, action, arg)
+        out.append(line + "  // " + (uid.hex().upper() + " " + note).strip())
+    out.append("};")
+    out.append("")
+    out.append("// every key lands on its own slot, expanded in src/tags.cpp once tagFind() exists")
+    out.append("#define TAG_TABLE_CHECKS \\")
+    for slot, i in enumerate(slots):
+        if i is not None:
+            hi, lo = uid_key(tags[i][0])
+            out.append("    static_assert(tagFind(0x%08XUL, 0x%08XUL) == %d, \"tag table\"); \\"
+                       % (hi, lo, slot))
+    out.append("    static_assert(TAG_TABLE_SIZE > 0, \"tag table\");")
+    out.append("")
+    return "\n".join(out)
+
+
+def generate(csv_path, header_path, out_path):
+    """Write out_path from csv_path, only touches the file if it changed"""
+    tags = read_csv(csv_path, read_actions(header_path))
+    keys = [uid_key(t[0]) for t in tags]
+    seed, displace, slots = build(keys)
+    verify(tags, seed, displace, slots)
+    text = render(tags, seed, displace, slots, os.path.basename(csv_path))
+    if os.path.exists(out_path):
+        with open(out_path) as f:
+            if f.read() == text:
+                return False
+    with open(out_path, "w") as f:
+        f.write(text)
+    return True
+
+
+# ============================================================================
+# Main
+# ============================================================================
+if __name__ == "__main__":
+    if len(sys.argv) != 4:
+        print("usage: gen_tags.py TAGS_CSV TAGS_H OUT_H")
+        sys.exit(1)
+    try:
+        changed = generate(sys.argv[1], sys.argv[2], sys.argv[3])
+    except TagError as e:
+        print("gen_tags.py: %s" % e)
+        sys.exit(1)
+    print("gen_tags.py: %s %s" % (sys.argv[3], "written" if changed else "up to date"))
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# hunt_tag.py
+#
+# Make the signed url of a scavenger hunt checkpoint tag (see include/hunt.h)
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import hashlib
+import hmac
+import os
+import sys
+
+from uidkey import parse_uid
+
+# ============================================================================
+# DEFINES
+# ============================================================================
+DOMAIN = b"BSH1"
+MAC_BYTES = 16
+CHECKPOINTS = 64
+KEY_BYTES = 32
+DEFAULT_BASE = "https://burbsec.com"
+
+
+# ============================================================================
+# FUNCTIONS
+# ============================================================================
+
+def sign(key, checkpoint, uid):
+    """Truncated HMAC-SHA256 over "BSH1" | checkpoint | uidLength | uid"""
+    msg = DOMAIN + bytes([checkpoint, len(uid)]) + uid
+    return hmac.new(key, msg, hashlib.sha256).digest()[:MAC_BYTES]
+
+
+def url(key, checkpoint, uid, base=DEFAULT_BASE):
+    return "%s/hunt/%02X/%s" % (base, checkpoint, sign(key, checkpoint, uid).hex().upper())
+
+
+# ============================================================================
+# Main
+# ============================================================================
+if __name__ == "__main__":
+    if len(sys.argv) == 2 and sys.argv[1] == "newkey":
+        print(os.urandom(KEY_BYTES).hex())
+        sys.exit(0)
+    if len(sys.argv) not in (4, 5):
+        print("usage: hunt_tag.py KEY_HEX CHECKPOINT TAG_UID_HEX [BASE_URL]")
+        print("       hunt_tag.py newkey")
+        sys.exit(1)
+    key = bytes.fromhex(sys.argv[1])
+    checkpoint = int(sys.argv[2], 0)
+    if len(key) != KEY_BYTES or not 0 <= checkpoint < CHECKPOINTS:
+        print("hunt_tag.py: key must be %d bytes, checkpoint 0..%d" % (KEY_BYTES, CHECKPOINTS - 1))
+        sys.exit(1)
+    uid = parse_uid(sys.argv[3])
+    print(url(key, checkpoint, uid, *sys.argv[4:]))
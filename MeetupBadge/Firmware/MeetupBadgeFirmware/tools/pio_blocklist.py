@@ -0,0 +1,40 @@
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# pio_blocklist.py
+#
+# PlatformIO pre script, regenerates include/blocklist_table.h from
+# blocklist.txt at the custom_blocklist_fp_rate of platformio.ini
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import os
+import sys
+
+Import("env")  # noqa: F821, provided by PlatformIO
+
+project = env.subst("$PROJECT_DIR")  # noqa: F821
+sys.path.insert(0, os.path.join(project, "tools"))
+
+import gen_blocklist  # noqa: E402
+
+try:
+    fp_rate = float(env.GetProjectOption("custom_blocklist_fp_rate", str(gen_blocklist.DEFAULT_FP_RATE)))  # noqa: F821
+    changed, keys, size, measured = gen_blocklist.generate(os.path.join(project, "blocklist.txt"),
+                                                           os.path.join(project, "include", "blocklist_table.h"),
+                                                           fp_rate)
+    if changed:
+        print("gen_blocklist: include/blocklist_table.h updated, %d uids in %d bytes, "
+              "false positive rate %.6f" % (keys, size, measured))
+except (gen_blocklist.BlocklistError, ValueError) as e:
+    sys.stderr.write("gen_blocklist: %s\n" % e)
+    env.Exit(1)  # noqa: F821
@@ -0,0 +1,36 @@
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# pio_tags.py
+#
+# PlatformIO pre script, regenerates include/tags_table.h from tags.csv
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import os
+import sys
+
+Import("env")  # noqa: F821, provided by PlatformIO
+
+project = env.subst("$PROJECT_DIR")  # noqa: F821
+sys.path.insert(0, os.path.join(project, "tools"))
+
+import gen_tags  # noqa: E402
+
+try:
+    if gen_tags.generate(os.path.join(project, "tags.csv"),
+                         os.path.join(project, "include", "tags.h"),
+                         os.path.join(project, "include", "tags_table.h")):
+        print("gen_tags: include/tags_table.h updated")
+except gen_tags.TagError as e:
+    sys.stderr.write("gen_tags: %s\n" % e)
+    env.Exit(1)  # noqa: F821
@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# test_badge_console.py
+#
+# Tests of the console client framing and a round trip over a pty with a
+# fake badge on the other end, run with `python3 -m unittest discover -s tools`
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import binascii
+import os
+import random
+import struct
+import threading
+import tty
+import unittest
+
+try:
+    import serial  # noqa: F401, pyserial
+    HAVE_SERIAL = True
+except ImportError:
+    HAVE_SERIAL = False
+
+if HAVE_SERIAL:
+    import badge_console as bc
+else:
+    # the framing helpers don't need pyserial
+    import sys
+    import types
+    sys.modules["serial"] = types.ModuleType("serial")
+    import badge_console as bc
+    del sys.modules["serial"]
+
+# ============================================================================
+# DEFINES
+# ============================================================================
+
+# (data, encoding), test/test_console checks Console::cobsEncode() against
+# the same values
+COBS_VECTORS = [
+    (b"", b"\x01"),
+    (b"\x00", b"\x01\x01"),
+    (b"\x00\x00", b"\x01\x01\x01"),
+    (b"\x00\x11\x00", b"\x01\x02\x11\x01"),
+    (b"\x11\x22\x00\x33", b"\x03\x11\x22\x02\x33"),
+    (b"\x11\x22\x33\x44", b"\x05\x11\x22\x33\x44"),
+    (b"\x11\x00\x00\x00", b"\x02\x11\x01\x01\x01"),
+]
+
+# a run of 254 non zero bytes, the encoder closes the full block with an
+# extra 0x01 code, the decoder takes both forms
+RUN = bytes(range(1, 255))
+COBS_RUN = b"\xff" + RUN + b"\x01"
+COBS_RUN_SHORT = b"\xff" + RUN
+
+
+# ============================================================================
+# FUNCTIONS
+# ============================================================================
+
+def split_frames(data):
+    """Independent of badge_console: frames between 0x00 delimiters, decoded"""
+    frames = []
+    for raw in data.split(b"\x00"):
+        out = bytearray()
+        i = 0
+        try:
+            while i < len(raw):
+                code = raw[i]
+                block = raw[i + 1:i + code]
+                if code == 0 or len(block) != code - 1:
+                    raise ValueError
+                out += block
+                i += code
+                if code < 0xFF and i < len(raw):
+                    out.append(0)
+        except ValueError:
+            continue
+        if raw:
+            frames.append(bytes(out))
+    return frames
+
+
+def ccitt(data):
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+class FakeBadge(threading.Thread):
+    """The badge end of the pty, answers like Console::handleFrame():
+    ping echoes, info returns 14 bytes, unknown commands get status 0x01,
+    frames with a bad CRC are dropped. Debug text and corrupted responses
+    can be mixed in to check the client skips them."""
+
+    def __init__(self, fd):
+        super().__init__(daemon=True)
+        self.fd = fd
+        self.noise = b""
+        self.corrupt_next = False
+        self.requests = []
+        self.running = True
+
+    def respond(self, seq, cmd, status, payload=b""):
+        body = bytes([seq, cmd | bc.RESPONSE, status]) + payload
+        frame = body + struct.pack("<H", ccitt(body))
+        if self.corrupt_next:
+            frame = frame[:-1] + bytes([frame[-1] ^ 0x55])
+            self.corrupt_next = False
+        os.write(self.fd, self.noise + b"\x00" + bc.cobs_encode(frame) + b"\x00")
+
+    def handle(self, frame):
+        if len(frame) < 4 or ccitt(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+            return
+        seq, cmd, payload = frame[0], frame[1], frame[2:-2]
+        self.requests.append((seq, cmd, payload))
+        if cmd == bc.CMD_PING:
+            self.respond(seq, cmd, 0, payload)
+        elif cmd == bc.CMD_INFO:
+            self.respond(seq, cmd, 0, struct.pack("<IIIH", 1234, 56789, 115200, 240))
+        else:
+            self.respond(seq, cmd, 0x01)
+
+    def run(self):
+        rx = b""
+        while self.running:
+            try:
+                rx += os.read(self.fd, 4096)
+            except OSError:
+                return
+            head, _, rx = rx.rpartition(b"\x00")
+            for frame in split_frames(head):
+                self.handle(frame)
+
+
+# ============================================================================
+# Tests
+# ============================================================================
+
+class FramingTest(unittest.TestCase):
+
+    def test_crc16(self):
+        self.assertEqual(bc.crc16(b"123456789"), 0x29B1)
+        self.assertEqual(bc.crc16(b""), 0xFFFF)
+        rng = random.Random(1)
+        for n in (1, 2, 31, 255, 1000):
+            data = bytes(rng.getrandbits(8) for _ in range(n))
+            self.assertEqual(bc.crc16(data), ccitt(data))
+            self.assertEqual(bc.crc16(data[n // 2:], bc.crc16(data[:n // 2])), ccitt(data))
+
+    def test_cobs_vectors(self):
+        for data, encoded in COBS_VECTORS:
+            self.assertEqual(bc.cobs_encode(data), encoded)
+            self.assertEqual(bc.cobs_decode(encoded), data)
+        self.assertEqual(bc.cobs_encode(RUN), COBS_RUN)
+        self.assertEqual(bc.cobs_decode(COBS_RUN), RUN)
+        self.assertEqual(bc.cobs_decode(COBS_RUN_SHORT), RUN)
+
+    def test_cobs_round_trip(self):
+        rng = random.Random(2)
+        for n in list(range(0, 600, 7)) + [253, 254, 255, 508, 509]:
+            for zeros in (0, 0.1, 0.9):
+                data = bytes(0 if rng.random() < zeros else rng.randint(1, 255) for _ in range(n))
+                encoded = bc.cobs_encode(data)
+                self.assertNotIn(0, encoded)
+                self.assertLessEqual(len(encoded), n + n // 254 + 1 + 1)
+                self.assertEqual(bc.cobs_decode(encoded), data)
+                self.assertEqual(split_frames(encoded), [data] if encoded else [])
+
+    def test_cobs_malformed(self):
+        for raw in (b"\x00", b"\x05\x11\x22", b"\x02\x11\x00"):
+            with self.assertRaises(ValueError):
+                bc.cobs_decode(raw)
+
+
+@unittest.skipUnless(HAVE_SERIAL, "pyserial is not installed")
+class PtyRoundTripTest(unittest.TestCase):
+
+    def setUp(self):
+        self.master, slave = os.openpty()
+        tty.setraw(self.master)
+        tty.setraw(slave)
+        self.badge = FakeBadge(self.master)
+        self.badge.start()
+        self.console = bc.BadgeConsole(os.ttyname(slave), timeout=2.0)
+        os.close(slave)
+
+    def tearDown(self):
+        self.badge.running = False
+        self.console.close()
+        os.close(self.master)
+        self.badge.join(1.0)
+
+    def test_ping(self):
+        for payload in (b"", b"\x00", b"hello", bytes(range(240)), b"\x00" * 240):
+            self.assertEqual(self.console.ping(payload), payload)
+
+    def test_pipeline(self):
+        payloads = [bytes([i]) * i for i in range(40)]
+        answers = self.console.pipeline([(bc.CMD_PING, p) for p in payloads])
+        self.assertEqual(answers, payloads)
+        seqs = [seq for seq, _, _ in self.badge.requests]
+        self.assertEqual(len(set(seqs)), len(seqs))
+
+    def test_info(self):
+        self.assertEqual(self.console.info(),
+                         {"uptime_ms": 1234, "free_heap": 56789, "baud": 115200, "max_payload": 240})
+
+    def test_unknown_command(self):
+        with self.assertRaisesRegex(bc.ConsoleError, "unknown command"):
+            self.console.request(0x1F)
+        self.assertEqual(self.console.ping(b"after"), b"after")
+
+    def test_debug_text_is_skipped(self):
+        self.badge.noise = b"setup(): debug line\r\nloop(): BTN1 pressed\r\n"
+        self.assertEqual(self.console.ping(b"\x00through\x00"), b"\x00through\x00")
+        self.assertEqual(self.console.info()["baud"], 115200)
+
+    def test_bad_crc_times_out(self):
+        self.console.timeout = 0.3
+        self.badge.corrupt_next = True
+        with self.assertRaisesRegex(bc.ConsoleError, "timeout"):
+            self.console.ping(b"lost")
+        self.assertEqual(self.console.ping(b"next"), b"next")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# test_gen_blocklist.py
+#
+# Tests of the blocklist Bloom filter generator, run with
+# `python3 -m unittest discover -s tools`
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import math
+import os
+import random
+import shutil
+import tempfile
+import unittest
+
+import gen_blocklist
+from uidkey import UID_LENGTHS, uid_key
+
+# ============================================================================
+# DEFINES
+# ============================================================================
+PROJECT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+NEGATIVES = 100000          # fresh uids per rate, not the generator's own
+
+
+def random_uids(n, seed):
+    rng = random.Random(seed)
+    uids = set()
+    while len(uids) < n:
+        uids.add(bytes(rng.getrandbits(8) for _ in range(rng.choice(UID_LENGTHS))))
+    return sorted(uids)
+
+
+# ============================================================================
+# Tests
+# ============================================================================
+
+class DimensionTest(unittest.TestCase):
+
+    def test_sizes(self):
+        for n, rate in ((1, 0.01), (100, 0.001), (1000, 0.01), (10000, 0.0001)):
+            bits, hashes = gen_blocklist.dimension(n, rate)
+            self.assertEqual(bits % 32, 0)
+            self.assertGreaterEqual(bits, -n * math.log(rate) / math.log(2) ** 2)
+            self.assertLess(bits, -n * math.log(rate) / math.log(2) ** 2 + 32)
+            self.assertEqual(hashes, min(max(round(bits / n * math.log(2)), 1), gen_blocklist.MAX_HASHES))
+
+    def test_empty_and_bad_rates(self):
+        self.assertEqual(gen_blocklist.dimension(0, 0.001), (32, 1))
+        for rate in (0, 1, -0.1, 2):
+            with self.assertRaises(gen_blocklist.BlocklistError):
+                gen_blocklist.dimension(10, rate)
+
+
+class FilterTest(unittest.TestCase):
+
+    def test_probes_in_range(self):
+        for bits in (32, 96, 4000032):
+            for uid in random_uids(200, bits):
+                for bit in gen_blocklist.probes(uid_key(uid), bits, 7):
+                    self.assertTrue(0 <= bit < bits)
+
+    def test_false_positive_rate(self):
+        """Listed uids are always blocked, others at about the target rate.
+        The bound is the target plus five standard deviations of the count."""
+        for n, rate in ((1000, 0.01), (1000, 0.001), (10000, 0.001)):
+            with self.subTest(uids=n, rate=rate):
+                uids = random_uids(n, n)
+                bits, hashes = gen_blocklist.dimension(n, rate)
+                words = gen_blocklist.build(uids, bits, hashes)
+                for uid in uids:
+                    self.assertTrue(gen_blocklist.contains(words, bits, hashes, uid))
+                listed = set(uids)
+                negatives = [u for u in random_uids(NEGATIVES, n + 1) if u not in listed]
+                hits = sum(gen_blocklist.contains(words, bits, hashes, u) for u in negatives)
+                bound = rate * len(negatives) + 5 * math.sqrt(rate * len(negatives))
+                self.assertLessEqual(hits, bound)
+                self.assertGreater(hits, 0 if rate * len(negatives) < 20 else rate * len(negatives) / 3)
+
+    def test_empty_filter_blocks_nothing(self):
+        words = gen_blocklist.build([], 32, 1)
+        self.assertEqual(words, [0])
+        for uid in random_uids(100, 1):
+            self.assertFalse(gen_blocklist.contains(words, 32, 1, uid))
+
+
+class ListTest(unittest.TestCase):
+
+    def setUp(self):
+        self.dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.dir)
+
+    def write(self, text):
+        path = os.path.join(self.dir, "blocklist.txt")
+        with open(path, "w") as f:
+            f.write(text)
+        return path
+
+    def test_read_list(self):
+        path = self.write("# header\n\ndeadbeef  # cloned\n04A1B2C3D4E5F6\nDEADBEEF\n")
+        self.assertEqual(gen_blocklist.read_list(path),
+                         [bytes.fromhex("04A1B2C3D4E5F6"), bytes.fromhex("DEADBEEF")])
+
+    def test_bad_line(self):
+        with self.assertRaises(gen_blocklist.BlocklistError):
+            gen_blocklist.read_list(self.write("DEADBEEF\nDEADBE\n"))
+
+    def test_generate_only_writes_changes(self):
+        path = self.write("".join(u.hex() + "\n" for u in random_uids(300, 3)))
+        out = os.path.join(self.dir, "blocklist_table.h")
+        changed, keys, size, measured = gen_blocklist.generate(path, out, 0.01)
+        self.assertTrue(changed)
+        self.assertEqual(keys, 300)
+        self.assertEqual(size * 8, gen_blocklist.dimension(300, 0.01)[0])
+        self.assertLess(measured, 0.02)
+        self.assertFalse(gen_blocklist.generate(path, out, 0.01)[0])
+        self.assertTrue(gen_blocklist.generate(path, out, 0.001)[0])
+
+    def test_committed_table_is_current(self):
+        out = os.path.join(self.dir, "blocklist_table.h")
+        gen_blocklist.generate(os.path.join(PROJECT, "blocklist.txt"), out)
+        with open(out) as f, open(os.path.join(PROJECT, "include", "blocklist_table.h")) as g:
+            self.assertEqual(f.read(), g.read())
+
+
+if __name__ == "__main__":
+    unittest.main()
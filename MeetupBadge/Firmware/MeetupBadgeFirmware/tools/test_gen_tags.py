@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# test_gen_tags.py
+#
+# Tests of the event tag table generator and the uid hash it shares with the
+# firmware, run with `python3 -m unittest discover -s tools`
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+import os
+import random
+import shutil
+import tempfile
+import unittest
+
+import gen_tags
+from uidkey import parse_uid, uid_hash, uid_key
+
+# ============================================================================
+# DEFINES
+# ============================================================================
+PROJECT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+TAGS_H = os.path.join(PROJECT, "include", "tags.h")
+
+# (uid, seed, key, hash), test/test_tags checks the same values against
+# uidKey() and uidHash()
+VECTORS = [
+    ("DEADBEEF",       0x00000000, (0x04DEADBE, 0xEF000000), 0x1F8234F0),
+    ("04A1B2C3D4E5F6", 0x00005EED, (0x0704A1B2, 0xC3D4E5F6), 0x25623C64),
+    ("DEADBEEF000000", 0xDAEB8EBD, (0x07DEADBE, 0xEF000000), 0x3B5507B5),
+    ("00000000",       0xFFFFFFFF, (0x04000000, 0x00000000), 0x37653EDE),
+]
+
+
+def random_keys(n, seed):
+    rng = random.Random(seed)
+    keys = set()
+    while len(keys) < n:
+        length = rng.choice((4, 7))
+        keys.add(uid_key(bytes(rng.getrandbits(8) for _ in range(length))))
+    return sorted(keys)
+
+
+# ============================================================================
+# Tests
+# ============================================================================
+
+class UidHashTest(unittest.TestCase):
+
+    def test_vectors(self):
+        for uid, seed, key, h in VECTORS:
+            self.assertEqual(uid_key(parse_uid(uid)), key)
+            self.assertEqual(uid_hash(key, seed), h)
+
+    def test_length_is_part_of_the_key(self):
+        self.assertNotEqual(uid_key(parse_uid("DEADBEEF")), uid_key(parse_uid("DEADBEEF000000")))
+
+    def test_parse_uid(self):
+        for text in ("DEAD", "DEADBEEF00", "DEADBEEF00000000", "XYZ"):
+            with self.assertRaises(ValueError):
+                parse_uid(text)
+
+
+class BuildTest(unittest.TestCase):
+
+    def check(self, keys):
+        seed, displace, slots = gen_tags.build(keys)
+        self.assertEqual(len(slots), max(len(keys), 1))
+        self.assertEqual(sorted(i for i in slots if i is not None), list(range(len(keys))))
+        table = [keys[i] if i is not None else None for i in slots]
+        for i, key in enumerate(keys):
+            self.assertEqual(slots[gen_tags.lookup(key, seed, displace, table)], i)
+        known = set(keys)
+        for key in random_keys(2000, len(keys) + 1):
+            if key not in known:
+                self.assertIsNone(gen_tags.lookup(key, seed, displace, table))
+
+    def test_sizes(self):
+        for n in (0, 1, 2, 3, 5, 50, 500, 2000):
+            with self.subTest(keys=n):
+                self.check(random_keys(n, n))
+
+    def test_same_input_same_table(self):
+        keys = random_keys(100, 7)
+        self.assertEqual(gen_tags.build(keys), gen_tags.build(keys))
+
+
+class CsvTest(unittest.TestCase):
+
+    def setUp(self):
+        self.dir = tempfile.mkdtemp()
+        self.actions = gen_tags.read_actions(TAGS_H)
+
+    def tearDown(self):
+        shutil.rmtree(self.dir)
+
+    def write(self, text):
+        path = os.path.join(self.dir, "tags.csv")
+        with open(path, "w") as f:
+            f.write(text)
+        return path
+
+    def test_actions_from_the_enum(self):
+        self.assertEqual(self.actions, {"SPONSOR", "ROOM", "ORGANISER"})
+
+    def test_rows(self):
+        path = self.write("# comment\nuid,action,arg,note\n\nDEADBEEF,organiser\n04A1B2C3D4E5F6, Room ,0x10,door\n")
+        self.assertEqual(gen_tags.read_csv(path, self.actions), [
+            (parse_uid("DEADBEEF"), "ORGANISER", 0, ""),
+            (parse_uid("04A1B2C3D4E5F6"), "ROOM", 16, "door"),
+        ])
+
+    def test_bad_rows(self):
+        for text in ("DEADBEEF\n",
+                     "DEADBE,room\n",
+                     "DEADBEEF,room\ndeadbeef,sponsor\n",
+                     "DEADBEEF,lounge\n",
+                     "DEADBEEF,room,256\n"):
+            with self.subTest(csv=text):
+                with self.assertRaises(gen_tags.TagError):
+                    gen_tags.read_csv(self.write(text), self.actions)
+
+    def test_generate_only_writes_changes(self):
+        out = os.path.join(self.dir, "tags_table.h")
+        path = self.write("DEADBEEF,organiser\n04A1B2C3D4E5F6,sponsor,1\n")
+        self.assertTrue(gen_tags.generate(path, TAGS_H, out))
+        self.assertFalse(gen_tags.generate(path, TAGS_H, out))
+        with open(out) as f:
+            text = f.read()
+        self.assertIn("#define TAG_TABLE_KEYS     2", text)
+        self.assertEqual(text.count("static_assert(tagFind("), 2)
+
+    def test_committed_table_is_current(self):
+        out = os.path.join(self.dir, "tags_table.h")
+        gen_tags.generate(os.path.join(PROJECT, "tags.csv"), TAGS_H, out)
+        with open(out) as f, open(os.path.join(PROJECT, "include", "tags_table.h")) as g:
+            self.assertEqual(f.read(), g.read())
+
+
+if __name__ == "__main__":
+    unittest.main()
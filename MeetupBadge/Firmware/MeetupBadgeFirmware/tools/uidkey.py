@@ -0,0 +1,58 @@
+# ============================================================================
+#
+# BurbSec MeetupBadge Firmware
+#
+# uidkey.py
+#
+# UID packing and hashing shared by the table generators, see include/uidkey.h
+#
+# Darren Young [youngd24@gmail.com]
+#
+# ============================================================================
+# LICENSE
+# ============================================================================
+#
+# BSD 3-Clause License, see the LICENSE file in the repository root.
+#
+# ============================================================================
+
+# ============================================================================
+# DEFINES
+# ============================================================================
+MASK32 = 0xFFFFFFFF
+UID_LENGTHS = (4, 7)
+
+
+# ============================================================================
+# FUNCTIONS
+# ============================================================================
+
+def uid_key(uid):
+    """(hi, lo) words of a uid, same as uidKey()"""
+    b = bytes(uid) + bytes(7 - len(uid))
+    hi = (len(uid) << 24) | (b[0] << 16) | (b[1] << 8) | b[2]
+    lo = (b[3] << 24) | (b[4] << 16) | (b[5] << 8) | b[6]
+    return hi, lo
+
+
+def fmix(h):
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & MASK32
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & MASK32
+    h ^= h >> 16
+    return h
+
+
+def uid_hash(key, seed):
+    """Same as uidHash()"""
+    hi, lo = key
+    return fmix(fmix(lo ^ seed) ^ hi)
+
+
+def parse_uid(text):
+    """bytes of a hex uid, ValueError if it's not 4 or 7 bytes of hex"""
+    uid = bytes.fromhex(text)
+    if len(uid) not in UID_LENGTHS:
+        raise ValueError("uid must be 4 or 7 bytes")
+    return uid